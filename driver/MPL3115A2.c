@@ -6,12 +6,24 @@
 #include <stdio.h>
 
 #include "em_i2c.h"
+#include "em_gpio.h"
+#include "gpiointerrupt.h"
 
 #include "thunderboard/util.h"
 #include "thunderboard/board_4166.h"
 
 #include "MPL3115A2.h"
 
+// Callback of the event API and the flag set by the INT1 GPIO interrupt
+static MPL3115A2_EventCallback eventCallback = NULL;
+static volatile bool eventPending = false;
+static MPL3115A2_EventWakeup eventWakeup = NULL;
+
+// Shadow of the BAR_IN register (2 Pa/LSB). The sensor is not reset with the MCU (EM4 wakeup,
+// pin or watchdog reset), so the register is unknown until the first write or read.
+static uint16_t barInShadow = 0;
+static bool barInShadowValid = false;
+
 void MPL3115A2_readRegister(uint8_t registerAddress, uint8_t* read_to, uint8_t read_length)
 {
   // Transfer structure
@@ -420,3 +432,268 @@ void MPL3115A2_measureOneShotInAltimeterMode(void)
 		//printf("Temperature: %d.%d%d C\r\n", (int) (temp), (int) (temp * 10.0f) % 10, (int) (temp * 100.0f) % 10);
 		//printf("Altitude: %d.%d%d p\r\n", (int) (alt), (int) (alt * 10.0f) % 10, (int) (alt * 100.0f) % 10);
 }
+
+// Put the sensor to Standby, the control registers can only be modified in Standby mode.
+// Returns the original value of CTRL_REG1 to be restored with MPL3115A2_restoreMode.
+static uint8_t MPL3115A2_enterStandby(void)
+{
+	uint8_t ctrlReg1 = 0;
+	uint8_t standby = 0;
+
+	MPL3115A2_readRegister(MPL3115A2_CTRL_REG1, &ctrlReg1, 1);
+	if(ctrlReg1 & MPL3115A2_CTRL_REG1_SBYB) {
+		standby = ctrlReg1 & ~MPL3115A2_CTRL_REG1_SBYB;
+		MPL3115A2_writeRegister(MPL3115A2_CTRL_REG1, &standby, 1);
+	}
+	return ctrlReg1;
+}
+
+static void MPL3115A2_restoreMode(uint8_t ctrlReg1)
+{
+	if(ctrlReg1 & MPL3115A2_CTRL_REG1_SBYB) {
+		MPL3115A2_writeRegister(MPL3115A2_CTRL_REG1, &ctrlReg1, 1);
+	}
+}
+
+// Set the pressure/altitude target: 2 Pa/LSB in Barometer mode, 1 m/LSB (signed) in Altimeter mode
+void MPL3115A2_setPressureTarget(uint16_t target)
+{
+	uint8_t registerValues[2];
+
+	registerValues[0] = (uint8_t)(target >> 8);
+	registerValues[1] = (uint8_t)(target);
+	MPL3115A2_writeRegister(MPL3115A2_P_TGT_MSB, registerValues, 2);
+}
+
+// Set the pressure/altitude window around the target, same units as the target
+void MPL3115A2_setPressureWindow(uint16_t window)
+{
+	uint8_t registerValues[2];
+
+	registerValues[0] = (uint8_t)(window >> 8);
+	registerValues[1] = (uint8_t)(window);
+	MPL3115A2_writeRegister(MPL3115A2_P_WND_MSB, registerValues, 2);
+}
+
+// Set the temperature target in Celsius degree
+void MPL3115A2_setTemperatureTarget(int8_t target)
+{
+	uint8_t registerValue = (uint8_t)target;
+	MPL3115A2_writeRegister(MPL3115A2_T_TGT, &registerValue, 1);
+}
+
+// Set the temperature window around the target in Celsius degree
+void MPL3115A2_setTemperatureWindow(uint8_t window)
+{
+	MPL3115A2_writeRegister(MPL3115A2_T_WND, &window, 1);
+}
+
+// Enable the interrupts given by the MPL3115A2_INT_* mask and route all of them
+// to the INT1 pin as active low, push-pull output.
+void MPL3115A2_configureInterrupts(uint8_t enableMask)
+{
+	uint8_t ctrlReg1 = 0;
+	uint8_t ctrlRegs[3];
+
+	ctrlRegs[0] = 0x00;       // CTRL_REG3: INT1 and INT2 active low, push-pull
+	ctrlRegs[1] = enableMask; // CTRL_REG4: interrupt enable
+	ctrlRegs[2] = enableMask; // CTRL_REG5: enabled sources to INT1
+
+	ctrlReg1 = MPL3115A2_enterStandby();
+	// CTRL_REG3..CTRL_REG5 are consecutive, one burst write
+	MPL3115A2_writeRegister(MPL3115A2_CTRL_REG3, ctrlRegs, 3);
+	MPL3115A2_restoreMode(ctrlReg1);
+}
+
+uint8_t MPL3115A2_readInterruptSource(void)
+{
+	uint8_t intSource = 0;
+	MPL3115A2_readRegister(MPL3115A2_INT_SOURCE, &intSource, 1);
+	return intSource;
+}
+
+// Set the sampling period of the Active mode to 2^timeStep seconds (0..15)
+void MPL3115A2_setAutoAcquisitionStep(uint8_t timeStep)
+{
+	uint8_t ctrlReg1 = 0;
+	uint8_t ctrlReg2 = 0;
+
+	ctrlReg1 = MPL3115A2_enterStandby();
+	MPL3115A2_readRegister(MPL3115A2_CTRL_REG2, &ctrlReg2, 1);
+	ctrlReg2 = (ctrlReg2 & ~MPL3115A2_CTRL_REG2_ST_MASK) | (timeStep & MPL3115A2_CTRL_REG2_ST_MASK);
+	MPL3115A2_writeRegister(MPL3115A2_CTRL_REG2, &ctrlReg2, 1);
+	MPL3115A2_restoreMode(ctrlReg1);
+}
+
+// Read the change between the last two samples.
+// Pressure delta: signed Q18.2 Pascal in Barometer mode, Q16.4 meter in Altimeter mode.
+// Temperature delta: signed Q8.4 Celsius degree.
+void MPL3115A2_readDelta(int32_t* deltaPressure, int16_t* deltaTemperature)
+{
+	uint8_t deltas[5] = {0};
+	int32_t pressure = 0;
+	int16_t temperature = 0;
+
+	/* OUT_P_DELTA and OUT_T_DELTA in one burst */
+	MPL3115A2_readRegister(MPL3115A2_OUT_P_DELTA_MSB, deltas, 5);
+
+	// 20 bit two's complement in the upper bits, arithmetic shift keeps the sign
+	pressure = (int32_t)(((uint32_t)deltas[0] << 24) | ((uint32_t)deltas[1] << 16) | ((uint32_t)deltas[2] << 8));
+	*deltaPressure = pressure >> 12;
+
+	temperature = (int16_t)(((uint16_t)deltas[3] << 8) | deltas[4]);
+	*deltaTemperature = temperature >> 4;
+}
+
+// Set the sea level pressure in Pascal used by the Altimeter mode (BAR_IN register), rounded
+// to the 2 Pa step. It is a single 2 byte burst write without Standby, skipped if the
+// register is known to hold the value already.
+void MPL3115A2_setSeaLevelPressure(uint32_t pressure)
+{
+	uint8_t registerValues[2];
+	uint16_t barIn = 0;
+
+	barIn = (pressure > 0x1FFFE) ? 0xFFFF : (uint16_t)((pressure + 1) >> 1);
+	if(barInShadowValid && (barIn == barInShadow)) {
+		return;
+	}
+
+	registerValues[0] = (uint8_t)(barIn >> 8);
+	registerValues[1] = (uint8_t)(barIn);
+	MPL3115A2_writeRegister(MPL3115A2_BAR_IN_MSB, registerValues, 2);
+	barInShadow = barIn;
+	barInShadowValid = true;
+}
+
+// Sea level pressure in Pascal from the shadow of BAR_IN, the register is read
+// only once after a reset of the MCU
+uint32_t MPL3115A2_getSeaLevelPressure(void)
+{
+	uint8_t registerValues[2] = {0};
+
+	if(!barInShadowValid) {
+		MPL3115A2_readRegister(MPL3115A2_BAR_IN_MSB, registerValues, 2);
+		barInShadow = ((uint16_t)registerValues[0] << 8) | registerValues[1];
+		barInShadowValid = true;
+	}
+	return (uint32_t)barInShadow << 1;
+}
+
+// Set the oversample ratio to 2^oversampleShift (0..7), the mode (Active/Standby) is kept.
+// Conversion time: 6 ms at OSR = 1 ... 512 ms at OSR = 128.
+void MPL3115A2_setOversampleRatio(uint8_t oversampleShift)
+{
+	uint8_t ctrlReg1 = 0;
+	uint8_t newCtrlReg1 = 0;
+
+	ctrlReg1 = MPL3115A2_enterStandby();
+	newCtrlReg1 = (ctrlReg1 & ~MPL3115A2_CTRL_REG1_OS_MASK) | ((oversampleShift << MPL3115A2_CTRL_REG1_OS_SHIFT) & MPL3115A2_CTRL_REG1_OS_MASK);
+	// Standby copy first, then the original mode with the new ratio
+	ctrlReg1 = newCtrlReg1 & ~MPL3115A2_CTRL_REG1_SBYB;
+	MPL3115A2_writeRegister(MPL3115A2_CTRL_REG1, &ctrlReg1, 1);
+	MPL3115A2_restoreMode(newCtrlReg1);
+}
+
+// Single conversion in Barometer mode with the configured oversample ratio, the sensor
+// is left in Standby. Faster than the 1 s period of the Active mode at low OSR.
+void MPL3115A2_measureOneShot(uint32_t* resultPressure, int16_t* resultTemperature)
+{
+	uint8_t timeout;
+	uint8_t ctrlReg1 = 0;
+	uint8_t measurements[5] = {0};
+	uint32_t pressure = 0;
+	int16_t temperature = 0;
+
+	MPL3115A2_readRegister(MPL3115A2_CTRL_REG1, &ctrlReg1, 1);
+	ctrlReg1 = (ctrlReg1 & ~MPL3115A2_CTRL_REG1_SBYB) | MPL3115A2_CTRL_REG1_OST;
+	MPL3115A2_writeRegister(MPL3115A2_CTRL_REG1, &ctrlReg1, 1);
+
+	/* Conversion time is about 4 ms * OSR + 2 ms, then OST clears */
+	UTIL_delay((4UL << ((ctrlReg1 & MPL3115A2_CTRL_REG1_OS_MASK) >> MPL3115A2_CTRL_REG1_OS_SHIFT)) + 2);
+	timeout = 10;
+	while ( timeout-- ) {
+		MPL3115A2_readRegister(MPL3115A2_CTRL_REG1, &ctrlReg1, 1);
+		if(ctrlReg1 & MPL3115A2_CTRL_REG1_OST) {
+			UTIL_delay(1);
+		}
+		else {
+			break;
+		}
+	}
+
+	MPL3115A2_readRegister(MPL3115A2_OUT_P_MSB, measurements, 5);
+
+	pressure = measurements[0]; // MSB
+	pressure <<= 8;
+	pressure |= measurements[1]; // CSB
+	pressure <<= 8;
+	pressure |= measurements[2]; // LSB
+	pressure >>= 4;
+	*resultPressure = pressure;
+
+	temperature = (int16_t)(((uint16_t)measurements[3] << 8) | measurements[4]);
+	*resultTemperature = temperature >> 4;
+}
+
+// GPIOINT callback of the INT1 line, the I2C transfers are left to the main loop
+static void MPL3115A2_int1Handler(uint8_t pin)
+{
+	(void)pin;
+	eventPending = true;
+	if(eventWakeup != NULL) {
+		eventWakeup();
+	}
+}
+
+// Set up the INT1 line as a falling edge GPIO interrupt, the callback is
+// dispatched from MPL3115A2_eventProcess.
+void MPL3115A2_eventInit(MPL3115A2_EventCallback callback)
+{
+	eventCallback = callback;
+	eventPending = false;
+
+	GPIO_PinModeSet(MPL3115A2_INT1_PORT, MPL3115A2_INT1_PIN, gpioModeInputPull, 1);
+	GPIOINT_Init();
+	GPIOINT_CallbackRegister(MPL3115A2_INT1_EXTI, MPL3115A2_int1Handler);
+	GPIO_ExtIntConfig(MPL3115A2_INT1_PORT, MPL3115A2_INT1_PIN, MPL3115A2_INT1_EXTI, false, true, true);
+
+	// The line may already be asserted by a flag that was set before the init
+	if(GPIO_PinInGet(MPL3115A2_INT1_PORT, MPL3115A2_INT1_PIN) == 0) {
+		eventPending = true;
+	}
+}
+
+// Optional wakeup of the event loop, e.g. an external signal when the
+// Bluetooth stack owns the sleep. NULL to remove it.
+void MPL3115A2_eventSetWakeup(MPL3115A2_EventWakeup wakeup)
+{
+	eventWakeup = wakeup;
+}
+
+bool MPL3115A2_eventPending(void)
+{
+	return eventPending;
+}
+
+// Read and clear the interrupt sources, then call the registered callback
+void MPL3115A2_eventProcess(void)
+{
+	uint8_t intSource = 0;
+	uint8_t statusReg = 0;
+	uint8_t measurements[5] = {0};
+
+	if(!eventPending) {
+		return;
+	}
+	eventPending = false;
+
+	intSource = MPL3115A2_readInterruptSource();
+
+	/* Reading STATUS and OUT_P, OUT_T releases the INT1 line */
+	MPL3115A2_readRegister(MPL3115A2_STATUS, &statusReg, 1);
+	MPL3115A2_readRegister(MPL3115A2_OUT_P_MSB, measurements, 5);
+
+	if((intSource != 0) && (eventCallback != NULL)) {
+		eventCallback(intSource);
+	}
+}
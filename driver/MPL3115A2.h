@@ -8,6 +8,7 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 // I2C address of the sensor on the bus
 #define MPL3115A2_I2C_BUS_ADDRESS     (0x60) // I2C address of the sensor on the bus
@@ -20,6 +21,17 @@
 #define MPL3115A2_PT_DATA_CFG 		  (0x13) // PT Data Configuration Register address
 #define MPL3115A2_CTRL_REG1 		  (0x26) // Control Register 1 address
 #define MPL3115A2_OUT_P_MSB 		  (0x01) // Root pointer to Pressure and Temperature data register address
+#define MPL3115A2_OUT_P_DELTA_MSB     (0x07) // Root pointer to Pressure and Temperature delta register address
+#define MPL3115A2_INT_SOURCE          (0x12) // Interrupt Source Register address
+#define MPL3115A2_BAR_IN_MSB          (0x14) // Barometric input (sea level pressure) MSB register address
+#define MPL3115A2_P_TGT_MSB           (0x16) // Pressure/Altitude target MSB register address
+#define MPL3115A2_T_TGT               (0x18) // Temperature target register address
+#define MPL3115A2_P_WND_MSB           (0x19) // Pressure/Altitude window MSB register address
+#define MPL3115A2_T_WND               (0x1B) // Temperature window register address
+#define MPL3115A2_CTRL_REG2           (0x27) // Control Register 2 address (auto acquisition time step)
+#define MPL3115A2_CTRL_REG3           (0x28) // Control Register 3 address (interrupt pin configuration)
+#define MPL3115A2_CTRL_REG4           (0x29) // Control Register 4 address (interrupt enable)
+#define MPL3115A2_CTRL_REG5           (0x2A) // Control Register 5 address (interrupt routing)
 
 /*
  * Register offsets, default values
@@ -27,6 +39,43 @@
 #define MPL3115A2_WHO_AM_I_VALUE      (0xC4) // Default value of the WHO_AM_I register
 #define MPL3115A2_CTRL_REG1_OST  	  (0x02) // Single measurement bit
 #define MPL3115A2_REGISTER_STATUS_PDR (0x04) // Pressure Data Ready value
+#define MPL3115A2_BAR_IN_DEFAULT      (101326) // Reset value of BAR_IN in Pascal
+#define MPL3115A2_CTRL_REG1_SBYB      (0x01) // Active mode bit
+#define MPL3115A2_CTRL_REG1_OS_MASK   (0x38) // Oversample ratio field: OSR = 2^OS
+#define MPL3115A2_CTRL_REG1_OS_SHIFT  (3)    // Position of the oversample ratio field
+#define MPL3115A2_CTRL_REG2_ST_MASK   (0x0F) // Auto acquisition time step: 2^ST seconds
+#define MPL3115A2_CTRL_REG3_IPOL1     (0x20) // INT1 active high
+#define MPL3115A2_CTRL_REG3_IPOL2     (0x02) // INT2 active high
+
+/*
+ * Interrupt bits: same position in CTRL_REG4 (enable), CTRL_REG5 (route to INT1) and INT_SOURCE (flag)
+ */
+#define MPL3115A2_INT_DRDY            (0x80) // Data ready
+#define MPL3115A2_INT_FIFO            (0x40) // FIFO
+#define MPL3115A2_INT_PW              (0x20) // Pressure/Altitude inside the P_TGT +/- P_WND window
+#define MPL3115A2_INT_TW              (0x10) // Temperature inside the T_TGT +/- T_WND window
+#define MPL3115A2_INT_PTH             (0x08) // Pressure/Altitude threshold crossed
+#define MPL3115A2_INT_TTH             (0x04) // Temperature threshold crossed
+#define MPL3115A2_INT_PCHG            (0x02) // Pressure/Altitude change
+#define MPL3115A2_INT_TCHG            (0x01) // Temperature change
+
+/*
+ * MCU pin the INT1 output of the sensor is wired to
+ */
+#ifndef MPL3115A2_INT1_PORT
+#define MPL3115A2_INT1_PORT           (gpioPortC) // GPIO port of the INT1 line
+#endif
+#ifndef MPL3115A2_INT1_PIN
+#define MPL3115A2_INT1_PIN            (9)         // GPIO pin of the INT1 line
+#endif
+#ifndef MPL3115A2_INT1_EXTI
+#define MPL3115A2_INT1_EXTI           (9)         // External interrupt number of the INT1 line
+#endif
+
+// Called from the main loop with the INT_SOURCE flags of a sensor event
+typedef void (*MPL3115A2_EventCallback)(uint8_t intSource);
+// Called in the INT1 interrupt, wakes a main loop that does not sleep on the pending flag
+typedef void (*MPL3115A2_EventWakeup)(void);
 
 void MPL3115A2_readRegister(uint8_t registerAddress, uint8_t* read_to, uint8_t read_length);
 void MPL3115A2_writeRegister(uint8_t registerAddress, uint8_t* write_array, uint8_t write_length);
@@ -37,5 +86,21 @@ void MPL3115A2_measureAltitudeAndTemperature(int32_t* resultAltitude, int16_t* r
 void MPL3115A2_measurePressureAndTemperature(uint32_t* resultPressure, int16_t* resultTemperature);
 void MPL3115A2_measureOneShotInBarometerMode(void);
 void MPL3115A2_measureOneShotInAltimeterMode(void);
+void MPL3115A2_setPressureTarget(uint16_t target);
+void MPL3115A2_setPressureWindow(uint16_t window);
+void MPL3115A2_setTemperatureTarget(int8_t target);
+void MPL3115A2_setTemperatureWindow(uint8_t window);
+void MPL3115A2_configureInterrupts(uint8_t enableMask);
+uint8_t MPL3115A2_readInterruptSource(void);
+void MPL3115A2_setAutoAcquisitionStep(uint8_t timeStep);
+void MPL3115A2_readDelta(int32_t* deltaPressure, int16_t* deltaTemperature);
+void MPL3115A2_setSeaLevelPressure(uint32_t pressure);
+uint32_t MPL3115A2_getSeaLevelPressure(void);
+void MPL3115A2_setOversampleRatio(uint8_t oversampleShift);
+void MPL3115A2_measureOneShot(uint32_t* resultPressure, int16_t* resultTemperature);
+void MPL3115A2_eventInit(MPL3115A2_EventCallback callback);
+void MPL3115A2_eventSetWakeup(MPL3115A2_EventWakeup wakeup);
+bool MPL3115A2_eventPending(void);
+void MPL3115A2_eventProcess(void);
 
 #endif // MPL3115A2_H
@@ -0,0 +1,121 @@
+/***************************************************************************//**
+ * @file
+ * @brief altitude.c
+ ******************************************************************************/
+
+#include "altitude.h"
+
+/*
+ * Table of 44330.77 * (1 - r ^ 0.190263) in Q16.16 meter for
+ * r = p / p0 = 0.5 ... 1.125 in 1/128 steps (about -560 m ... 5480 m).
+ * The interpolation error stays below 0.2 m in the whole range.
+ * A finer table with the same range can be set with ALTITUDE_setTable().
+ */
+#define ALTITUDE_RATIO_MIN      (1UL << 19) // 0.5 in Q20
+#define ALTITUDE_STEP_SHIFT     (13)        // 1/128 in Q20
+#define ALTITUDE_TABLE_SIZE     (81)
+
+static const int32_t altitudeTable[ALTITUDE_TABLE_SIZE] = {
+	358956856, 351434491, 344005260, 336666625, 329416152, 322251509,
+	315170459, 308170851, 301250623, 294407789, 287640442, 280946745,
+	274324931, 267773297, 261290203, 254874065, 248523358, 242236609,
+	236012396, 229849346, 223746132, 217701471, 211714121, 205782882,
+	199906593, 194084129, 188314400, 182596350, 176928956, 171311226,
+	165742198, 160220938, 154746540, 149318124, 143934836, 138595846,
+	133300347, 128047556, 122836710, 117667068, 112537909, 107448531,
+	102398251, 97386404, 92412342, 87475435, 82575068, 77710643,
+	72881574, 68087293, 63327245, 58600889, 53907695, 49247148,
+	44618746, 40021996, 35456419, 30921546, 26416921, 21942095,
+	17496631, 13080103, 8692092, 4332191, 0, -4304871,
+	-8582805, -12834175, -17059347, -21258679, -25432523, -29581220,
+	-33705107, -37804513, -41879761, -45931167, -49959039, -53963682,
+	-57945393, -61904463, -65841178,
+};
+
+static const int32_t* table = altitudeTable;
+static uint16_t tableSize = ALTITUDE_TABLE_SIZE;
+static uint8_t stepShift = ALTITUDE_STEP_SHIFT;
+
+// Sea level reference and its reciprocal, 2^48 / p0, so no division is needed per sample
+static uint32_t seaLevelPressure = ALTITUDE_SEA_LEVEL_PRESSURE_DEFAULT;
+static uint32_t seaLevelReciprocal = (uint32_t)((1ULL << 48) / ALTITUDE_SEA_LEVEL_PRESSURE_DEFAULT);
+
+// Set the pressure reference of the altitude in Pascal (65537 Pa or more)
+void ALTITUDE_setSeaLevelPressure(uint32_t pressure)
+{
+	if(pressure < ALTITUDE_SEA_LEVEL_MIN) {
+		pressure = ALTITUDE_SEA_LEVEL_MIN;
+	}
+	seaLevelPressure = pressure;
+	seaLevelReciprocal = (uint32_t)((1ULL << 48) / pressure);
+}
+
+// Use a table of the same function and range (from 0.5 in 2^stepShift / 2^20 steps),
+// it is read in place. Returns 0 if the size does not match the step.
+uint8_t ALTITUDE_setTable(const int32_t* newTable, uint16_t size, uint8_t newStepShift)
+{
+	if((newStepShift > 19) || (size != (((1UL << 20) + (1UL << 17) - ALTITUDE_RATIO_MIN) >> newStepShift) + 1)) {
+		return 0;
+	}
+	table = newTable;
+	tableSize = size;
+	stepShift = newStepShift;
+	return 1;
+}
+
+uint32_t ALTITUDE_getSeaLevelPressure(void)
+{
+	return seaLevelPressure;
+}
+
+static int32_t ALTITUDE_evaluate(uint32_t pressure, uint32_t reciprocal)
+{
+	uint32_t ratio = 0;
+	int32_t index = 0;
+	int32_t fraction = 0;
+	int32_t slope = 0;
+
+	/* p / p0 in Q20: (p * 4) * (2^48 / p0) / 2^30 */
+	ratio = (uint32_t)(((uint64_t)pressure * reciprocal) >> 30);
+
+	/* Out of the table the first/last segment is extrapolated */
+	index = ((int32_t)ratio - (int32_t)ALTITUDE_RATIO_MIN) >> stepShift;
+	if(index < 0) {
+		index = 0;
+	}
+	else if(index > tableSize - 2) {
+		index = tableSize - 2;
+	}
+	fraction = (int32_t)ratio - (int32_t)ALTITUDE_RATIO_MIN - (index << stepShift);
+
+	slope = table[index + 1] - table[index];
+	return table[index] + (int32_t)(((int64_t)slope * fraction) >> stepShift);
+}
+
+// Altitude in Q16.16 meter (same format as MPL3115A2_measureAltitudeAndTemperature)
+// from a pressure in Q18.2 Pascal (same format as MPL3115A2_measurePressureAndTemperature).
+int32_t ALTITUDE_fromPressure(uint32_t pressure)
+{
+	return ALTITUDE_evaluate(pressure, seaLevelReciprocal);
+}
+
+// Sea level pressure in Pascal that makes a pressure (Q18.2 Pascal) measured at a
+// known altitude (Q16.16 meter) read that altitude. The altitude grows with p0,
+// so it is a bisection over the table, meant for calibration and not per sample.
+uint32_t ALTITUDE_toSeaLevelPressure(uint32_t pressure, int32_t altitude)
+{
+	uint32_t low = ALTITUDE_SEA_LEVEL_MIN;
+	uint32_t high = (1UL << 18) - 1;
+	uint32_t middle = 0;
+
+	while(low < high) {
+		middle = low + ((high - low) >> 1);
+		if(ALTITUDE_evaluate(pressure, (uint32_t)((1ULL << 48) / middle)) < altitude) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
@@ -0,0 +1,28 @@
+/***************************************************************************//**
+ * @file
+ * @brief altitude.h
+ ******************************************************************************/
+
+#ifndef ALTITUDE_H
+#define ALTITUDE_H
+
+#include <stdint.h>
+
+/*
+ * Altitude from a Barometer mode sample, so one capture gives both the
+ * pressure and the altitude without switching the sensor to Altimeter mode.
+ * h = 44330.77 * (1 - (p / p0) ^ 0.190263) meter, evaluated with a table of
+ * the p / p0 ratio and linear interpolation.
+ */
+
+#define ALTITUDE_SEA_LEVEL_PRESSURE_DEFAULT (101325) // Standard sea level pressure in Pascal
+// Lowest reference: 2^48 / p0 has to fit in 32 bits, 65536 Pa would give 0
+#define ALTITUDE_SEA_LEVEL_MIN              ((1UL << 16) + 1)
+
+void ALTITUDE_setSeaLevelPressure(uint32_t pressure);
+uint32_t ALTITUDE_getSeaLevelPressure(void);
+uint8_t ALTITUDE_setTable(const int32_t* newTable, uint16_t size, uint8_t newStepShift);
+int32_t ALTITUDE_fromPressure(uint32_t pressure);
+uint32_t ALTITUDE_toSeaLevelPressure(uint32_t pressure, int32_t altitude);
+
+#endif // ALTITUDE_H
@@ -0,0 +1,98 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_beacon.c
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sample_log.h"
+#include "ble_beacon.h"
+
+static const BLE_STACK_TypeDef* stack = NULL;
+static uint8_t repeats = 1;
+static bool started = false;      // The stack is ready for advertising
+static uint32_t sampleInterval = 0; // ms
+static uint32_t interval = 0;     // Advertising interval being used, 0.625 ms units
+static uint16_t sequence = 0;
+static uint8_t data[BLE_BEACON_LENGTH] = {
+	0x02, 0x01, 0x04,                                                       // Flags: BR/EDR not supported
+	0x0A, 0xFF, (uint8_t)BLE_BEACON_COMPANY_ID, (uint8_t)(BLE_BEACON_COMPANY_ID >> 8), // Manufacturer specific data
+	BLE_BEACON_FORMAT,
+	0x00, 0x00,                                                             // Sequence
+	0x00, 0x00, 0x00, 0x00,                                                 // Sample
+};
+
+// Advertising interval of the sampling interval
+static uint32_t BLE_BEACON_interval(void)
+{
+	uint32_t units = (sampleInterval * 8) / (5 * (uint32_t)repeats); // 0.625 ms units
+
+	if(units < BLE_BEACON_MIN_INTERVAL) {
+		return BLE_BEACON_MIN_INTERVAL;
+	}
+	if(units > BLE_BEACON_MAX_INTERVAL) {
+		return BLE_BEACON_MAX_INTERVAL;
+	}
+	return units;
+}
+
+void BLE_BEACON_init(const BLE_STACK_TypeDef* bleStack, uint8_t sampleRepeats, uint32_t sampleIntervalMs)
+{
+	stack = bleStack;
+	repeats = (sampleRepeats == 0) ? 1 : sampleRepeats;
+	sampleInterval = sampleIntervalMs;
+	started = false;
+	interval = 0;
+	sequence = 0;
+}
+
+// Start broadcasting once the stack is up (system_boot event)
+void BLE_BEACON_start(void)
+{
+	if(stack == NULL) {
+		return;
+	}
+	started = true;
+	interval = BLE_BEACON_interval();
+	stack->setAdvertisingData(BLE_BEACON_LENGTH, data);
+	stack->broadcast(interval);
+}
+
+// Follow a change of the sampling interval, the advertising restarts only if its interval changes
+void BLE_BEACON_setSampleInterval(uint32_t sampleIntervalMs)
+{
+	uint32_t newInterval = 0;
+
+	sampleInterval = sampleIntervalMs;
+	if((stack == NULL) || !started) {
+		return;
+	}
+	newInterval = BLE_BEACON_interval();
+	if(newInterval != interval) {
+		interval = newInterval;
+		stack->broadcast(interval);
+	}
+}
+
+// Pressure in Q18.2 Pa, temperature in Q8.4 C
+void BLE_BEACON_update(uint32_t pressure, int16_t temperature)
+{
+	uint32_t sample = SAMPLE_LOG_PACK(pressure, temperature);
+
+	sequence++;
+	data[8] = (uint8_t)sequence;
+	data[9] = (uint8_t)(sequence >> 8);
+	data[10] = (uint8_t)sample;
+	data[11] = (uint8_t)(sample >> 8);
+	data[12] = (uint8_t)(sample >> 16);
+	data[13] = (uint8_t)(sample >> 24);
+	if((stack != NULL) && started) {
+		stack->setAdvertisingData(BLE_BEACON_LENGTH, data);
+	}
+}
+
+uint16_t BLE_BEACON_getSequence(void)
+{
+	return sequence;
+}
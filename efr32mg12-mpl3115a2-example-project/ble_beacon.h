@@ -0,0 +1,42 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_beacon.h
+ ******************************************************************************/
+
+#ifndef BLE_BEACON_H
+#define BLE_BEACON_H
+
+#include <stdint.h>
+
+#include "ble_stack.h"
+
+/*
+ * Connectionless broadcast of the latest sample in non-connectable
+ * advertising, for passive scanners. The advertising data is a flags AD and a
+ * manufacturer specific AD (little endian):
+ *
+ *   02 01 04  0A FF  FF 02  format (1)  sequence (2)  sample (4)
+ *
+ * with the Silicon Labs company id 0x02FF, format BLE_BEACON_FORMAT and the
+ * sample packed like the sample log records (SAMPLE_LOG_PACK): pressure in
+ * Q18.2 Pa in bits 31..12, temperature in Q8.4 C in bits 11..0. The sequence
+ * number increments with every sample, so a scanner can tell a new sample
+ * from a repeated one and count the missed ones.
+ * Every sample is advertised about `repeats` times: the advertising interval
+ * is the sampling interval / repeats, at least 100 ms (the limit of the
+ * non-connectable advertising) and at most 40.96 s.
+ */
+
+#define BLE_BEACON_FORMAT        (0x01)
+#define BLE_BEACON_COMPANY_ID    (0x02FF)
+#define BLE_BEACON_LENGTH        (14)
+#define BLE_BEACON_MIN_INTERVAL  (160)    // 100 ms in 0.625 ms units
+#define BLE_BEACON_MAX_INTERVAL  (0xFFFF) // 40.96 s
+
+void BLE_BEACON_init(const BLE_STACK_TypeDef* stack, uint8_t repeats, uint32_t sampleIntervalMs);
+void BLE_BEACON_start(void);
+void BLE_BEACON_setSampleInterval(uint32_t sampleIntervalMs);
+void BLE_BEACON_update(uint32_t pressure, int16_t temperature);
+uint16_t BLE_BEACON_getSequence(void);
+
+#endif // BLE_BEACON_H
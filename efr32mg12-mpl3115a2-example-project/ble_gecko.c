@@ -0,0 +1,129 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_gecko.c
+ ******************************************************************************/
+
+#include "native_gecko.h"
+#include "gatt_db.h"
+
+#include "timestamp.h"
+#include "ble_gecko.h"
+
+static uint16_t BLE_GECKO_writeValue(uint16_t characteristic, uint8_t length, const uint8_t* value);
+static uint16_t BLE_GECKO_notify(uint8_t connection, uint16_t characteristic, uint8_t length, const uint8_t* value);
+static uint16_t BLE_GECKO_setAdvertisingData(uint8_t length, const uint8_t* data);
+static uint16_t BLE_GECKO_broadcast(uint32_t interval);
+static uint16_t BLE_GECKO_updateConnection(uint8_t connection, uint16_t interval, uint16_t latency, uint16_t timeout);
+
+const BLE_STACK_TypeDef BLE_GECKO_stack = {
+	BLE_GECKO_writeValue,
+	BLE_GECKO_notify,
+	BLE_GECKO_setAdvertisingData,
+	BLE_GECKO_broadcast,
+	BLE_GECKO_updateConnection,
+};
+
+static uint8_t bluetoothHeap[DEFAULT_BLUETOOTH_HEAP(BLE_GECKO_MAX_CONNECTIONS)];
+
+// The application loop sleeps in gecko_wait_event, the stack initializes the sleep driver
+static const gecko_configuration_t bluetoothConfig = {
+	.config_flags = 0,
+	.sleep.flags = SLEEP_FLAGS_DEEP_SLEEP_ENABLE,
+	.bluetooth.max_connections = BLE_GECKO_MAX_CONNECTIONS,
+	.bluetooth.heap = bluetoothHeap,
+	.bluetooth.heap_size = sizeof(bluetoothHeap),
+	.bluetooth.sleep_clock_accuracy = 100, // ppm
+	.gattdb = &bg_gattdb_data,
+	.pa.config_enable = 1,
+	.pa.input = GECKO_RADIO_PA_INPUT_VBAT,
+};
+
+// Returns the stack error code, 0 on success
+uint16_t BLE_GECKO_init(void)
+{
+	return gecko_init(&bluetoothConfig);
+}
+
+// Wait ms milliseconds in EM2, the stack events received meanwhile go to the handler
+void BLE_GECKO_wait(uint32_t ms, BLE_GECKO_EventHandler handler)
+{
+	struct gecko_cmd_packet* event;
+
+	gecko_cmd_hardware_set_soft_timer((uint32_t)(((uint64_t)ms * TIMESTAMP_TICKS_PER_SECOND) / 1000), BLE_GECKO_WAIT_TIMER, 1);
+	while (1) {
+		event = gecko_wait_event();
+		if((BGLIB_MSG_ID(event->header) == gecko_evt_hardware_soft_timer_id)
+			&& (event->data.evt_hardware_soft_timer.handle == BLE_GECKO_WAIT_TIMER)) {
+			return;
+		}
+		handler(event);
+	}
+}
+
+// Serve the stack events in EM2 until BLE_GECKO_wakeup is called. A wakeup
+// that comes before the wait is kept by the stack, so it is not lost.
+void BLE_GECKO_waitWakeup(BLE_GECKO_EventHandler handler)
+{
+	struct gecko_cmd_packet* event;
+
+	while (1) {
+		event = gecko_wait_event();
+		if((BGLIB_MSG_ID(event->header) == gecko_evt_system_external_signal_id)
+			&& (event->data.evt_system_external_signal.extsignals & BLE_GECKO_WAKEUP_SIGNAL)) {
+			return;
+		}
+		handler(event);
+	}
+}
+
+// Interrupt safe
+void BLE_GECKO_wakeup(void)
+{
+	gecko_external_signal(BLE_GECKO_WAKEUP_SIGNAL);
+}
+
+// Random number of the stack (BLE_STREAM_Random)
+uint32_t BLE_GECKO_random(void)
+{
+	struct gecko_msg_system_get_random_data_rsp_t* response = gecko_cmd_system_get_random_data(4);
+	uint32_t value = 0;
+	uint8_t i;
+
+	for(i = 0; (i < response->data.len) && (i < 4); i++) {
+		value |= (uint32_t)response->data.data[i] << (8 * i);
+	}
+	return value;
+}
+
+static uint16_t BLE_GECKO_writeValue(uint16_t characteristic, uint8_t length, const uint8_t* value)
+{
+	return gecko_cmd_gatt_server_write_attribute_value(characteristic, 0, length, value)->result;
+}
+
+static uint16_t BLE_GECKO_notify(uint8_t connection, uint16_t characteristic, uint8_t length, const uint8_t* value)
+{
+	return gecko_cmd_gatt_server_send_characteristic_notification(connection, characteristic, length, value)->result;
+}
+
+static uint16_t BLE_GECKO_setAdvertisingData(uint8_t length, const uint8_t* data)
+{
+	return gecko_cmd_le_gap_bt5_set_adv_data(BLE_GECKO_ADVERTISING_SET, 0, length, data)->result;
+}
+
+// The timing is taken by the stack at the start of the advertising
+static uint16_t BLE_GECKO_broadcast(uint32_t interval)
+{
+	uint16_t result = gecko_cmd_le_gap_set_advertise_timing(BLE_GECKO_ADVERTISING_SET, interval, interval, 0, 0)->result;
+
+	if(result != BLE_STACK_SUCCESS) {
+		return result;
+	}
+	gecko_cmd_le_gap_stop_advertising(BLE_GECKO_ADVERTISING_SET);
+	return gecko_cmd_le_gap_start_advertising(BLE_GECKO_ADVERTISING_SET, le_gap_user_data, le_gap_non_connectable)->result;
+}
+
+// Any connection event length, the stack uses the free time of the event for queued notifications
+static uint16_t BLE_GECKO_updateConnection(uint8_t connection, uint16_t interval, uint16_t latency, uint16_t timeout)
+{
+	return gecko_cmd_le_connection_set_timing_parameters(connection, interval, interval, latency, timeout, 0, 0xFFFF)->result;
+}
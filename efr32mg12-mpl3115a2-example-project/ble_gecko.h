@@ -0,0 +1,36 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_gecko.h
+ ******************************************************************************/
+
+#ifndef BLE_GECKO_H
+#define BLE_GECKO_H
+
+#include <stdint.h>
+
+#include "ble_stack.h"
+
+/*
+ * Silicon Labs Bluetooth stack (native_gecko.h) with the GATT database of
+ * gatt.xml. The events are read by the application with gecko_peek_event or
+ * gecko_wait_event, BLE_GECKO_wait serves them while waiting between samples.
+ * BLE_GECKO_waitWakeup serves them until an interrupt calls BLE_GECKO_wakeup.
+ */
+
+#define BLE_GECKO_MAX_CONNECTIONS (4)
+#define BLE_GECKO_WAIT_TIMER      (0) // Soft timer handle of BLE_GECKO_wait
+#define BLE_GECKO_ADVERTISING_SET (0) // The only advertising set
+#define BLE_GECKO_WAKEUP_SIGNAL   (1) // External signal of BLE_GECKO_wakeup
+
+extern const BLE_STACK_TypeDef BLE_GECKO_stack;
+
+struct gecko_cmd_packet;
+typedef void (*BLE_GECKO_EventHandler)(struct gecko_cmd_packet* event);
+
+uint16_t BLE_GECKO_init(void);
+void BLE_GECKO_wait(uint32_t ms, BLE_GECKO_EventHandler handler);
+void BLE_GECKO_waitWakeup(BLE_GECKO_EventHandler handler);
+void BLE_GECKO_wakeup(void);
+uint32_t BLE_GECKO_random(void);
+
+#endif // BLE_GECKO_H
@@ -0,0 +1,318 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_history.c
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "codec.h"
+#include "sample_log.h"
+#include "ble_history.h"
+
+#define BLE_HISTORY_HEADER_SIZE  (2)
+#define BLE_HISTORY_DEFAULT_MTU  (23)
+#define BLE_HISTORY_STARTS       (16) // Packets in flight and the one being sent, a power of two
+#define BLE_HISTORY_SLOT(sequence) ((sequence) & (BLE_HISTORY_STARTS - 1)) // Continuous at the uint16_t wrap
+
+typedef char BLE_HISTORY_startsCheck[(BLE_HISTORY_STARTS > BLE_HISTORY_WINDOW) ? 1 : -1];
+
+static const BLE_STACK_TypeDef* stack = NULL;
+static uint16_t controlCharacteristic = 0;
+static uint16_t dataCharacteristic = 0;
+static BLE_HISTORY_Stats_TypeDef stats;
+
+// Connection of the transfer
+static uint8_t connection = 0;
+static bool connected = false;
+static bool subscribed = false;   // Notifications of the data characteristic
+static bool indicating = false;   // Indications of the control point
+static uint16_t mtu = BLE_HISTORY_DEFAULT_MTU;
+
+// Transfer
+static bool active = false;
+static bool ended = false;        // The last record of the range was read
+static bool completed = false;    // COMPLETE was indicated
+static uint16_t transferId = 0;
+static uint16_t acked = 0;        // First packet not acknowledged
+static uint16_t next = 0;         // Packet being sent
+static uint32_t records = 0;      // Records of the acknowledged packets
+static uint8_t counts[BLE_HISTORY_STARTS];                     // Records of the packets in flight
+static SAMPLE_LOG_Cursor_TypeDef cursor;                       // Next record to read
+static SAMPLE_LOG_Cursor_TypeDef starts[BLE_HISTORY_STARTS];   // First record of the packets in flight
+
+static uint8_t packet[BLE_HISTORY_MAX_MTU - 3];
+static uint16_t packetLength = 0;  // Packet next waiting for the stack, 0: none
+static CODEC_Encoder_TypeDef encoder;
+static uint8_t response[9];
+static uint8_t responseLength = 0; // Control point indication waiting for the stack, 0: none
+
+static void BLE_HISTORY_put16(uint8_t* data, uint16_t value)
+{
+	data[0] = (uint8_t)value;
+	data[1] = (uint8_t)(value >> 8);
+}
+
+static uint16_t BLE_HISTORY_get16(const uint8_t* data)
+{
+	return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+static uint32_t BLE_HISTORY_get32(const uint8_t* data)
+{
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static void BLE_HISTORY_respond(uint8_t opcode, uint8_t result)
+{
+	response[0] = BLE_HISTORY_OP_RESPONSE;
+	response[1] = opcode;
+	response[2] = result;
+	BLE_HISTORY_put16(&response[3], transferId);
+	responseLength = 5;
+}
+
+static void BLE_HISTORY_complete(void)
+{
+	response[0] = BLE_HISTORY_OP_COMPLETE;
+	BLE_HISTORY_put16(&response[1], transferId);
+	BLE_HISTORY_put16(&response[3], next);
+	response[5] = (uint8_t)records;
+	response[6] = (uint8_t)(records >> 8);
+	response[7] = (uint8_t)(records >> 16);
+	response[8] = (uint8_t)(records >> 24);
+	responseLength = 9;
+}
+
+// Indicate the waiting response, returns false if the stack refused it.
+// Without indications on the control point the response is dropped.
+static bool BLE_HISTORY_sendResponse(void)
+{
+	if(responseLength == 0) {
+		return true;
+	}
+	if(!indicating) {
+		responseLength = 0;
+		return true;
+	}
+	if(stack->notify(connection, controlCharacteristic, responseLength, response) != BLE_STACK_SUCCESS) {
+		stats.refused++;
+		return false;
+	}
+	responseLength = 0;
+	return true;
+}
+
+static bool BLE_HISTORY_sink(const SAMPLE_LOG_Record_TypeDef* record, void* context)
+{
+	(void)context;
+	return CODEC_encode(&encoder, record->timestamp, SAMPLE_LOG_PRESSURE(record->data), SAMPLE_LOG_TEMPERATURE(record->data));
+}
+
+// Read the records of packet next, returns false at the end of the range
+static bool BLE_HISTORY_build(void)
+{
+	uint8_t slot = BLE_HISTORY_SLOT(next);
+
+	starts[slot] = cursor;
+	BLE_HISTORY_put16(packet, next);
+	CODEC_encoderInit(&encoder, &packet[BLE_HISTORY_HEADER_SIZE], (uint16_t)(mtu - 3 - BLE_HISTORY_HEADER_SIZE));
+	SAMPLE_LOG_readRange(&cursor, BLE_HISTORY_sink, NULL);
+	counts[slot] = encoder.count;
+	if(encoder.count == 0) {
+		return false;
+	}
+	packetLength = BLE_HISTORY_HEADER_SIZE + CODEC_encoderLength(&encoder);
+	return true;
+}
+
+void BLE_HISTORY_init(const BLE_STACK_TypeDef* bleStack, uint16_t control, uint16_t data)
+{
+	stack = bleStack;
+	controlCharacteristic = control;
+	dataCharacteristic = data;
+	connected = false;
+	subscribed = false;
+	indicating = false;
+	active = false;
+	packetLength = 0;
+	responseLength = 0;
+	memset(&stats, 0, sizeof(stats));
+}
+
+// Write to the control point, returns the result (also indicated in the response)
+uint8_t BLE_HISTORY_onControl(uint8_t writer, const uint8_t* data, uint8_t length)
+{
+	uint8_t result = BLE_HISTORY_INVALID;
+	uint16_t sequence = 0;
+
+	if(length == 0) {
+		return BLE_HISTORY_INVALID;
+	}
+	if(!connected || (writer != connection)) {
+		connection = writer;
+		connected = true;
+		subscribed = false;
+		indicating = false;
+		mtu = BLE_HISTORY_DEFAULT_MTU;
+	}
+
+	switch (data[0]) {
+		case BLE_HISTORY_OP_START:
+			if(length != 9) {
+				break;
+			}
+			transferId++;
+			active = SAMPLE_LOG_seek(&cursor, BLE_HISTORY_get32(&data[1]), BLE_HISTORY_get32(&data[5]));
+			ended = false;
+			completed = false;
+			acked = 0;
+			next = 0;
+			records = 0;
+			packetLength = 0;
+			result = active ? BLE_HISTORY_SUCCESS : BLE_HISTORY_NOT_FOUND;
+			break;
+		case BLE_HISTORY_OP_ACK:
+			if(length != 3) {
+				break;
+			}
+			sequence = BLE_HISTORY_get16(&data[1]);
+			if(!active || ((uint16_t)(sequence - acked) > (uint16_t)(next - acked))) {
+				result = BLE_HISTORY_NO_TRANSFER;
+				break;
+			}
+			for(; acked != sequence; acked++) {
+				records += counts[BLE_HISTORY_SLOT(acked)];
+			}
+			return BLE_HISTORY_SUCCESS; // Not responded, the next packets are the answer
+		case BLE_HISTORY_OP_RESUME:
+			if(length != 5) {
+				break;
+			}
+			sequence = BLE_HISTORY_get16(&data[3]);
+			if(!active || (BLE_HISTORY_get16(&data[1]) != transferId)
+				|| ((uint16_t)(sequence - acked) > (uint16_t)(next - acked))) {
+				result = BLE_HISTORY_NO_TRANSFER;
+				break;
+			}
+			for(; acked != sequence; acked++) {
+				records += counts[BLE_HISTORY_SLOT(acked)];
+			}
+			// Records of the packets not received are read again
+			if((sequence != next) || (packetLength > 0)) {
+				cursor = starts[BLE_HISTORY_SLOT(sequence)];
+			}
+			next = sequence;
+			ended = false;
+			completed = false;
+			packetLength = 0;
+			stats.resumes++;
+			result = BLE_HISTORY_SUCCESS;
+			break;
+		case BLE_HISTORY_OP_ABORT:
+			if(length != 1) {
+				break;
+			}
+			active = false;
+			packetLength = 0;
+			result = BLE_HISTORY_SUCCESS;
+			break;
+		default:
+			break;
+	}
+	BLE_HISTORY_respond(data[0], result);
+	return result;
+}
+
+// Client characteristic configuration change of a connection (gatt_server_characteristic_status event):
+// notifications of the data characteristic or indications of the control point
+void BLE_HISTORY_onSubscription(uint8_t subscriber, uint16_t characteristic, bool enabled)
+{
+	if(((characteristic != dataCharacteristic) && (characteristic != controlCharacteristic))
+		|| (connected && (subscriber != connection))) {
+		return;
+	}
+	if(!connected) {
+		connection = subscriber;
+		connected = true;
+		subscribed = false;
+		indicating = false;
+		mtu = BLE_HISTORY_DEFAULT_MTU;
+	}
+	if(characteristic == dataCharacteristic) {
+		subscribed = enabled;
+	}
+	else {
+		indicating = enabled;
+	}
+}
+
+// Negotiated ATT_MTU of a connection (gatt_mtu_exchanged event), used from the next packet
+void BLE_HISTORY_onMtu(uint8_t peer, uint16_t newMtu)
+{
+	if(connected && (peer != connection)) {
+		return;
+	}
+	if(!connected) {
+		connection = peer;
+		connected = true;
+		subscribed = false;
+		indicating = false;
+	}
+	mtu = (newMtu > BLE_HISTORY_MAX_MTU) ? BLE_HISTORY_MAX_MTU : newMtu;
+}
+
+// The transfer is kept for a RESUME on the next connection
+void BLE_HISTORY_onDisconnect(uint8_t peer)
+{
+	if(connected && (peer == connection)) {
+		connected = false;
+		subscribed = false;
+		indicating = false;
+		responseLength = 0;
+	}
+}
+
+// Send what the window and the stack queue allow, call it after every stack event.
+// Returns true if the stack refused a notification: call it again a bit later.
+bool BLE_HISTORY_process(void)
+{
+	if((stack == NULL) || !connected) {
+		return false;
+	}
+	if(!BLE_HISTORY_sendResponse()) {
+		return true;
+	}
+	if(!active || !subscribed) {
+		return false;
+	}
+
+	while ((uint16_t)(next - acked) < BLE_HISTORY_WINDOW) {
+		if((packetLength == 0) && (ended || !BLE_HISTORY_build())) {
+			ended = true;
+			break;
+		}
+		if(stack->notify(connection, dataCharacteristic, (uint8_t)packetLength, packet) != BLE_STACK_SUCCESS) {
+			stats.refused++;
+			return true;
+		}
+		stats.packets++;
+		stats.bytes += packetLength;
+		stats.records += counts[BLE_HISTORY_SLOT(next)];
+		packetLength = 0;
+		next++;
+	}
+
+	// The transfer stays active for a RESUME until the next START or ABORT
+	if(ended && (acked == next) && !completed) {
+		completed = true;
+		BLE_HISTORY_complete();
+		return !BLE_HISTORY_sendResponse();
+	}
+	return false;
+}
+
+const BLE_HISTORY_Stats_TypeDef* BLE_HISTORY_getStats(void)
+{
+	return &stats;
+}
@@ -0,0 +1,67 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_history.h
+ ******************************************************************************/
+
+#ifndef BLE_HISTORY_H
+#define BLE_HISTORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ble_stack.h"
+
+/*
+ * Bulk download of the sample log (sample_log.h) on the History service of
+ * gatt.xml. The client writes requests to the control point and gets the
+ * responses as indications on it, the records come as notifications on the
+ * data characteristic: a packet sequence number (2 bytes) and a delta coded
+ * block (codec.h) of as many records as fit in ATT_MTU - 3 bytes. Without
+ * indications enabled on the control point the responses are dropped.
+ * At most BLE_HISTORY_WINDOW packets are sent ahead of the acknowledged
+ * sequence number. The transfer survives a disconnection: RESUME with the
+ * transfer id continues from any packet that was not acknowledged yet.
+ * All values are little endian.
+ *
+ * Requests:  START    0x01, from (4), to (4) timestamps in seconds
+ *            ACK      0x02, sequence of the next packet expected (2)
+ *            RESUME   0x03, transfer id (2), sequence of the next packet expected (2)
+ *            ABORT    0x04
+ * Response:  RESPONSE 0x80, request opcode (1), result (1), transfer id (2)
+ * End:       COMPLETE 0x81, transfer id (2), packets (2), records (4),
+ *            indicated when every packet of the range was acknowledged,
+ *            a RESUME after it indicates it again
+ */
+
+#define BLE_HISTORY_OP_START    (0x01)
+#define BLE_HISTORY_OP_ACK      (0x02)
+#define BLE_HISTORY_OP_RESUME   (0x03)
+#define BLE_HISTORY_OP_ABORT    (0x04)
+#define BLE_HISTORY_OP_RESPONSE (0x80)
+#define BLE_HISTORY_OP_COMPLETE (0x81)
+
+#define BLE_HISTORY_SUCCESS     (0)
+#define BLE_HISTORY_NOT_FOUND   (1) // No record in the range
+#define BLE_HISTORY_INVALID     (2) // Unknown opcode or wrong length
+#define BLE_HISTORY_NO_TRANSFER (3) // Unknown transfer id or sequence number
+
+#define BLE_HISTORY_WINDOW      (8)   // Unacknowledged packets
+#define BLE_HISTORY_MAX_MTU     (247)
+
+typedef struct {
+	uint32_t records;  // Records sent, resent ones included
+	uint32_t packets;  // Notifications sent
+	uint32_t bytes;    // Bytes of the notifications
+	uint32_t refused;  // Notifications refused by the stack
+	uint32_t resumes;  // Transfers continued after a RESUME
+} BLE_HISTORY_Stats_TypeDef;
+
+void BLE_HISTORY_init(const BLE_STACK_TypeDef* stack, uint16_t controlCharacteristic, uint16_t dataCharacteristic);
+uint8_t BLE_HISTORY_onControl(uint8_t connection, const uint8_t* data, uint8_t length);
+void BLE_HISTORY_onSubscription(uint8_t connection, uint16_t characteristic, bool enabled);
+void BLE_HISTORY_onMtu(uint8_t connection, uint16_t mtu);
+void BLE_HISTORY_onDisconnect(uint8_t connection);
+bool BLE_HISTORY_process(void);
+const BLE_HISTORY_Stats_TypeDef* BLE_HISTORY_getStats(void);
+
+#endif // BLE_HISTORY_H
@@ -0,0 +1,176 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_policy.c
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ble_policy.h"
+
+static const BLE_STACK_TypeDef* stack = NULL;
+static BLE_POLICY_Clock msClock = NULL;
+static uint32_t maxDelay = 0;        // ms
+static uint32_t period = 0;          // Notification period, ms
+
+static bool connected = false;
+static uint8_t connection = 0;
+static uint16_t initialInterval = 0; // First parameters of the connection
+static uint16_t initialLatency = 0;
+static uint32_t requested = 0;       // Period of the last request, 1.25 ms units, 0: none
+static uint32_t lastMs = 0;          // Time of the last wakeup estimate
+static BLE_POLICY_Stats_TypeDef stats;
+
+// Connection events in elapsedMs with the given parameters: an event is skipped by the slave
+// latency only when there is nothing to send
+static uint32_t BLE_POLICY_events(uint32_t elapsedMs, uint16_t interval, uint16_t latency)
+{
+	uint32_t effective = (uint32_t)interval * (latency + 1U); // 1.25 ms units
+	uint32_t production = (period * 4) / 5;
+
+	if((production > 0) && (production < effective)) {
+		effective = (production > interval) ? production : interval;
+	}
+	return (effective == 0) ? 0 : (elapsedMs * 4) / (effective * 5);
+}
+
+static void BLE_POLICY_account(void)
+{
+	uint32_t now = msClock();
+	uint32_t elapsed = now - lastMs;
+
+	lastMs = now;
+	if(!connected || (stats.interval == 0)) {
+		return;
+	}
+	stats.wakeups += BLE_POLICY_events(elapsed, stats.interval, stats.latency);
+	stats.initialWakeups += BLE_POLICY_events(elapsed, initialInterval, initialLatency);
+}
+
+// Request the parameters of the notification period if they differ enough from those in use
+static void BLE_POLICY_request(void)
+{
+	uint32_t target = (period * 4) / 5; // 1.25 ms units
+	uint32_t current = 0;
+	uint32_t interval = 0;
+	uint32_t latency = 0;
+	uint32_t timeout = 0;
+
+	if(!connected || (stats.interval == 0) || (target == 0)) {
+		return;
+	}
+	current = (requested != 0) ? requested : (uint32_t)stats.interval * (stats.latency + 1U);
+	if((target * 100 >= current * (100 - BLE_POLICY_HYSTERESIS)) && (target * 100 <= current * (100 + BLE_POLICY_HYSTERESIS))) {
+		return;
+	}
+
+	interval = target;
+	if(interval < BLE_POLICY_MIN_INTERVAL) {
+		interval = BLE_POLICY_MIN_INTERVAL;
+	}
+	if(interval > BLE_POLICY_MAX_INTERVAL) {
+		interval = BLE_POLICY_MAX_INTERVAL;
+	}
+	latency = (target > interval) ? (target / interval) - 1 : 0;
+	if(latency > BLE_POLICY_MAX_LATENCY) {
+		latency = BLE_POLICY_MAX_LATENCY;
+	}
+	// 4 times the longest time between events: 1.25 ms units * 4 / 8 = 10 ms units
+	timeout = (interval * (latency + 1)) / 2;
+	if(timeout < BLE_POLICY_MIN_TIMEOUT) {
+		timeout = BLE_POLICY_MIN_TIMEOUT;
+	}
+	if(timeout > BLE_POLICY_MAX_TIMEOUT) {
+		timeout = BLE_POLICY_MAX_TIMEOUT;
+	}
+	if(stack->updateConnection(connection, (uint16_t)interval, (uint16_t)latency, (uint16_t)timeout) == BLE_STACK_SUCCESS) {
+		requested = target;
+		stats.requests++;
+	}
+}
+
+void BLE_POLICY_init(const BLE_STACK_TypeDef* bleStack, BLE_POLICY_Clock policyClock, uint32_t maxDelayMs)
+{
+	stack = bleStack;
+	msClock = policyClock;
+	maxDelay = maxDelayMs;
+	period = 0;
+	connected = false;
+	requested = 0;
+	memset(&stats, 0, sizeof(stats));
+	lastMs = msClock();
+}
+
+// A connection was opened (le_connection_opened event), only the first one is managed
+void BLE_POLICY_onOpened(uint8_t peer)
+{
+	if((stack == NULL) || connected) {
+		return;
+	}
+	BLE_POLICY_account();
+	connected = true;
+	connection = peer;
+	requested = 0;
+	stats.interval = 0;
+}
+
+// Parameters in use (le_connection_parameters event), the first ones are the reference of the wakeups
+void BLE_POLICY_onParameters(uint8_t peer, uint16_t interval, uint16_t latency, uint16_t timeout)
+{
+	if((stack == NULL) || !connected || (peer != connection)) {
+		return;
+	}
+	BLE_POLICY_account();
+	if(stats.interval == 0) {
+		initialInterval = interval;
+		initialLatency = latency;
+	}
+	stats.interval = interval;
+	stats.latency = latency;
+	stats.timeout = timeout;
+	// The answer to the last request may differ from it, it is not requested again
+	BLE_POLICY_request();
+}
+
+void BLE_POLICY_onDisconnect(uint8_t peer)
+{
+	if((stack == NULL) || !connected || (peer != connection)) {
+		return;
+	}
+	BLE_POLICY_account();
+	connected = false;
+	stats.interval = 0;
+}
+
+// Sampling interval and samples per notification (1 for a notification per sample)
+void BLE_POLICY_setProduction(uint32_t sampleIntervalMs, uint8_t samplesPerNotification)
+{
+	uint32_t newPeriod = sampleIntervalMs * (samplesPerNotification == 0 ? 1U : samplesPerNotification);
+
+	if(stack == NULL) {
+		return;
+	}
+	// A notification every maxDelay at least, but not more often than the samples come
+	if((maxDelay > 0) && (newPeriod > maxDelay)) {
+		newPeriod = (sampleIntervalMs > maxDelay) ? sampleIntervalMs : maxDelay;
+	}
+	BLE_POLICY_account();
+	period = newPeriod;
+	BLE_POLICY_request();
+}
+
+const BLE_POLICY_Stats_TypeDef* BLE_POLICY_getStats(void)
+{
+	BLE_POLICY_account();
+	return &stats;
+}
+
+void BLE_POLICY_printReport(void)
+{
+	BLE_POLICY_account();
+	printf("BLE connection: interval %u.%02u ms, latency %u, %lu requests\r\n", (stats.interval * 5) / 4, ((stats.interval * 5) % 4) * 25,
+		stats.latency, (unsigned long)stats.requests);
+	printf("Radio wakeups: %lu, %lu with the parameters of the central (%lu saved)\r\n", (unsigned long)stats.wakeups,
+		(unsigned long)stats.initialWakeups, (unsigned long)((stats.initialWakeups > stats.wakeups) ? stats.initialWakeups - stats.wakeups : 0));
+}
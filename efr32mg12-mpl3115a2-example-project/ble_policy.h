@@ -0,0 +1,58 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_policy.h
+ ******************************************************************************/
+
+#ifndef BLE_POLICY_H
+#define BLE_POLICY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ble_stack.h"
+
+/*
+ * Connection parameter policy: the radio of the connection should wake about
+ * as often as a notification is produced, which is every sampling interval
+ * times the samples per notification, but at least every maxDelayMs (or
+ * every sampling interval when that is longer).
+ * The connection interval follows that period between BLE_POLICY_MIN_INTERVAL
+ * and BLE_POLICY_MAX_INTERVAL, longer periods are covered by slave latency
+ * (events skipped while there is nothing to send, at most
+ * BLE_POLICY_MAX_LATENCY). The supervision timeout is 4 times the longest
+ * time without a connection event, at least 1 s.
+ * A new request is only made when the period moves more than
+ * BLE_POLICY_HYSTERESIS percent from the period of the last request (from
+ * the parameters in use before the first one), so a request the central
+ * answered with other parameters is not repeated.
+ * The radio wakeups are estimated with the parameters in use and with the
+ * first parameters of the connection, that the central chose.
+ */
+
+#define BLE_POLICY_MIN_INTERVAL   (12)  // 15 ms in 1.25 ms units
+#define BLE_POLICY_MAX_INTERVAL   (400) // 500 ms, responses to the central's writes take at most this long
+#define BLE_POLICY_MAX_LATENCY    (9)   // 5 s without a connection event at most
+#define BLE_POLICY_HYSTERESIS     (25)  // Percent
+#define BLE_POLICY_MIN_TIMEOUT    (100) // 1 s in 10 ms units
+#define BLE_POLICY_MAX_TIMEOUT    (3200)
+
+typedef struct {
+	uint16_t interval;       // 1.25 ms units, 0: not connected
+	uint16_t latency;
+	uint16_t timeout;        // 10 ms units
+	uint32_t requests;       // Parameter requests made
+	uint32_t wakeups;        // Estimated connection events of the radio
+	uint32_t initialWakeups; // Estimated with the first parameters of the connections
+} BLE_POLICY_Stats_TypeDef;
+
+typedef uint32_t (*BLE_POLICY_Clock)(void); // Milliseconds
+
+void BLE_POLICY_init(const BLE_STACK_TypeDef* stack, BLE_POLICY_Clock clock, uint32_t maxDelayMs);
+void BLE_POLICY_onOpened(uint8_t connection);
+void BLE_POLICY_onParameters(uint8_t connection, uint16_t interval, uint16_t latency, uint16_t timeout);
+void BLE_POLICY_onDisconnect(uint8_t connection);
+void BLE_POLICY_setProduction(uint32_t sampleIntervalMs, uint8_t samplesPerNotification);
+const BLE_POLICY_Stats_TypeDef* BLE_POLICY_getStats(void);
+void BLE_POLICY_printReport(void);
+
+#endif // BLE_POLICY_H
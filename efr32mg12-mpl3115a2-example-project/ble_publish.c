@@ -0,0 +1,182 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_publish.c
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "ble_publish.h"
+
+#define BLE_PUBLISH_PRESSURE    (0)
+#define BLE_PUBLISH_TEMPERATURE (1)
+#define BLE_PUBLISH_CHANNELS    (2)
+
+typedef struct {
+	uint8_t connection;
+	bool subscribed;
+	bool sent;         // lastSent is valid
+	int32_t lastSent;  // Driver units
+} BLE_PUBLISH_Subscriber_TypeDef;
+
+typedef struct {
+	uint16_t characteristic;
+	uint32_t deadband;
+	bool valid;        // value was set by a sample
+	int32_t value;     // Driver units
+	BLE_PUBLISH_Subscriber_TypeDef subscribers[BLE_PUBLISH_MAX_CONNECTIONS];
+} BLE_PUBLISH_Channel_TypeDef;
+
+static const BLE_STACK_TypeDef* stack = NULL;
+static BLE_PUBLISH_Channel_TypeDef channels[BLE_PUBLISH_CHANNELS];
+static BLE_PUBLISH_Stats_TypeDef stats;
+
+// Characteristic value in the Environmental Sensing format, little endian, returns the length
+static uint8_t BLE_PUBLISH_encode(uint8_t channel, int32_t value, uint8_t* data)
+{
+	if(channel == BLE_PUBLISH_PRESSURE) {
+		// Q18.2 Pa to 0.1 Pa
+		uint32_t pressure = ((uint32_t)value * 5) / 2;
+
+		data[0] = (uint8_t)pressure;
+		data[1] = (uint8_t)(pressure >> 8);
+		data[2] = (uint8_t)(pressure >> 16);
+		data[3] = (uint8_t)(pressure >> 24);
+		return 4;
+	}
+	else {
+		// Q8.4 C to 0.01 C
+		int16_t temperature = (int16_t)((value * 25) / 4);
+
+		data[0] = (uint8_t)temperature;
+		data[1] = (uint8_t)((uint16_t)temperature >> 8);
+		return 2;
+	}
+}
+
+static void BLE_PUBLISH_send(uint8_t channel, BLE_PUBLISH_Subscriber_TypeDef* subscriber)
+{
+	uint8_t data[4];
+	uint8_t length = BLE_PUBLISH_encode(channel, channels[channel].value, data);
+
+	if(stack->notify(subscriber->connection, channels[channel].characteristic, length, data) == BLE_STACK_SUCCESS) {
+		subscriber->sent = true;
+		subscriber->lastSent = channels[channel].value;
+		stats.notifications++;
+	}
+	else {
+		stats.refused++;
+	}
+}
+
+static void BLE_PUBLISH_updateChannel(uint8_t channel, int32_t value)
+{
+	BLE_PUBLISH_Channel_TypeDef* c = &channels[channel];
+	uint8_t data[4];
+	uint8_t length = BLE_PUBLISH_encode(channel, value, data);
+	uint8_t i;
+
+	c->valid = true;
+	c->value = value;
+	if(stack->writeValue(c->characteristic, length, data) != BLE_STACK_SUCCESS) {
+		stats.valueErrors++;
+	}
+	for(i = 0; i < BLE_PUBLISH_MAX_CONNECTIONS; i++) {
+		BLE_PUBLISH_Subscriber_TypeDef* subscriber = &c->subscribers[i];
+		uint32_t change;
+
+		if(!subscriber->subscribed) {
+			continue;
+		}
+		change = (uint32_t)(value > subscriber->lastSent ? value - subscriber->lastSent : subscriber->lastSent - value);
+		if(subscriber->sent && (change <= c->deadband)) {
+			stats.suppressed++;
+			continue;
+		}
+		BLE_PUBLISH_send(channel, subscriber);
+	}
+}
+
+void BLE_PUBLISH_init(const BLE_STACK_TypeDef* bleStack, uint16_t pressureCharacteristic, uint16_t temperatureCharacteristic,
+	uint32_t pressureDeadband, uint16_t temperatureDeadband)
+{
+	stack = bleStack;
+	memset(channels, 0, sizeof(channels));
+	memset(&stats, 0, sizeof(stats));
+	channels[BLE_PUBLISH_PRESSURE].characteristic = pressureCharacteristic;
+	channels[BLE_PUBLISH_PRESSURE].deadband = pressureDeadband;
+	channels[BLE_PUBLISH_TEMPERATURE].characteristic = temperatureCharacteristic;
+	channels[BLE_PUBLISH_TEMPERATURE].deadband = temperatureDeadband;
+}
+
+// Client characteristic configuration change of a connection (gatt_server_characteristic_status event)
+void BLE_PUBLISH_onSubscription(uint8_t connection, uint16_t characteristic, bool notify)
+{
+	uint8_t channel;
+	uint8_t i;
+
+	for(channel = 0; channel < BLE_PUBLISH_CHANNELS; channel++) {
+		BLE_PUBLISH_Channel_TypeDef* c = &channels[channel];
+		BLE_PUBLISH_Subscriber_TypeDef* subscriber = NULL;
+
+		if(c->characteristic != characteristic) {
+			continue;
+		}
+		// The slot of the connection, else a free one
+		for(i = 0; i < BLE_PUBLISH_MAX_CONNECTIONS; i++) {
+			if(c->subscribers[i].subscribed && (c->subscribers[i].connection == connection)) {
+				subscriber = &c->subscribers[i];
+				break;
+			}
+			if((subscriber == NULL) && !c->subscribers[i].subscribed) {
+				subscriber = &c->subscribers[i];
+			}
+		}
+		if(subscriber == NULL) {
+			return;
+		}
+		if(!notify) {
+			subscriber->subscribed = false;
+			return;
+		}
+		if(!subscriber->subscribed) {
+			subscriber->connection = connection;
+			subscriber->subscribed = true;
+			subscriber->sent = false;
+			if(c->valid) {
+				BLE_PUBLISH_send(channel, subscriber);
+			}
+		}
+		return;
+	}
+}
+
+void BLE_PUBLISH_onDisconnect(uint8_t connection)
+{
+	uint8_t channel;
+	uint8_t i;
+
+	for(channel = 0; channel < BLE_PUBLISH_CHANNELS; channel++) {
+		for(i = 0; i < BLE_PUBLISH_MAX_CONNECTIONS; i++) {
+			if(channels[channel].subscribers[i].connection == connection) {
+				channels[channel].subscribers[i].subscribed = false;
+			}
+		}
+	}
+}
+
+// Pressure in Q18.2 Pa, temperature in Q8.4 C
+void BLE_PUBLISH_update(uint32_t pressure, int16_t temperature)
+{
+	if(stack == NULL) {
+		return;
+	}
+	stats.samples++;
+	BLE_PUBLISH_updateChannel(BLE_PUBLISH_PRESSURE, (int32_t)pressure);
+	BLE_PUBLISH_updateChannel(BLE_PUBLISH_TEMPERATURE, temperature);
+}
+
+const BLE_PUBLISH_Stats_TypeDef* BLE_PUBLISH_getStats(void)
+{
+	return &stats;
+}
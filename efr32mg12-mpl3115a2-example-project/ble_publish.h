@@ -0,0 +1,42 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_publish.h
+ ******************************************************************************/
+
+#ifndef BLE_PUBLISH_H
+#define BLE_PUBLISH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ble_stack.h"
+
+/*
+ * Publisher of the samples on the Environmental Sensing pressure (uint32,
+ * 0.1 Pa) and temperature (sint16, 0.01 C) characteristics of gatt.xml.
+ * Every sample updates the local GATT values, a notification is only sent to
+ * the connections that enabled it and only when the value moved more than the
+ * deadband from the last value notified to that connection. A new subscriber
+ * gets the current value at once, a refused notification is tried again with
+ * the next sample. The deadbands are in the units of the driver: Q18.2 Pa
+ * and Q8.4 C.
+ */
+
+#define BLE_PUBLISH_MAX_CONNECTIONS (4) // Connections of the stack configuration (ble_gecko.c)
+
+typedef struct {
+	uint32_t samples;       // Samples published
+	uint32_t notifications; // Notifications sent
+	uint32_t suppressed;    // Subscribed sample values within the deadband
+	uint32_t refused;       // Notifications refused by the stack
+	uint32_t valueErrors;   // Local GATT values not written (the characteristic has to be type="hex" in gatt.xml)
+} BLE_PUBLISH_Stats_TypeDef;
+
+void BLE_PUBLISH_init(const BLE_STACK_TypeDef* stack, uint16_t pressureCharacteristic, uint16_t temperatureCharacteristic,
+	uint32_t pressureDeadband, uint16_t temperatureDeadband);
+void BLE_PUBLISH_onSubscription(uint8_t connection, uint16_t characteristic, bool notify);
+void BLE_PUBLISH_onDisconnect(uint8_t connection);
+void BLE_PUBLISH_update(uint32_t pressure, int16_t temperature);
+const BLE_PUBLISH_Stats_TypeDef* BLE_PUBLISH_getStats(void);
+
+#endif // BLE_PUBLISH_H
@@ -0,0 +1,103 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_sim.c
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "ble_sim.h"
+
+// bg_err_out_of_memory and bg_err_invalid_param of bg_errorcodes.h
+#define BLE_SIM_ERROR_QUEUE_FULL    (0x0101)
+#define BLE_SIM_ERROR_INVALID_PARAM (0x0180)
+
+static uint16_t BLE_SIM_writeValue(uint16_t characteristic, uint8_t length, const uint8_t* value);
+static uint16_t BLE_SIM_notify(uint8_t connection, uint16_t characteristic, uint8_t length, const uint8_t* value);
+static uint16_t BLE_SIM_setAdvertisingData(uint8_t length, const uint8_t* data);
+static uint16_t BLE_SIM_broadcast(uint32_t interval);
+static uint16_t BLE_SIM_updateConnection(uint8_t connection, uint16_t interval, uint16_t latency, uint16_t timeout);
+
+static BLE_SIM_Stats_TypeDef simStats;
+static uint32_t queueSpace = BLE_SIM_QUEUE_UNLIMITED;
+static const BLE_STACK_TypeDef simStack = {
+	BLE_SIM_writeValue,
+	BLE_SIM_notify,
+	BLE_SIM_setAdvertisingData,
+	BLE_SIM_broadcast,
+	BLE_SIM_updateConnection,
+};
+
+const BLE_STACK_TypeDef* BLE_SIM_init(void)
+{
+	memset(&simStats, 0, sizeof(simStats));
+	queueSpace = BLE_SIM_QUEUE_UNLIMITED;
+	return &simStack;
+}
+
+void BLE_SIM_setQueueSpace(uint32_t notifications)
+{
+	queueSpace = notifications;
+}
+
+const BLE_SIM_Stats_TypeDef* BLE_SIM_getStats(void)
+{
+	return &simStats;
+}
+
+static uint16_t BLE_SIM_writeValue(uint16_t characteristic, uint8_t length, const uint8_t* value)
+{
+	(void)characteristic;
+	(void)length;
+	(void)value;
+	simStats.writes++;
+	return BLE_STACK_SUCCESS;
+}
+
+static uint16_t BLE_SIM_notify(uint8_t connection, uint16_t characteristic, uint8_t length, const uint8_t* value)
+{
+	if(queueSpace == 0) {
+		simStats.rejected++;
+		return BLE_SIM_ERROR_QUEUE_FULL;
+	}
+	if(queueSpace != BLE_SIM_QUEUE_UNLIMITED) {
+		queueSpace--;
+	}
+	simStats.notifications++;
+	simStats.notifiedBytes += length;
+	simStats.lastConnection = connection;
+	simStats.lastCharacteristic = characteristic;
+	simStats.lastLength = length;
+	memcpy(simStats.lastValue, value, length);
+	return BLE_STACK_SUCCESS;
+}
+
+static uint16_t BLE_SIM_setAdvertisingData(uint8_t length, const uint8_t* data)
+{
+	if(length > BLE_SIM_MAX_ADVERTISING_LENGTH) {
+		return BLE_SIM_ERROR_INVALID_PARAM;
+	}
+	simStats.advertisingUpdates++;
+	simStats.advertisingLength = length;
+	memcpy(simStats.advertisingData, data, length);
+	return BLE_STACK_SUCCESS;
+}
+
+static uint16_t BLE_SIM_broadcast(uint32_t interval)
+{
+	if((interval < 0x20) || (interval > 0xFFFF)) {
+		return BLE_SIM_ERROR_INVALID_PARAM;
+	}
+	simStats.broadcastStarts++;
+	simStats.broadcastInterval = interval;
+	return BLE_STACK_SUCCESS;
+}
+
+static uint16_t BLE_SIM_updateConnection(uint8_t connection, uint16_t interval, uint16_t latency, uint16_t timeout)
+{
+	(void)connection;
+	simStats.connectionUpdates++;
+	simStats.connectionInterval = interval;
+	simStats.connectionLatency = latency;
+	simStats.connectionTimeout = timeout;
+	return BLE_STACK_SUCCESS;
+}
@@ -0,0 +1,48 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_sim.h
+ ******************************************************************************/
+
+#ifndef BLE_SIM_H
+#define BLE_SIM_H
+
+#include <stdint.h>
+
+#include "ble_stack.h"
+
+/*
+ * Bluetooth stack stub with counters and the last notification, so the
+ * publishers can run and be measured without the radio (e.g. in a host build).
+ * BLE_SIM_setQueueSpace limits the notifications accepted until the next call
+ * (e.g. per connection event), further ones fail like a full stack queue.
+ */
+
+#define BLE_SIM_QUEUE_UNLIMITED (0xFFFFFFFF)
+#define BLE_SIM_MAX_VALUE_LENGTH (255)
+#define BLE_SIM_MAX_ADVERTISING_LENGTH (31)
+
+typedef struct {
+	uint32_t writes;
+	uint32_t notifications;
+	uint32_t notifiedBytes;
+	uint32_t rejected; // Notifications refused for lack of queue space
+	uint8_t lastConnection;
+	uint16_t lastCharacteristic;
+	uint8_t lastLength;
+	uint8_t lastValue[BLE_SIM_MAX_VALUE_LENGTH];
+	uint32_t advertisingUpdates;
+	uint8_t advertisingLength;
+	uint8_t advertisingData[BLE_SIM_MAX_ADVERTISING_LENGTH];
+	uint32_t broadcastStarts;
+	uint32_t broadcastInterval; // 0.625 ms units, 0: not broadcasting
+	uint32_t connectionUpdates;
+	uint16_t connectionInterval; // Last request
+	uint16_t connectionLatency;
+	uint16_t connectionTimeout;
+} BLE_SIM_Stats_TypeDef;
+
+const BLE_STACK_TypeDef* BLE_SIM_init(void);
+void BLE_SIM_setQueueSpace(uint32_t notifications);
+const BLE_SIM_Stats_TypeDef* BLE_SIM_getStats(void);
+
+#endif // BLE_SIM_H
@@ -0,0 +1,33 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_stack.h
+ ******************************************************************************/
+
+#ifndef BLE_STACK_H
+#define BLE_STACK_H
+
+#include <stdint.h>
+
+/*
+ * Bluetooth stack interface of the BLE publishers, implemented by the
+ * Silicon Labs stack (ble_gecko.c) and by a recording stub (ble_sim.c).
+ * The characteristics are the gattdb_ handles of gatt_db.h, the results are
+ * the stack error codes (0 on success, see bg_errorcodes.h).
+ */
+
+#define BLE_STACK_SUCCESS (0)
+
+typedef struct {
+	// Value of the local GATT database, read by the clients without radio traffic
+	uint16_t (*writeValue)(uint16_t characteristic, uint8_t length, const uint8_t* value);
+	// Notification (or indication, as the client enabled it) to one connection, fails when its queue is full
+	uint16_t (*notify)(uint8_t connection, uint16_t characteristic, uint8_t length, const uint8_t* value);
+	// Advertising data (AD structures, at most 31 bytes), replaces the data being advertised
+	uint16_t (*setAdvertisingData)(uint8_t length, const uint8_t* data);
+	// Non-connectable advertising of that data, interval in 0.625 ms units, restarts on a new interval
+	uint16_t (*broadcast)(uint32_t interval);
+	// Connection parameter request: interval in 1.25 ms units, latency in connection events, timeout in 10 ms units
+	uint16_t (*updateConnection)(uint8_t connection, uint16_t interval, uint16_t latency, uint16_t timeout);
+} BLE_STACK_TypeDef;
+
+#endif // BLE_STACK_H
@@ -0,0 +1,248 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_stream.c
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "seal.h"
+#include "ble_stream.h"
+
+typedef struct {
+	uint8_t data[BLE_STREAM_MAX_PACKET];
+	uint16_t length; // 0: free
+	uint8_t count;   // Samples
+} BLE_STREAM_Packet_TypeDef;
+
+static const BLE_STACK_TypeDef* stack = NULL;
+static uint16_t streamCharacteristic = 0;
+static uint32_t maxAge = 0;
+static bool subscribed = false;
+static uint8_t streamConnection = 0;
+static uint16_t mtu = BLE_STREAM_DEFAULT_MTU;
+static uint16_t sequence = 0;
+
+static BLE_STREAM_Packet_TypeDef packets[2];
+static uint8_t building = 0;       // Packet being collected, the other one may be waiting
+static CODEC_Encoder_TypeDef encoder;
+static uint32_t firstMs = 0;       // Timestamp of the first sample being collected
+static uint8_t batchSize = 1;      // Samples of the last packet sent
+static BLE_STREAM_Stats_TypeDef stats;
+static bool sealed = false;        // Packets are sealed with seal.h
+static uint32_t sealDevice = 0;
+static uint32_t sealSession = 0;
+static BLE_STREAM_Random sealRandom = NULL;
+
+static void BLE_STREAM_reset(void)
+{
+	packets[0].length = 0;
+	packets[1].length = 0;
+	building = 0;
+	encoder.count = 0;
+}
+
+// Bytes before the codec block
+static uint8_t BLE_STREAM_headerSize(void)
+{
+	return sealed ? BLE_STREAM_HEADER_SIZE + BLE_STREAM_SESSION_SIZE : BLE_STREAM_HEADER_SIZE;
+}
+
+// Room of the codec block in a packet of the current MTU
+static uint16_t BLE_STREAM_capacity(void)
+{
+	return (uint16_t)(mtu - 3 - BLE_STREAM_headerSize() - (sealed ? SEAL_TAG_SIZE : 0));
+}
+
+// Start collecting into the building packet, sized by the current MTU
+static void BLE_STREAM_begin(void)
+{
+	BLE_STREAM_Packet_TypeDef* packet = &packets[building];
+	uint8_t i;
+
+	packet->data[0] = (uint8_t)sequence;
+	packet->data[1] = (uint8_t)(sequence >> 8);
+	if(sealed) {
+		/* A new session before the sequence numbers (nonce counters) repeat */
+		if(sequence == 0) {
+			sealSession = sealRandom();
+		}
+		for(i = 0; i < BLE_STREAM_SESSION_SIZE; i++) {
+			packet->data[BLE_STREAM_HEADER_SIZE + i] = (uint8_t)(sealSession >> (8 * i));
+		}
+	}
+	sequence++;
+	CODEC_encoderInit(&encoder, &packet->data[BLE_STREAM_headerSize()], BLE_STREAM_capacity());
+}
+
+// Encrypt the block of the packet and append the tag
+static void BLE_STREAM_seal(BLE_STREAM_Packet_TypeDef* packet)
+{
+	uint8_t nonce[SEAL_NONCE_SIZE];
+	uint16_t packetSequence = (uint16_t)(packet->data[0] | (packet->data[1] << 8));
+	uint8_t header = BLE_STREAM_headerSize();
+
+	SEAL_makeNonce(nonce, ((uint64_t)sealDevice << 32) | sealSession, packetSequence);
+	SEAL_encrypt(nonce, packet->data, header, &packet->data[header], (uint16_t)(packet->length - header),
+		&packet->data[packet->length]);
+	packet->length += SEAL_TAG_SIZE;
+}
+
+// Try the waiting packet, returns true if there is none left
+static bool BLE_STREAM_sendWaiting(void)
+{
+	BLE_STREAM_Packet_TypeDef* packet = &packets[building ^ 1];
+
+	if(packet->length == 0) {
+		return true;
+	}
+	if(stack->notify(streamConnection, streamCharacteristic, (uint8_t)packet->length, packet->data) != BLE_STACK_SUCCESS) {
+		stats.refused++;
+		return false;
+	}
+	stats.packets++;
+	batchSize = packet->count;
+	stats.sentSamples += packet->count;
+	stats.sentBytes += packet->length;
+	packet->length = 0;
+	return true;
+}
+
+// Close the packet being collected and send it
+static void BLE_STREAM_flush(void)
+{
+	BLE_STREAM_Packet_TypeDef* waiting = &packets[building ^ 1];
+
+	if(encoder.count == 0) {
+		return;
+	}
+	if(!BLE_STREAM_sendWaiting()) {
+		stats.droppedSamples += waiting->count;
+		waiting->length = 0;
+	}
+	packets[building].length = BLE_STREAM_headerSize() + CODEC_encoderLength(&encoder);
+	packets[building].count = encoder.count;
+	if(sealed) {
+		BLE_STREAM_seal(&packets[building]);
+	}
+	encoder.count = 0;
+	building ^= 1;
+	BLE_STREAM_sendWaiting();
+}
+
+void BLE_STREAM_init(const BLE_STACK_TypeDef* bleStack, uint16_t characteristic, uint32_t maxAgeMs)
+{
+	stack = bleStack;
+	streamCharacteristic = characteristic;
+	maxAge = maxAgeMs;
+	subscribed = false;
+	mtu = BLE_STREAM_DEFAULT_MTU;
+	sequence = 0;
+	batchSize = 1;
+	sealed = false;
+	memset(&stats, 0, sizeof(stats));
+	BLE_STREAM_reset();
+}
+
+// Seal the packets from now on, with the key loaded by SEAL_init. The device identifier
+// (e.g. the low word of the unique id) goes into the nonce with the random session.
+void BLE_STREAM_enableSeal(uint32_t deviceId, BLE_STREAM_Random random)
+{
+	sealDevice = deviceId;
+	sealRandom = random;
+	sealSession = random();
+	sealed = true;
+	BLE_STREAM_reset();
+}
+
+// Client characteristic configuration change of a connection (gatt_server_characteristic_status event)
+void BLE_STREAM_onSubscription(uint8_t connection, uint16_t characteristic, bool notify)
+{
+	if(characteristic != streamCharacteristic) {
+		return;
+	}
+	if(notify && !subscribed) {
+		subscribed = true;
+		streamConnection = connection;
+		BLE_STREAM_reset();
+	}
+	else if(!notify && subscribed && (connection == streamConnection)) {
+		subscribed = false;
+	}
+}
+
+// Negotiated ATT_MTU of a connection (gatt_mtu_exchanged event), used from the next packet
+void BLE_STREAM_onMtu(uint8_t connection, uint16_t newMtu)
+{
+	if(subscribed && (connection != streamConnection)) {
+		return;
+	}
+	if(newMtu > BLE_STREAM_MAX_MTU) {
+		newMtu = BLE_STREAM_MAX_MTU;
+	}
+	mtu = newMtu;
+}
+
+void BLE_STREAM_onDisconnect(uint8_t connection)
+{
+	if(connection == streamConnection) {
+		subscribed = false;
+		mtu = BLE_STREAM_DEFAULT_MTU;
+	}
+}
+
+// Timestamp in ms (TIMESTAMP_getMilliseconds), pressure in Q18.2 Pa, temperature in Q8.4 C
+void BLE_STREAM_push(uint32_t timestampMs, uint32_t pressure, int16_t temperature)
+{
+	if((stack == NULL) || !subscribed) {
+		return;
+	}
+	stats.samples++;
+	if(BLE_STREAM_capacity() < CODEC_HEADER_SIZE) {
+		stats.droppedSamples++; // Sealed packets need a larger MTU than the default
+		return;
+	}
+	if(encoder.count == 0) {
+		BLE_STREAM_begin();
+		firstMs = timestampMs;
+	}
+	if(!CODEC_encode(&encoder, timestampMs, pressure, temperature)) {
+		BLE_STREAM_flush();
+		BLE_STREAM_begin();
+		firstMs = timestampMs;
+		CODEC_encode(&encoder, timestampMs, pressure, temperature);
+	}
+}
+
+// Age deadline of the packet being collected and retry of the waiting one. Returns the
+// milliseconds until the next call is due, 0 if nothing is pending.
+uint32_t BLE_STREAM_process(uint32_t nowMs)
+{
+	uint32_t next = 0;
+
+	if((stack == NULL) || !subscribed) {
+		return 0;
+	}
+	BLE_STREAM_sendWaiting();
+	if((encoder.count > 0) && (nowMs - firstMs >= maxAge)) {
+		BLE_STREAM_flush();
+	}
+	if(encoder.count > 0) {
+		next = maxAge - (nowMs - firstMs);
+	}
+	if((packets[building ^ 1].length > 0) && ((next == 0) || (next > BLE_STREAM_RETRY_MS))) {
+		next = BLE_STREAM_RETRY_MS;
+	}
+	return next;
+}
+
+// Samples per notification, 0 without a subscriber
+uint8_t BLE_STREAM_getBatchSize(void)
+{
+	return subscribed ? batchSize : 0;
+}
+
+const BLE_STREAM_Stats_TypeDef* BLE_STREAM_getStats(void)
+{
+	return &stats;
+}
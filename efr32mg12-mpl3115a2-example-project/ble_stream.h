@@ -0,0 +1,65 @@
+/***************************************************************************//**
+ * @file
+ * @brief ble_stream.h
+ ******************************************************************************/
+
+#ifndef BLE_STREAM_H
+#define BLE_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ble_stack.h"
+#include "codec.h"
+
+/*
+ * High-rate sample stream on the Pressure Stream characteristic of gatt.xml.
+ * The samples of one subscribed connection are collected into a notification
+ * of up to ATT_MTU - 3 bytes: a packet sequence number (2 bytes, little
+ * endian) and a delta coded block (codec.h) with millisecond timestamps.
+ * Every packet is decodable on its own, a gap in the sequence numbers shows a
+ * lost one. A packet is sent when the next sample does not fit or when its
+ * first sample is maxAgeMs old. A refused packet waits while the next one is
+ * collected; when that is full too, the older one is dropped.
+ * BLE_STREAM_process returns when it has to run again, so the deadline also
+ * holds while the application sleeps between the samples (soft timer).
+ *
+ * With BLE_STREAM_enableSeal the block is AES-128-CCM sealed (seal.h, the key
+ * given to SEAL_init): sequence number, session (4 bytes, little endian),
+ * encrypted block, 8 byte tag. The sequence number and the session are the
+ * associated data, the nonce is SEAL_makeNonce(deviceId << 32 | session,
+ * sequence). The session is a new random number at the start and whenever
+ * the sequence number wraps, so a nonce is not repeated after a reset.
+ * Sealed packets need an ATT_MTU of at least 28, the default one is too small.
+ */
+
+#define BLE_STREAM_MAX_MTU       (247) // Largest ATT_MTU the stack is set to accept
+#define BLE_STREAM_DEFAULT_MTU   (23)  // Until the MTU exchange
+#define BLE_STREAM_HEADER_SIZE   (2)
+#define BLE_STREAM_SESSION_SIZE  (4)   // Sealed packets only
+#define BLE_STREAM_MAX_PACKET    (BLE_STREAM_MAX_MTU - 3)
+#define BLE_STREAM_RETRY_MS      (10)  // Retry of a refused packet
+
+// Random number source of the seal sessions, e.g. the Bluetooth stack
+typedef uint32_t (*BLE_STREAM_Random)(void);
+
+typedef struct {
+	uint32_t samples;        // Samples pushed while subscribed
+	uint32_t packets;        // Notifications sent
+	uint32_t sentSamples;    // Samples of the sent notifications
+	uint32_t sentBytes;      // Bytes of the sent notifications
+	uint32_t droppedSamples; // Samples of dropped packets
+	uint32_t refused;        // Notifications refused by the stack
+} BLE_STREAM_Stats_TypeDef;
+
+void BLE_STREAM_init(const BLE_STACK_TypeDef* stack, uint16_t characteristic, uint32_t maxAgeMs);
+void BLE_STREAM_enableSeal(uint32_t deviceId, BLE_STREAM_Random random);
+void BLE_STREAM_onSubscription(uint8_t connection, uint16_t characteristic, bool notify);
+void BLE_STREAM_onMtu(uint8_t connection, uint16_t mtu);
+void BLE_STREAM_onDisconnect(uint8_t connection);
+void BLE_STREAM_push(uint32_t timestampMs, uint32_t pressure, int16_t temperature);
+uint32_t BLE_STREAM_process(uint32_t nowMs);
+uint8_t BLE_STREAM_getBatchSize(void);
+const BLE_STREAM_Stats_TypeDef* BLE_STREAM_getStats(void);
+
+#endif // BLE_STREAM_H
@@ -0,0 +1,151 @@
+/***************************************************************************//**
+ * @file
+ * @brief calibration.c
+ ******************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "MPL3115A2.h"
+#include "altitude.h"
+#include "timestamp.h"
+#include "calibration.h"
+
+#define CALIBRATION_LINE_LENGTH (12)    // Longest serial command
+#define CALIBRATION_ALTITUDE_LIMIT (30000) // Largest accepted altitude in meter
+#define CALIBRATION_PRESSURE_MAX (0xFFFFUL * 2) // BAR_IN is 16 bits in 2 Pascal units
+
+static uint32_t lastPressure = 0; // Last Barometer mode sample in Q18.2 Pascal, 0: none yet
+static char line[CALIBRATION_LINE_LENGTH + 1];
+static uint8_t lineLength = 0;
+static bool lineOverflow = false;
+
+void CALIBRATION_init(uint32_t seaLevelPressure)
+{
+	lastPressure = 0;
+	lineLength = 0;
+	lineOverflow = false;
+	CALIBRATION_setReferencePressure(seaLevelPressure);
+}
+
+// Same after a warm boot: the sensor kept BAR_IN in EM4, possibly changed by a command before the
+// hibernation. The altitude engine follows it, one I2C read and no write.
+void CALIBRATION_initWarm(void)
+{
+	lastPressure = 0;
+	lineLength = 0;
+	lineOverflow = false;
+	ALTITUDE_setSeaLevelPressure(MPL3115A2_getSeaLevelPressure());
+}
+
+// Set the sea level pressure in Pascal. Costs at most one 2 byte I2C write,
+// nothing if the sensor already uses this value (the driver keeps a shadow of BAR_IN).
+// Returns 0 on success, 1 outside ALTITUDE_SEA_LEVEL_MIN ... CALIBRATION_PRESSURE_MAX:
+// those values would be clamped differently by the sensor and the altitude engine.
+uint8_t CALIBRATION_setReferencePressure(uint32_t seaLevelPressure)
+{
+	if((seaLevelPressure < ALTITUDE_SEA_LEVEL_MIN) || (seaLevelPressure > CALIBRATION_PRESSURE_MAX)) {
+		return 1;
+	}
+	MPL3115A2_setSeaLevelPressure(seaLevelPressure);
+	ALTITUDE_setSeaLevelPressure(seaLevelPressure);
+	return 0;
+}
+
+// Estimate the sea level pressure from the last sample taken at a known altitude (Q16.16 meter).
+// Returns 0 on success, 1 if there was no Barometer mode sample yet, 2 if the estimate is out of range.
+uint8_t CALIBRATION_setKnownAltitude(int32_t altitude)
+{
+	if(lastPressure == 0) {
+		return 1;
+	}
+	if(CALIBRATION_setReferencePressure(ALTITUDE_toSeaLevelPressure(lastPressure, altitude)) != 0) {
+		return 2;
+	}
+	return 0;
+}
+
+uint32_t CALIBRATION_getSeaLevelPressure(void)
+{
+	return MPL3115A2_getSeaLevelPressure();
+}
+
+// Feed the Barometer mode samples (Q18.2 Pascal) used by the altitude based estimation
+void CALIBRATION_onSample(uint32_t pressure)
+{
+	lastPressure = pressure;
+}
+
+static void CALIBRATION_processLine(void)
+{
+	long value = 0;
+	char* end = NULL;
+	uint8_t result = 0;
+
+	line[lineLength] = '\0';
+	errno = 0;
+	value = strtol(&line[1], &end, 10);
+	if((lineLength < 2) || (*end != '\0') || (errno == ERANGE)) {
+		printf("Calibration: invalid command\r\n");
+		return;
+	}
+
+	switch(line[0]) {
+	case 'P':
+	case 'p':
+		if((value < 0) || (CALIBRATION_setReferencePressure((uint32_t)value) != 0)) {
+			printf("Calibration: invalid pressure\r\n");
+			return;
+		}
+		break;
+	case 'A':
+	case 'a':
+		if((value > CALIBRATION_ALTITUDE_LIMIT) || (value < -CALIBRATION_ALTITUDE_LIMIT)) {
+			printf("Calibration: invalid altitude\r\n");
+			return;
+		}
+		result = CALIBRATION_setKnownAltitude((int32_t)(value * 65536));
+		if(result != 0) {
+			printf("Calibration: %s\r\n", (result == 1) ? "no pressure sample yet" : "sea level pressure out of range");
+			return;
+		}
+		break;
+	case 'T':
+	case 't':
+		// The sample log needs ascending timestamps, the clock is never set back
+		if((value < 0) || ((long)(uint32_t)value != value) || ((uint32_t)value < TIMESTAMP_get())) {
+			printf("Clock: invalid time, it only goes forward from %lu\r\n", (unsigned long)TIMESTAMP_get());
+			return;
+		}
+		TIMESTAMP_set((uint32_t)value);
+		printf("Clock: %lu\r\n", (unsigned long)TIMESTAMP_get());
+		return;
+	default:
+		printf("Calibration: invalid command\r\n");
+		return;
+	}
+	printf("Calibration: sea level pressure %lu Pascal\r\n", (unsigned long)CALIBRATION_getSeaLevelPressure());
+}
+
+// Feed the characters received on the serial port, the command runs at the end of the line
+void CALIBRATION_processChar(int c)
+{
+	if((c == '\r') || (c == '\n')) {
+		if(lineOverflow) {
+			printf("Calibration: invalid command\r\n");
+		}
+		else if(lineLength > 0) {
+			CALIBRATION_processLine();
+		}
+		lineLength = 0;
+		lineOverflow = false;
+	}
+	else if(lineLength < CALIBRATION_LINE_LENGTH) {
+		line[lineLength++] = (char)c;
+	}
+	else {
+		lineOverflow = true;
+	}
+}
@@ -0,0 +1,30 @@
+/***************************************************************************//**
+ * @file
+ * @brief calibration.h
+ ******************************************************************************/
+
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <stdint.h>
+
+/*
+ * Sea level pressure calibration: keeps the BAR_IN register of the sensor
+ * (Altimeter mode) and the reference of the altitude engine (Barometer mode)
+ * in sync. The reference is given directly or estimated from a known altitude.
+ *
+ * Serial commands, terminated by CR or LF:
+ *   P<pascal>  set the sea level pressure, e.g. P101325 (65537 ... 131070)
+ *   A<meter>   set the current altitude, e.g. A120 (needs a Barometer mode sample)
+ *   T<seconds> set the clock, e.g. T1700000000 (UNIX time, only forward)
+ */
+
+void CALIBRATION_init(uint32_t seaLevelPressure);
+void CALIBRATION_initWarm(void);
+uint8_t CALIBRATION_setReferencePressure(uint32_t seaLevelPressure);
+uint8_t CALIBRATION_setKnownAltitude(int32_t altitude);
+uint32_t CALIBRATION_getSeaLevelPressure(void);
+void CALIBRATION_onSample(uint32_t pressure);
+void CALIBRATION_processChar(int c);
+
+#endif // CALIBRATION_H
@@ -0,0 +1,172 @@
+/***************************************************************************//**
+ * @file
+ * @brief codec.c
+ ******************************************************************************/
+
+#include <stddef.h>
+
+#include "codec.h"
+
+// Small negative and positive differences both become small unsigned numbers
+static uint32_t CODEC_zigzag(int32_t value)
+{
+	return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t CODEC_unzigzag(uint32_t value)
+{
+	return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// 7 bits per byte, the top bit is set on every byte but the last one
+static uint8_t CODEC_putVarint(uint8_t* data, uint32_t value)
+{
+	uint8_t length = 0;
+
+	while(value >= 0x80) {
+		data[length++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	data[length++] = (uint8_t)value;
+	return length;
+}
+
+static bool CODEC_getVarint(CODEC_Decoder_TypeDef* decoder, uint32_t* value)
+{
+	uint32_t result = 0;
+	uint8_t shift = 0;
+	uint8_t byte = 0;
+
+	do {
+		if((decoder->position >= decoder->length) || (shift > 28)) {
+			return false;
+		}
+		byte = decoder->data[decoder->position++];
+		result |= (uint32_t)(byte & 0x7F) << shift;
+		shift += 7;
+	} while(byte & 0x80);
+	*value = result;
+	return true;
+}
+
+static void CODEC_put32(uint8_t* data, uint32_t value)
+{
+	data[0] = (uint8_t)value;
+	data[1] = (uint8_t)(value >> 8);
+	data[2] = (uint8_t)(value >> 16);
+	data[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t CODEC_get32(const uint8_t* data)
+{
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+void CODEC_encoderInit(CODEC_Encoder_TypeDef* encoder, uint8_t* buffer, uint16_t capacity)
+{
+	encoder->buffer = buffer;
+	encoder->capacity = capacity;
+	encoder->length = 0;
+	encoder->count = 0;
+}
+
+// Append a sample to the block, returns false if the block is full (the sample is not added)
+bool CODEC_encode(CODEC_Encoder_TypeDef* encoder, uint32_t timestamp, uint32_t pressure, int16_t temperature)
+{
+	uint8_t* data = NULL;
+
+	if(encoder->count == CODEC_MAX_BLOCK_COUNT) {
+		return false;
+	}
+	if(encoder->count == 0) {
+		if(encoder->capacity < CODEC_HEADER_SIZE) {
+			return false;
+		}
+		data = encoder->buffer;
+		CODEC_put32(&data[1], timestamp);
+		CODEC_put32(&data[5], pressure);
+		data[9] = (uint8_t)temperature;
+		data[10] = (uint8_t)((uint16_t)temperature >> 8);
+		encoder->length = CODEC_HEADER_SIZE;
+	}
+	else {
+		if(encoder->capacity - encoder->length < CODEC_MAX_SAMPLE_SIZE) {
+			/* Exact size only when the worst case does not fit, this is rare */
+			uint8_t scratch[CODEC_MAX_SAMPLE_SIZE];
+			uint8_t length = 0;
+
+			length += CODEC_putVarint(&scratch[length], CODEC_zigzag((int32_t)(timestamp - encoder->timestamp)));
+			length += CODEC_putVarint(&scratch[length], CODEC_zigzag((int32_t)(pressure - encoder->pressure)));
+			length += CODEC_putVarint(&scratch[length], CODEC_zigzag(temperature - encoder->temperature));
+			if(length > encoder->capacity - encoder->length) {
+				return false;
+			}
+		}
+		data = &encoder->buffer[encoder->length];
+		data += CODEC_putVarint(data, CODEC_zigzag((int32_t)(timestamp - encoder->timestamp)));
+		data += CODEC_putVarint(data, CODEC_zigzag((int32_t)(pressure - encoder->pressure)));
+		data += CODEC_putVarint(data, CODEC_zigzag(temperature - encoder->temperature));
+		encoder->length = (uint16_t)(data - encoder->buffer);
+	}
+
+	encoder->count++;
+	encoder->buffer[0] = encoder->count;
+	encoder->timestamp = timestamp;
+	encoder->pressure = pressure;
+	encoder->temperature = temperature;
+	return true;
+}
+
+// Size of the block in the buffer, 0 if it is empty
+uint16_t CODEC_encoderLength(const CODEC_Encoder_TypeDef* encoder)
+{
+	return encoder->length;
+}
+
+// Start reading a block, returns false if the header is truncated
+bool CODEC_decoderInit(CODEC_Decoder_TypeDef* decoder, const uint8_t* data, uint16_t length)
+{
+	decoder->data = data;
+	decoder->length = length;
+	decoder->position = 0;
+	decoder->remaining = 0;
+	if(length < CODEC_HEADER_SIZE) {
+		return false;
+	}
+	decoder->remaining = data[0];
+	return true;
+}
+
+// Next sample of the block, returns false at the end of the block or on a truncated block
+bool CODEC_decode(CODEC_Decoder_TypeDef* decoder, uint32_t* timestamp, uint32_t* pressure, int16_t* temperature)
+{
+	uint32_t deltaTimestamp = 0;
+	uint32_t deltaPressure = 0;
+	uint32_t deltaTemperature = 0;
+
+	if(decoder->remaining == 0) {
+		return false;
+	}
+	if(decoder->position == 0) {
+		decoder->timestamp = CODEC_get32(&decoder->data[1]);
+		decoder->pressure = CODEC_get32(&decoder->data[5]);
+		decoder->temperature = (int16_t)(decoder->data[9] | (decoder->data[10] << 8));
+		decoder->position = CODEC_HEADER_SIZE;
+	}
+	else {
+		if(!CODEC_getVarint(decoder, &deltaTimestamp) || !CODEC_getVarint(decoder, &deltaPressure)
+			|| !CODEC_getVarint(decoder, &deltaTemperature)) {
+			decoder->remaining = 0;
+			return false;
+		}
+		decoder->timestamp += (uint32_t)CODEC_unzigzag(deltaTimestamp);
+		decoder->pressure += (uint32_t)CODEC_unzigzag(deltaPressure);
+		decoder->temperature = (int16_t)(decoder->temperature + CODEC_unzigzag(deltaTemperature));
+	}
+
+	decoder->remaining--;
+	*timestamp = decoder->timestamp;
+	*pressure = decoder->pressure;
+	*temperature = decoder->temperature;
+	return true;
+}
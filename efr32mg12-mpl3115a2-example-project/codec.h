@@ -0,0 +1,54 @@
+/***************************************************************************//**
+ * @file
+ * @brief codec.h
+ ******************************************************************************/
+
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Compression of the pressure/temperature sample stream. A block starts with
+ * a header holding the sample count and the first sample as it is, every
+ * further sample is stored as the zigzag coded differences (timestamp,
+ * pressure, temperature) in variable length (LEB128) integers. Consecutive
+ * samples differ in a few LSBs, so a sample takes 3 bytes instead of 10.
+ * Encoder and decoder are streaming and use constant memory.
+ *
+ * Block: count (1 byte), timestamp (4), pressure in Q18.2 Pascal (4),
+ * temperature in Q8.4 Celsius (2), little endian, then count - 1 deltas.
+ */
+
+#define CODEC_HEADER_SIZE     (11)
+#define CODEC_MAX_SAMPLE_SIZE (5 + 5 + 3) // Worst case of one delta coded sample
+#define CODEC_MAX_BLOCK_COUNT (255)
+
+typedef struct {
+	uint8_t* buffer;       // Block being written
+	uint16_t capacity;     // Size of the buffer
+	uint16_t length;       // Bytes of the block so far
+	uint8_t count;         // Samples of the block so far
+	uint32_t timestamp;    // Previous sample
+	uint32_t pressure;
+	int16_t temperature;
+} CODEC_Encoder_TypeDef;
+
+typedef struct {
+	const uint8_t* data;   // Block being read
+	uint16_t length;       // Size of the block
+	uint16_t position;     // Next byte to read
+	uint8_t remaining;     // Samples not read yet
+	uint32_t timestamp;    // Previous sample
+	uint32_t pressure;
+	int16_t temperature;
+} CODEC_Decoder_TypeDef;
+
+void CODEC_encoderInit(CODEC_Encoder_TypeDef* encoder, uint8_t* buffer, uint16_t capacity);
+bool CODEC_encode(CODEC_Encoder_TypeDef* encoder, uint32_t timestamp, uint32_t pressure, int16_t temperature);
+uint16_t CODEC_encoderLength(const CODEC_Encoder_TypeDef* encoder);
+bool CODEC_decoderInit(CODEC_Decoder_TypeDef* decoder, const uint8_t* data, uint16_t length);
+bool CODEC_decode(CODEC_Decoder_TypeDef* decoder, uint32_t* timestamp, uint32_t* pressure, int16_t* temperature);
+
+#endif // CODEC_H
@@ -0,0 +1,188 @@
+/***************************************************************************//**
+ * @file
+ * @brief crc.c
+ ******************************************************************************/
+
+#include <stddef.h>
+
+#include "crc.h"
+
+#if !defined(CRC_SOFTWARE_ONLY)
+#include "em_device.h"
+#endif
+
+#if defined(GPCRC_PRESENT)
+#include "em_cmu.h"
+#include "em_core.h"
+#include "em_emu.h"
+#include "em_gpcrc.h"
+#include "em_ldma.h"
+#include "dmadrv.h"
+
+#define CRC_POLY_16_REVERSED (0x8408) // 0x1021 bit reversed, GPCRC_POLY takes it this way
+
+static unsigned int dmaChannel = 0;
+static volatile bool dmaActive = false;
+static LDMA_Descriptor_t dmaDescriptor;
+#endif
+
+static const uint32_t crc32Table[16] = {
+	0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+	0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+static const uint16_t crc16Table[16] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+static bool hardware = false; // GPCRC gives the same results as the software
+
+// Half-byte table: 96 bytes of tables instead of 1.5 kB, two lookups per byte
+uint32_t CRC_crc32Software(const void* data, uint32_t length)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	uint32_t crc = 0xFFFFFFFF;
+	uint32_t i;
+
+	for(i = 0; i < length; i++) {
+		crc ^= bytes[i];
+		crc = (crc >> 4) ^ crc32Table[crc & 0x0F];
+		crc = (crc >> 4) ^ crc32Table[crc & 0x0F];
+	}
+	return ~crc;
+}
+
+uint16_t CRC_crc16Software(const void* data, uint32_t length)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	uint16_t crc = 0xFFFF;
+	uint32_t i;
+
+	for(i = 0; i < length; i++) {
+		crc = (uint16_t)((crc << 4) ^ crc16Table[((crc >> 12) ^ (bytes[i] >> 4)) & 0x0F]);
+		crc = (uint16_t)((crc << 4) ^ crc16Table[((crc >> 12) ^ bytes[i]) & 0x0F]);
+	}
+	return crc;
+}
+
+#if defined(GPCRC_PRESENT)
+static bool CRC_dmaDone(unsigned int channel, unsigned int sequenceNo, void* userParam)
+{
+	(void)channel;
+	(void)sequenceNo;
+	(void)userParam;
+	dmaActive = false;
+	return true;
+}
+
+// Set up GPCRC for one frame, the register fields are written directly (em_gpcrc.c is not part of the SDK copy)
+static void CRC_start(bool crc32)
+{
+	if(crc32) {
+		/* The engine shifts LSB first: reflected CRC-32 without any reversal */
+		GPCRC->CTRL = GPCRC_CTRL_EN | GPCRC_CTRL_POLYSEL_CRC32;
+		GPCRC->INIT = 0xFFFFFFFF;
+	}
+	else {
+		/* MSB first CRC-16: input bits reversed, result read bit reversed */
+		GPCRC->CTRL = GPCRC_CTRL_EN | GPCRC_CTRL_POLYSEL_16 | GPCRC_CTRL_BITREVERSE_REVERSED;
+		GPCRC->POLY = CRC_POLY_16_REVERSED;
+		GPCRC->INIT = 0xFFFF;
+	}
+	GPCRC_Start(GPCRC);
+}
+
+// Feed the frame: words with LDMA (long frames) or the CPU, then the remaining bytes
+static void CRC_feed(const uint8_t* bytes, uint32_t length)
+{
+	LDMA_TransferCfg_t transfer = LDMA_TRANSFER_CFG_MEMORY();
+	uint32_t words = 0;
+	uint32_t i;
+	CORE_DECLARE_IRQ_STATE;
+
+	if((((uintptr_t)bytes & 3) == 0) && (length >= CRC_DMA_MIN_LENGTH)) {
+		words = length / 4;
+		/* LDMA_MAX_XFER_COUNT is 2048 words, more than a log page or a frame */
+		if(words > DMADRV_MAX_XFER_COUNT) {
+			words = DMADRV_MAX_XFER_COUNT;
+		}
+		dmaDescriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_M2M_WORD(bytes, &GPCRC->INPUTDATA, words);
+		dmaDescriptor.xfer.dstInc = ldmaCtrlDstIncNone;
+		dmaActive = true;
+		DMADRV_LdmaStartTransfer((int)dmaChannel, &transfer, &dmaDescriptor, CRC_dmaDone, NULL);
+		CORE_ENTER_CRITICAL();
+		while(dmaActive) {
+			EMU_EnterEM1();
+			CORE_EXIT_CRITICAL();
+			CORE_ENTER_CRITICAL();
+		}
+		CORE_EXIT_CRITICAL();
+		bytes += words * 4;
+		length -= words * 4;
+	}
+	if(((uintptr_t)bytes & 3) == 0) {
+		for(; length >= 4; length -= 4, bytes += 4) {
+			GPCRC_InputU32(GPCRC, *(const uint32_t*)bytes);
+		}
+	}
+	for(i = 0; i < length; i++) {
+		GPCRC_InputU8(GPCRC, bytes[i]);
+	}
+}
+#endif
+
+// Enable GPCRC and check it against the software implementation: the check string
+// goes through the CPU path, a word aligned block with a 3 byte tail through LDMA
+void CRC_init(void)
+{
+#if defined(GPCRC_PRESENT)
+	static const char check[] = "123456789";
+	static uint32_t block[(CRC_DMA_MIN_LENGTH + 3 + 3) / 4];
+	uint8_t* bytes = (uint8_t*)block;
+	uint32_t i;
+
+	for(i = 0; i < sizeof(block); i++) {
+		bytes[i] = (uint8_t)(i * 37 + 11);
+	}
+
+	CMU_ClockEnable(cmuClock_GPCRC, true);
+	DMADRV_Init(); // ECODE_EMDRV_DMADRV_ALREADY_INITIALIZED is fine
+	DMADRV_AllocateChannel(&dmaChannel, NULL);
+	hardware = true;
+	hardware = (CRC_crc32(check, 9) == CRC_CHECK_32) && (CRC_crc16(check, 9) == CRC_CHECK_16)
+		&& (CRC_crc32(block, CRC_DMA_MIN_LENGTH + 3) == CRC_crc32Software(block, CRC_DMA_MIN_LENGTH + 3))
+		&& (CRC_crc16(block, CRC_DMA_MIN_LENGTH + 3) == CRC_crc16Software(block, CRC_DMA_MIN_LENGTH + 3));
+#else
+	hardware = false;
+#endif
+}
+
+uint32_t CRC_crc32(const void* data, uint32_t length)
+{
+#if defined(GPCRC_PRESENT)
+	if(hardware) {
+		CRC_start(true);
+		CRC_feed((const uint8_t*)data, length);
+		return ~GPCRC_DataRead(GPCRC);
+	}
+#endif
+	return CRC_crc32Software(data, length);
+}
+
+uint16_t CRC_crc16(const void* data, uint32_t length)
+{
+#if defined(GPCRC_PRESENT)
+	if(hardware) {
+		CRC_start(false);
+		CRC_feed((const uint8_t*)data, length);
+		return (uint16_t)(GPCRC_DataReadBitReversed(GPCRC) >> 16);
+	}
+#endif
+	return CRC_crc16Software(data, length);
+}
+
+bool CRC_isHardware(void)
+{
+	return hardware;
+}
@@ -0,0 +1,36 @@
+/***************************************************************************//**
+ * @file
+ * @brief crc.h
+ ******************************************************************************/
+
+#ifndef CRC_H
+#define CRC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * CRC service on the GPCRC peripheral. Long word aligned frames are fed to
+ * GPCRC with LDMA, the rest with the CPU. CRC_init() checks the hardware
+ * against the software implementation on both paths (the standard check
+ * string and a block longer than CRC_DMA_MIN_LENGTH) and keeps using the
+ * software one if they differ. Without GPCRC, or with
+ * CRC_SOFTWARE_ONLY defined (host build), only the software implementation
+ * is compiled.
+ *
+ * CRC-32: IEEE 802.3 (zlib), check value 0xCBF43926
+ * CRC-16: CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF), check value 0x29B1
+ */
+
+#define CRC_CHECK_32       (0xCBF43926UL)
+#define CRC_CHECK_16       (0x29B1)
+#define CRC_DMA_MIN_LENGTH (64) // Shorter frames are fed by the CPU
+
+void CRC_init(void);
+uint32_t CRC_crc32(const void* data, uint32_t length);
+uint16_t CRC_crc16(const void* data, uint32_t length);
+uint32_t CRC_crc32Software(const void* data, uint32_t length);
+uint16_t CRC_crc16Software(const void* data, uint32_t length);
+bool CRC_isHardware(void);
+
+#endif // CRC_H
@@ -0,0 +1,59 @@
+/***************************************************************************//**
+ * @file
+ * @brief delta_detector.c
+ ******************************************************************************/
+
+#include <stddef.h>
+
+#include "delta_detector.h"
+
+void DELTA_init(DELTA_Detector_TypeDef* detector, int32_t threshold, uint8_t leakShift, uint8_t confirmCount, uint8_t holdoffCount)
+{
+	detector->threshold = threshold;
+	detector->leakShift = leakShift;
+	detector->confirmCount = (confirmCount == 0) ? 1 : confirmCount;
+	detector->holdoffCount = holdoffCount;
+	DELTA_reset(detector);
+}
+
+void DELTA_reset(DELTA_Detector_TypeDef* detector)
+{
+	detector->accumulated = 0;
+	detector->overCount = 0;
+	detector->holdoff = 0;
+}
+
+// Feed the change between the last two samples, constant time.
+// Returns DELTA_EVENT_RISING/FALLING once the accumulated change stayed over
+// the threshold for confirmCount samples in a row, DELTA_EVENT_NONE otherwise.
+int8_t DELTA_update(DELTA_Detector_TypeDef* detector, int32_t delta)
+{
+	int32_t magnitude = 0;
+	int8_t event = DELTA_EVENT_NONE;
+
+	if(detector->holdoff > 0) {
+		detector->holdoff--;
+		return DELTA_EVENT_NONE;
+	}
+
+	/* Slow drifts (weather, temperature) leak out, steps and ramps build up */
+	if(detector->leakShift > 0) {
+		detector->accumulated -= detector->accumulated >> detector->leakShift;
+	}
+	detector->accumulated += delta;
+
+	magnitude = (detector->accumulated < 0) ? -detector->accumulated : detector->accumulated;
+	if(magnitude < detector->threshold) {
+		detector->overCount = 0;
+		return DELTA_EVENT_NONE;
+	}
+
+	detector->overCount++;
+	if(detector->overCount >= detector->confirmCount) {
+		event = (detector->accumulated > 0) ? DELTA_EVENT_RISING : DELTA_EVENT_FALLING;
+		detector->accumulated = 0;
+		detector->overCount = 0;
+		detector->holdoff = detector->holdoffCount;
+	}
+	return event;
+}
@@ -0,0 +1,35 @@
+/***************************************************************************//**
+ * @file
+ * @brief delta_detector.h
+ ******************************************************************************/
+
+#ifndef DELTA_DETECTOR_H
+#define DELTA_DETECTOR_H
+
+#include <stdint.h>
+
+/*
+ * Debounce layer of the MPL3115A2 pressure/temperature change interrupts.
+ * It does not touch any hardware, the deltas read with MPL3115A2_readDelta
+ * are fed to it sample by sample.
+ */
+
+#define DELTA_EVENT_NONE    (0)  // No change reported
+#define DELTA_EVENT_RISING  (1)  // Confirmed rise of the value
+#define DELTA_EVENT_FALLING (-1) // Confirmed fall of the value
+
+typedef struct {
+	int32_t threshold;     // Accumulated change to report, same unit as the deltas
+	uint8_t leakShift;     // The accumulator decays by 1/2^leakShift per sample, 0: no decay
+	uint8_t confirmCount;  // Consecutive samples over the threshold before reporting
+	uint8_t holdoffCount;  // Samples ignored after a reported event
+	int32_t accumulated;   // Leaky sum of the deltas
+	uint8_t overCount;     // Consecutive samples over the threshold so far
+	uint8_t holdoff;       // Remaining samples of the holdoff
+} DELTA_Detector_TypeDef;
+
+void DELTA_init(DELTA_Detector_TypeDef* detector, int32_t threshold, uint8_t leakShift, uint8_t confirmCount, uint8_t holdoffCount);
+void DELTA_reset(DELTA_Detector_TypeDef* detector);
+int8_t DELTA_update(DELTA_Detector_TypeDef* detector, int32_t delta);
+
+#endif // DELTA_DETECTOR_H
@@ -0,0 +1,118 @@
+/***************************************************************************//**
+ * @file
+ * @brief filter.c
+ ******************************************************************************/
+
+#include "filter.h"
+
+void FILTER_medianInit(FILTER_Median_TypeDef* median)
+{
+	median->head = 0;
+	median->count = 0;
+}
+
+// Push a sample and get the median of the last FILTER_MEDIAN_SIZE samples
+// (of the samples so far while the window fills up).
+int32_t FILTER_medianPush(FILTER_Median_TypeDef* median, int32_t sample)
+{
+	uint8_t i = 0;
+
+	/* Remove the oldest sample from the sorted array when the window is full */
+	if(median->count == FILTER_MEDIAN_SIZE) {
+		while(median->sorted[i] != median->window[median->head]) {
+			i++;
+		}
+		for(; i < FILTER_MEDIAN_SIZE - 1; i++) {
+			median->sorted[i] = median->sorted[i + 1];
+		}
+		median->count--;
+	}
+
+	/* Insertion into the sorted array */
+	i = median->count;
+	while((i > 0) && (median->sorted[i - 1] > sample)) {
+		median->sorted[i] = median->sorted[i - 1];
+		i--;
+	}
+	median->sorted[i] = sample;
+	median->count++;
+
+	median->window[median->head] = sample;
+	median->head++;
+	if(median->head == FILTER_MEDIAN_SIZE) {
+		median->head = 0;
+	}
+
+	return median->sorted[median->count / 2];
+}
+
+void FILTER_decimatorInit(FILTER_Decimator_TypeDef* decimator, uint16_t factor)
+{
+	decimator->factor = (factor == 0) ? 1 : factor;
+	decimator->count = 0;
+	decimator->sum = 0;
+}
+
+// Push a sample, returns true with the average of the block on every factor-th sample
+bool FILTER_decimatorPush(FILTER_Decimator_TypeDef* decimator, int32_t sample, int32_t* result)
+{
+	decimator->sum += sample;
+	decimator->count++;
+	if(decimator->count < decimator->factor) {
+		return false;
+	}
+
+	*result = (int32_t)(decimator->sum / decimator->factor);
+	decimator->count = 0;
+	decimator->sum = 0;
+	return true;
+}
+
+void FILTER_iirInit(FILTER_Iir_TypeDef* iir, uint8_t shift)
+{
+	iir->shift = shift;
+	iir->initialized = false;
+	iir->state = 0;
+}
+
+// Push a sample and get the low-pass filtered value, the first sample sets the state
+int32_t FILTER_iirPush(FILTER_Iir_TypeDef* iir, int32_t sample)
+{
+	int64_t input = (int64_t)sample * 256;
+
+	if(!iir->initialized) {
+		iir->state = input;
+		iir->initialized = true;
+	}
+	else {
+		iir->state += (input - iir->state) >> iir->shift;
+	}
+	/* Rounded back from the 8 extra fractional bits */
+	return (int32_t)((iir->state + 128) >> 8);
+}
+
+// decimation: 1 disables the decimator, iirShift: 0 disables the IIR stage
+void FILTER_pipelineInit(FILTER_Pipeline_TypeDef* pipeline, bool median, uint16_t decimation, uint8_t iirShift)
+{
+	pipeline->medianEnabled = median;
+	pipeline->iirEnabled = (iirShift > 0);
+	FILTER_medianInit(&pipeline->median);
+	FILTER_decimatorInit(&pipeline->decimator, decimation);
+	FILTER_iirInit(&pipeline->iir, iirShift);
+}
+
+// Push a raw sample, returns true when the pipeline produced an output sample
+bool FILTER_pipelinePush(FILTER_Pipeline_TypeDef* pipeline, int32_t sample, int32_t* result)
+{
+	if(pipeline->medianEnabled) {
+		sample = FILTER_medianPush(&pipeline->median, sample);
+	}
+	if(!FILTER_decimatorPush(&pipeline->decimator, sample, &sample)) {
+		return false;
+	}
+	if(pipeline->iirEnabled) {
+		sample = FILTER_iirPush(&pipeline->iir, sample);
+	}
+	*result = sample;
+	return true;
+}
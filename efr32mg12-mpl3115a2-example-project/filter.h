@@ -0,0 +1,61 @@
+/***************************************************************************//**
+ * @file
+ * @brief filter.h
+ ******************************************************************************/
+
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Streaming filters for the raw sample stream of the sensor (e.g. Q18.2
+ * pressure). Every stage has fixed memory and constant cost per sample:
+ * - median of FILTER_MEDIAN_SIZE samples, rejects single sample outliers
+ * - boxcar decimator, averages every N samples into one (first order CIC)
+ * - first order IIR low-pass, y += (x - y) / 2^shift
+ * The pipeline runs them in this order: median, decimator, IIR.
+ */
+
+#ifndef FILTER_MEDIAN_SIZE
+#define FILTER_MEDIAN_SIZE (5) // Window of the median stage, odd
+#endif
+
+typedef struct {
+	int32_t window[FILTER_MEDIAN_SIZE]; // Samples in arrival order (ring)
+	int32_t sorted[FILTER_MEDIAN_SIZE]; // The same samples in ascending order
+	uint8_t head;                       // Position of the oldest sample in the window
+	uint8_t count;                      // Number of samples in the window
+} FILTER_Median_TypeDef;
+
+typedef struct {
+	uint16_t factor; // Number of samples averaged into one output
+	uint16_t count;  // Samples in the current block
+	int64_t sum;     // Sum of the current block
+} FILTER_Decimator_TypeDef;
+
+typedef struct {
+	uint8_t shift;    // Smoothing: 1/2^shift of the difference per sample
+	bool initialized; // The first sample was received
+	int64_t state;    // Output with 8 extra fractional bits
+} FILTER_Iir_TypeDef;
+
+typedef struct {
+	bool medianEnabled;
+	bool iirEnabled;
+	FILTER_Median_TypeDef median;
+	FILTER_Decimator_TypeDef decimator;
+	FILTER_Iir_TypeDef iir;
+} FILTER_Pipeline_TypeDef;
+
+void FILTER_medianInit(FILTER_Median_TypeDef* median);
+int32_t FILTER_medianPush(FILTER_Median_TypeDef* median, int32_t sample);
+void FILTER_decimatorInit(FILTER_Decimator_TypeDef* decimator, uint16_t factor);
+bool FILTER_decimatorPush(FILTER_Decimator_TypeDef* decimator, int32_t sample, int32_t* result);
+void FILTER_iirInit(FILTER_Iir_TypeDef* iir, uint8_t shift);
+int32_t FILTER_iirPush(FILTER_Iir_TypeDef* iir, int32_t sample);
+void FILTER_pipelineInit(FILTER_Pipeline_TypeDef* pipeline, bool median, uint16_t decimation, uint8_t iirShift);
+bool FILTER_pipelinePush(FILTER_Pipeline_TypeDef* pipeline, int32_t sample, int32_t* result);
+
+#endif // FILTER_H
@@ -0,0 +1,33 @@
+/***************************************************************************//**
+ * @file
+ * @brief flash_device.h
+ ******************************************************************************/
+
+#ifndef FLASH_DEVICE_H
+#define FLASH_DEVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * NOR flash device interface of the sample log, implemented by the MX25 SPI
+ * flash (mx25flash.c) and by a RAM-backed simulator (flash_sim.c).
+ * Programming can only clear bits, erasing sets a whole sector to 0xFF.
+ * programPage may return before the page is written: the data has to stay
+ * valid until busy() returns false. The other operations wait for it.
+ */
+
+#define FLASH_DEVICE_PAGE_SIZE   (256)  // Largest program operation, page aligned
+#define FLASH_DEVICE_SECTOR_SIZE (4096) // Smallest erase operation
+
+typedef struct {
+	uint32_t size;                                                        // Size in bytes
+	void (*powerUp)(void);                                                // Wake up from the lowest power mode
+	void (*powerDown)(void);                                              // Lowest power mode between operations
+	void (*read)(uint32_t address, uint8_t* data, uint32_t length);
+	void (*programPage)(uint32_t address, const uint8_t* data, uint32_t length); // Within one page
+	void (*eraseSector)(uint32_t address);
+	bool (*busy)(void);                                                   // Page program in progress
+} FLASH_DEVICE_TypeDef;
+
+#endif // FLASH_DEVICE_H
@@ -0,0 +1,84 @@
+/***************************************************************************//**
+ * @file
+ * @brief flash_sim.c
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "flash_sim.h"
+
+static void FLASH_SIM_powerUp(void);
+static void FLASH_SIM_powerDown(void);
+static void FLASH_SIM_read(uint32_t address, uint8_t* data, uint32_t length);
+static void FLASH_SIM_programPage(uint32_t address, const uint8_t* data, uint32_t length);
+static void FLASH_SIM_eraseSector(uint32_t address);
+static bool FLASH_SIM_busy(void);
+
+static uint8_t* simMemory = NULL;
+static FLASH_SIM_Stats_TypeDef simStats;
+static FLASH_DEVICE_TypeDef simDevice = {
+	0,
+	FLASH_SIM_powerUp,
+	FLASH_SIM_powerDown,
+	FLASH_SIM_read,
+	FLASH_SIM_programPage,
+	FLASH_SIM_eraseSector,
+	FLASH_SIM_busy,
+};
+
+// The memory starts erased
+const FLASH_DEVICE_TypeDef* FLASH_SIM_init(uint8_t* memory, uint32_t size)
+{
+	simMemory = memory;
+	simDevice.size = size - (size % FLASH_DEVICE_SECTOR_SIZE);
+	memset(simMemory, 0xFF, simDevice.size);
+	memset(&simStats, 0, sizeof(simStats));
+	return &simDevice;
+}
+
+const FLASH_SIM_Stats_TypeDef* FLASH_SIM_getStats(void)
+{
+	return &simStats;
+}
+
+static void FLASH_SIM_powerUp(void)
+{
+	simStats.powerUps++;
+}
+
+static void FLASH_SIM_powerDown(void)
+{
+}
+
+static void FLASH_SIM_read(uint32_t address, uint8_t* data, uint32_t length)
+{
+	memcpy(data, &simMemory[address], length);
+	simStats.readBytes += length;
+}
+
+static void FLASH_SIM_programPage(uint32_t address, const uint8_t* data, uint32_t length)
+{
+	uint32_t i;
+
+	for(i = 0; i < length; i++) {
+		if(data[i] & ~simMemory[address + i]) {
+			simStats.programErrors++;
+		}
+		simMemory[address + i] &= data[i];
+	}
+	simStats.pagePrograms++;
+	simStats.programmedBytes += length;
+}
+
+static void FLASH_SIM_eraseSector(uint32_t address)
+{
+	address -= address % FLASH_DEVICE_SECTOR_SIZE;
+	memset(&simMemory[address], 0xFF, FLASH_DEVICE_SECTOR_SIZE);
+	simStats.sectorErases++;
+}
+
+// Pages are written synchronously
+static bool FLASH_SIM_busy(void)
+{
+	return false;
+}
@@ -0,0 +1,31 @@
+/***************************************************************************//**
+ * @file
+ * @brief flash_sim.h
+ ******************************************************************************/
+
+#ifndef FLASH_SIM_H
+#define FLASH_SIM_H
+
+#include <stdint.h>
+
+#include "flash_device.h"
+
+/*
+ * RAM-backed NOR flash simulator with operation counters, so the sample log
+ * can run and be measured without the MX25 (e.g. in a host build).
+ * The memory is given by the caller, its size is a multiple of the sector size.
+ */
+
+typedef struct {
+	uint32_t powerUps;
+	uint32_t readBytes;
+	uint32_t pagePrograms;
+	uint32_t programmedBytes;
+	uint32_t sectorErases;
+	uint32_t programErrors; // Programming a 0 bit to 1, which NOR flash cannot do
+} FLASH_SIM_Stats_TypeDef;
+
+const FLASH_DEVICE_TypeDef* FLASH_SIM_init(uint8_t* memory, uint32_t size);
+const FLASH_SIM_Stats_TypeDef* FLASH_SIM_getStats(void);
+
+#endif // FLASH_SIM_H
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""Generate rfs_data.c, the read-only file system (RFS) image of the lookup tables.
+
+Run it from the project directory before building whenever a table changes:
+
+    python3 generate_tables.py [--calibration curve.csv] [--altitude-step-shift 10]
+
+Every file is a 16 byte header (magic, type, entry count, parameter, CRC-32 of
+the entries, little endian) followed by the entries, see tables.h.
+
+  altitude.tbl     44330.77 * (1 - r ^ 0.190263) in Q16.16 meter for
+                   r = 0.5 ... 1.125 in 2^-(20 - shift) steps (parameter: shift)
+  calibration.tbl  Per-unit pressure correction: (pressure, offset) points in
+                   Q18.2 Pascal, read from a CSV of "pressure_pa,offset_pa" lines
+  governor.tbl     Sampling profiles of the governor (GOVERNOR_Profile_TypeDef)
+"""
+
+import argparse
+import struct
+import zlib
+
+MAGIC = 0x4C425454  # "TTBL"
+TYPE_ALTITUDE = 1
+TYPE_CALIBRATION = 2
+TYPE_GOVERNOR = 3
+
+# oversampleShift, timeStep, enterRate, exitRate (Q18.2 Pa/s), same as main.c
+GOVERNOR_PROFILES = [
+    (7, 3, 0, 0),
+    (6, 1, 1 * 4, 1 * 2),
+    (4, 0, 5 * 4, 5 * 2),
+]
+
+
+def table_file(table_type, entries, parameter=0):
+    payload = b"".join(entries)
+    header = struct.pack("<IHHII", MAGIC, table_type, len(entries), parameter, zlib.crc32(payload) & 0xFFFFFFFF)
+    return header + payload
+
+
+def altitude_table(step_shift):
+    ratio_min = 1 << 19  # 0.5 in Q20
+    count = ((1 << 20) + (1 << 17) - ratio_min >> step_shift) + 1  # Up to 1.125
+    entries = []
+    for i in range(count):
+        ratio = (ratio_min + (i << step_shift)) / float(1 << 20)
+        entries.append(struct.pack("<i", int(round(44330.77 * (1.0 - ratio ** 0.190263) * 65536.0))))
+    return table_file(TYPE_ALTITUDE, entries, step_shift)
+
+
+def calibration_table(path):
+    points = [(30000.0, 0.0), (110000.0, 0.0)]  # No correction
+    if path:
+        points = []
+        with open(path) as csv:
+            for line in csv:
+                line = line.split("#")[0].strip()
+                if line:
+                    pressure, offset = line.split(",")
+                    points.append((float(pressure), float(offset)))
+        points.sort()
+    entries = [struct.pack("<Ii", int(round(p * 4)), int(round(o * 4))) for p, o in points]
+    return table_file(TYPE_CALIBRATION, entries)
+
+
+def governor_table():
+    entries = [struct.pack("<BBxxII", *profile) for profile in GOVERNOR_PROFILES]
+    return table_file(TYPE_GOVERNOR, entries)
+
+
+def c_identifier(name):
+    return "".join(c if c.isalnum() else "_" for c in name)
+
+
+def write_source(path, files):
+    lines = [
+        "/***************************************************************************//**",
+        " * @file",
+        " * @brief rfs_data.c",
+        " ******************************************************************************/",
+        "",
+        "// Generated by generate_tables.py, do not edit",
+        "",
+        "#include <stdint.h>",
+        "",
+    ]
+    for name, data in files:
+        lines.append("static const uint8_t %s[%d] __attribute__((aligned(4))) = {" % (c_identifier(name), len(data)))
+        for offset in range(0, len(data), 16):
+            lines.append("\t" + " ".join("0x%02X," % b for b in data[offset:offset + 16]))
+        lines.append("};")
+        lines.append("")
+    lines.append("const uint32_t RFS_fileCount = %d;" % len(files))
+    lines.append("const uint8_t *RFS_fileNames[] = {")
+    lines.extend("\t(const uint8_t *)\"%s\"," % name for name, _ in files)
+    lines.append("};")
+    lines.append("const uint32_t RFS_fileLength[] = {")
+    lines.extend("\t%d," % len(data) for _, data in files)
+    lines.append("};")
+    lines.append("const uint8_t *RFS_fileData[] = {")
+    lines.extend("\t%s," % c_identifier(name) for name, _ in files)
+    lines.append("};")
+    with open(path, "w", newline="\n") as source:
+        source.write("\n".join(lines) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--calibration", help="CSV of pressure_pa,offset_pa points of this unit")
+    parser.add_argument("--altitude-step-shift", type=int, default=10, help="Q20 step of the altitude table (13: built-in table)")
+    parser.add_argument("--output", default="rfs_data.c")
+    args = parser.parse_args()
+
+    write_source(args.output, [
+        ("altitude.tbl", altitude_table(args.altitude_step_shift)),
+        ("calibration.tbl", calibration_table(args.calibration)),
+        ("governor.tbl", governor_table()),
+    ])
+
+
+if __name__ == "__main__":
+    main()
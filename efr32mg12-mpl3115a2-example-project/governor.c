@@ -0,0 +1,105 @@
+/***************************************************************************//**
+ * @file
+ * @brief governor.c
+ ******************************************************************************/
+
+#include <stdio.h>
+
+#include "governor.h"
+
+#define GOVERNOR_RATE_SMOOTHING_SHIFT (1) // The derivative moves half way to each new value
+
+void GOVERNOR_init(GOVERNOR_TypeDef* governor, const GOVERNOR_Profile_TypeDef* profiles, uint8_t profileCount, uint8_t dwellSamples)
+{
+	uint8_t i;
+
+	governor->profiles = profiles;
+	governor->profileCount = (profileCount > GOVERNOR_MAX_PROFILES) ? GOVERNOR_MAX_PROFILES : profileCount;
+	governor->dwellSamples = dwellSamples;
+	governor->current = 0;
+	governor->calmCount = 0;
+	governor->initialized = false;
+	governor->lastPressure = 0;
+	governor->rate = 0;
+	for(i = 0; i < GOVERNOR_MAX_PROFILES; i++) {
+		governor->timeInProfile[i] = 0;
+		governor->samplesInProfile[i] = 0;
+	}
+}
+
+// Feed a pressure sample (Q18.2 Pa) taken with the current profile.
+// Returns true if the profile changed, the caller applies the new one to the sensor.
+bool GOVERNOR_update(GOVERNOR_TypeDef* governor, uint32_t pressure)
+{
+	const GOVERNOR_Profile_TypeDef* profile = &governor->profiles[governor->current];
+	uint32_t difference = 0;
+	uint32_t rate = 0;
+	uint8_t target = governor->current;
+
+	governor->timeInProfile[governor->current] += 1UL << profile->timeStep;
+	governor->samplesInProfile[governor->current]++;
+
+	if(!governor->initialized) {
+		governor->lastPressure = pressure;
+		governor->initialized = true;
+		return false;
+	}
+
+	/* |dp/dt| over the sampling period of the current profile, smoothed */
+	difference = (pressure > governor->lastPressure) ? (pressure - governor->lastPressure) : (governor->lastPressure - pressure);
+	governor->lastPressure = pressure;
+	rate = difference >> profile->timeStep;
+	if(rate >= governor->rate) {
+		governor->rate += (rate - governor->rate) >> GOVERNOR_RATE_SMOOTHING_SHIFT;
+	}
+	else {
+		governor->rate -= (governor->rate - rate) >> GOVERNOR_RATE_SMOOTHING_SHIFT;
+	}
+
+	/* Step up directly to the fastest profile the derivative calls for */
+	while((target + 1 < governor->profileCount) && (rate >= governor->profiles[target + 1].enterRate)) {
+		target++;
+	}
+	if(target != governor->current) {
+		governor->current = target;
+		governor->calmCount = 0;
+		governor->rate = rate;
+		return true;
+	}
+
+	/* Step down one profile after enough calm samples */
+	if((governor->current > 0) && (governor->rate < profile->exitRate)) {
+		governor->calmCount++;
+		if(governor->calmCount >= governor->dwellSamples) {
+			governor->current--;
+			governor->calmCount = 0;
+			return true;
+		}
+	}
+	else {
+		governor->calmCount = 0;
+	}
+	return false;
+}
+
+const GOVERNOR_Profile_TypeDef* GOVERNOR_getProfile(const GOVERNOR_TypeDef* governor)
+{
+	return &governor->profiles[governor->current];
+}
+
+// Sampling period of the current profile in ms
+uint32_t GOVERNOR_getIntervalMs(const GOVERNOR_TypeDef* governor)
+{
+	return 1000UL << governor->profiles[governor->current].timeStep;
+}
+
+// Print the time and the number of samples spent in each profile
+void GOVERNOR_printReport(const GOVERNOR_TypeDef* governor)
+{
+	uint8_t i;
+
+	for(i = 0; i < governor->profileCount; i++) {
+		printf("Profile %u (OSR %u, %lu s): %lu s, %lu samples\r\n", i, 1U << governor->profiles[i].oversampleShift,
+			1UL << governor->profiles[i].timeStep, (unsigned long)governor->timeInProfile[i], (unsigned long)governor->samplesInProfile[i]);
+	}
+}
@@ -0,0 +1,49 @@
+/***************************************************************************//**
+ * @file
+ * @brief governor.h
+ ******************************************************************************/
+
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Sampling rate governor: switches between sampling profiles (oversample
+ * ratio and period) by the short-term pressure derivative. Profiles are
+ * ordered from the calmest (slowest) to the most dynamic (fastest).
+ * A faster profile is entered as soon as the derivative reaches its
+ * enterRate, a slower one only after dwellSamples samples below the
+ * exitRate of the current profile (hysteresis).
+ */
+
+#define GOVERNOR_MAX_PROFILES (4)
+
+typedef struct {
+	uint8_t oversampleShift; // OSR = 2^oversampleShift
+	uint8_t timeStep;        // Sampling period: 2^timeStep s (auto acquisition time step)
+	uint32_t enterRate;      // Entered from slower profiles at |dp/dt| >= enterRate, Q18.2 Pa/s
+	uint32_t exitRate;       // Left towards slower profiles at |dp/dt| < exitRate, Q18.2 Pa/s
+} GOVERNOR_Profile_TypeDef;
+
+typedef struct {
+	const GOVERNOR_Profile_TypeDef* profiles;
+	uint8_t profileCount;
+	uint8_t dwellSamples;                     // Calm samples needed to step down
+	uint8_t current;                          // Index of the active profile
+	uint8_t calmCount;                        // Consecutive calm samples so far
+	bool initialized;                         // The first sample was received
+	uint32_t lastPressure;                    // Previous sample in Q18.2 Pa
+	uint32_t rate;                            // Smoothed |dp/dt| in Q18.2 Pa/s
+	uint32_t timeInProfile[GOVERNOR_MAX_PROFILES];    // Time spent in each profile in s
+	uint32_t samplesInProfile[GOVERNOR_MAX_PROFILES]; // Samples taken in each profile
+} GOVERNOR_TypeDef;
+
+void GOVERNOR_init(GOVERNOR_TypeDef* governor, const GOVERNOR_Profile_TypeDef* profiles, uint8_t profileCount, uint8_t dwellSamples);
+bool GOVERNOR_update(GOVERNOR_TypeDef* governor, uint32_t pressure);
+const GOVERNOR_Profile_TypeDef* GOVERNOR_getProfile(const GOVERNOR_TypeDef* governor);
+uint32_t GOVERNOR_getIntervalMs(const GOVERNOR_TypeDef* governor);
+void GOVERNOR_printReport(const GOVERNOR_TypeDef* governor);
+
+#endif // GOVERNOR_H
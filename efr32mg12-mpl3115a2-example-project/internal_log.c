@@ -0,0 +1,203 @@
+/***************************************************************************//**
+ * @file
+ * @brief internal_log.c
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "em_msc.h"
+#include "dmadrv.h"
+
+#include "internal_log.h"
+
+// The layout has to match the flash page exactly
+typedef char INTERNAL_LOG_pageSizeCheck[(sizeof(INTERNAL_LOG_Page_TypeDef) == FLASH_PAGE_SIZE) ? 1 : -1];
+
+static INTERNAL_LOG_Page_TypeDef* const logPages = (INTERNAL_LOG_Page_TypeDef*)INTERNAL_LOG_START;
+static unsigned int dmaChannel = 0;
+static uint16_t headPage = 0;     // Page being written
+static uint8_t headBlock = 0;     // Next block of the head page
+static uint16_t pageCount = 0;    // Pages with a valid header
+static bool empty = true;         // No page was started yet
+static uint32_t headSequence = 0; // Sequence number of the head page
+static INTERNAL_LOG_Block_TypeDef blockBuffer; // Block being filled
+
+static bool INTERNAL_LOG_pageValid(uint16_t page)
+{
+	return logPages[page].header.magic == INTERNAL_LOG_MAGIC;
+}
+
+static bool INTERNAL_LOG_blockErased(const INTERNAL_LOG_Block_TypeDef* block)
+{
+	const uint32_t* words = (const uint32_t*)block;
+	uint8_t i;
+
+	for(i = 0; i < sizeof(INTERNAL_LOG_Block_TypeDef) / 4; i++) {
+		if(words[i] != 0xFFFFFFFF) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Pages 0..head carry the sequence numbers s0..s0+head, the pages after the
+// head are erased or older, so the predicate below is true up to the head only
+static bool INTERNAL_LOG_beforeHead(uint16_t page, uint32_t first)
+{
+	return INTERNAL_LOG_pageValid(page) && (logPages[page].header.sequence == first + page);
+}
+
+// Find the head page and its first free block
+static void INTERNAL_LOG_scan(void)
+{
+	uint16_t low = 0;
+	uint16_t high = INTERNAL_LOG_PAGES - 1;
+	uint16_t middle = 0;
+	uint32_t first = 0;
+	uint8_t block = 0;
+
+	if(INTERNAL_LOG_pageValid(0)) {
+		first = logPages[0].header.sequence;
+		/* Last page where the predicate holds */
+		while(low < high) {
+			middle = (uint16_t)((low + high + 1) / 2);
+			if(INTERNAL_LOG_beforeHead(middle, first)) {
+				low = middle;
+			}
+			else {
+				high = middle - 1;
+			}
+		}
+		headPage = low;
+	}
+	else if(INTERNAL_LOG_pageValid(INTERNAL_LOG_PAGES - 1)) {
+		/* Power was lost while page 0 was erased after a full lap */
+		headPage = INTERNAL_LOG_PAGES - 1;
+	}
+	else {
+		empty = true;
+		pageCount = 0;
+		headPage = 0;
+		headBlock = INTERNAL_LOG_BLOCKS_PER_PAGE; // The first append starts page 0
+		return;
+	}
+
+	empty = false;
+	headSequence = logPages[headPage].header.sequence;
+	pageCount = INTERNAL_LOG_pageValid((headPage + 1) % INTERNAL_LOG_PAGES) ? INTERNAL_LOG_PAGES : headPage + 1;
+
+	/* Blocks of a page are written in order, uncommitted ones are skipped */
+	for(block = INTERNAL_LOG_BLOCKS_PER_PAGE; block > 0; block--) {
+		if(!INTERNAL_LOG_blockErased(&logPages[headPage].blocks[block - 1])) {
+			break;
+		}
+	}
+	headBlock = block;
+}
+
+// Erase the next page of the ring and write its header
+static void INTERNAL_LOG_startPage(void)
+{
+	uint32_t sequence = empty ? 0 : headSequence + 1;
+	uint32_t magic = INTERNAL_LOG_MAGIC;
+
+	if(!empty) {
+		headPage = (headPage + 1) % INTERNAL_LOG_PAGES;
+	}
+	MSC_ErasePage((uint32_t*)&logPages[headPage]);
+	MSC_WriteWord(&logPages[headPage].header.sequence, &sequence, sizeof(sequence));
+	MSC_WriteWord(&logPages[headPage].header.magic, &magic, sizeof(magic));
+	headSequence = sequence;
+	headBlock = 0;
+	if(pageCount < INTERNAL_LOG_PAGES) {
+		pageCount++;
+	}
+	empty = false;
+}
+
+void INTERNAL_LOG_init(void)
+{
+	MSC_Init();
+	DMADRV_Init(); // ECODE_EMDRV_DMADRV_ALREADY_INITIALIZED is fine
+	DMADRV_AllocateChannel(&dmaChannel, NULL);
+	memset(&blockBuffer, 0xFF, sizeof(blockBuffer));
+	blockBuffer.count = 0;
+	INTERNAL_LOG_scan();
+}
+
+// Add a sample, the flash is only written when a block is full
+void INTERNAL_LOG_append(uint32_t timestamp, uint32_t pressure, int16_t temperature)
+{
+	SAMPLE_LOG_Record_TypeDef* record = &blockBuffer.records[blockBuffer.count];
+
+	record->timestamp = timestamp;
+	record->data = SAMPLE_LOG_PACK(pressure, temperature);
+	blockBuffer.count++;
+	if(blockBuffer.count == INTERNAL_LOG_RECORDS_PER_BLOCK) {
+		INTERNAL_LOG_flush();
+	}
+}
+
+// Write the block (also a partially filled one): the records and the count with DMA, then the commit word
+void INTERNAL_LOG_flush(void)
+{
+	INTERNAL_LOG_Block_TypeDef* block = NULL;
+	uint32_t commit = INTERNAL_LOG_COMMIT;
+
+	if(blockBuffer.count == 0) {
+		return;
+	}
+	if(headBlock == INTERNAL_LOG_BLOCKS_PER_PAGE) {
+		INTERNAL_LOG_startPage();
+	}
+
+	block = &logPages[headPage].blocks[headBlock];
+	MSC_WriteWordDma((int)dmaChannel, (uint32_t*)block, &blockBuffer, sizeof(blockBuffer) - sizeof(blockBuffer.commit));
+	MSC_WriteWord(&block->commit, &commit, sizeof(commit));
+	headBlock++;
+
+	memset(&blockBuffer, 0xFF, sizeof(blockBuffer));
+	blockBuffer.count = 0;
+}
+
+uint16_t INTERNAL_LOG_getPageCount(void)
+{
+	return pageCount;
+}
+
+// Committed block of a page, page 0 is the oldest one, NULL if the block holds no samples
+const INTERNAL_LOG_Block_TypeDef* INTERNAL_LOG_getBlock(uint16_t page, uint8_t block)
+{
+	const INTERNAL_LOG_Block_TypeDef* result = NULL;
+
+	if((page >= pageCount) || (block >= INTERNAL_LOG_BLOCKS_PER_PAGE)) {
+		return NULL;
+	}
+	page = (uint16_t)((headPage + INTERNAL_LOG_PAGES + 1 - pageCount + page) % INTERNAL_LOG_PAGES);
+	result = &logPages[page].blocks[block];
+	if((result->commit != INTERNAL_LOG_COMMIT) || (result->count > INTERNAL_LOG_RECORDS_PER_BLOCK)) {
+		return NULL;
+	}
+	return result;
+}
+
+// Timestamp of the newest sample in the RAM block or in the flash, 0 if the log is empty
+uint32_t INTERNAL_LOG_getNewestTimestamp(void)
+{
+	const INTERNAL_LOG_Block_TypeDef* block = NULL;
+	uint16_t page = 0;
+	uint8_t index = 0;
+
+	if(blockBuffer.count > 0) {
+		return blockBuffer.records[blockBuffer.count - 1].timestamp;
+	}
+	for(page = pageCount; page > 0; page--) {
+		for(index = INTERNAL_LOG_BLOCKS_PER_PAGE; index > 0; index--) {
+			block = INTERNAL_LOG_getBlock(page - 1, index - 1);
+			if((block != NULL) && (block->count > 0)) {
+				return block->records[block->count - 1].timestamp;
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,65 @@
+/***************************************************************************//**
+ * @file
+ * @brief internal_log.h
+ ******************************************************************************/
+
+#ifndef INTERNAL_LOG_H
+#define INTERNAL_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "em_device.h"
+#include "sample_log.h"
+
+/*
+ * Circular sample log in the internal flash of the EFR32MG12, for boards
+ * without the SPI flash. Every flash page starts with a header slot and holds
+ * INTERNAL_LOG_BLOCKS_PER_PAGE blocks. A block is a batch of records written
+ * with MSC_WriteWordDma(), its commit word is written after the data, so a
+ * block cut by a power loss is ignored and skipped. The page sequence
+ * numbers increase along the ring, the head page is found with a binary
+ * search at boot.
+ */
+
+// Default region: 128 kB right below the NVM3 area at the end of the flash, reserved by the
+// linker script (__internalLogSize in efr32mg12p332f1024gl125.ld has to match the pages)
+#ifndef INTERNAL_LOG_PAGES
+#define INTERNAL_LOG_PAGES           (64)
+#endif
+#ifndef INTERNAL_LOG_START
+extern char __nvm3Base[];
+#define INTERNAL_LOG_START           ((uintptr_t)(__nvm3Base - INTERNAL_LOG_PAGES * FLASH_PAGE_SIZE))
+#endif
+
+#define INTERNAL_LOG_MAGIC           (0x494C4F47) // Header slot written completely
+#define INTERNAL_LOG_COMMIT          (0x434F4D54) // Block written completely
+#define INTERNAL_LOG_BLOCK_SIZE      (128)
+#define INTERNAL_LOG_RECORDS_PER_BLOCK ((INTERNAL_LOG_BLOCK_SIZE - 8) / sizeof(SAMPLE_LOG_Record_TypeDef))
+#define INTERNAL_LOG_BLOCKS_PER_PAGE (FLASH_PAGE_SIZE / INTERNAL_LOG_BLOCK_SIZE - 1)
+
+typedef struct {
+	SAMPLE_LOG_Record_TypeDef records[INTERNAL_LOG_RECORDS_PER_BLOCK];
+	uint32_t count;  // Records in the block
+	uint32_t commit; // INTERNAL_LOG_COMMIT, written last
+} INTERNAL_LOG_Block_TypeDef;
+
+typedef struct {
+	uint32_t sequence; // Page sequence number, written first
+	uint32_t magic;    // INTERNAL_LOG_MAGIC, written last
+	uint32_t reserved[(INTERNAL_LOG_BLOCK_SIZE - 8) / 4];
+} INTERNAL_LOG_PageHeader_TypeDef;
+
+typedef struct {
+	INTERNAL_LOG_PageHeader_TypeDef header;
+	INTERNAL_LOG_Block_TypeDef blocks[INTERNAL_LOG_BLOCKS_PER_PAGE];
+} INTERNAL_LOG_Page_TypeDef; // One flash page
+
+void INTERNAL_LOG_init(void);
+void INTERNAL_LOG_append(uint32_t timestamp, uint32_t pressure, int16_t temperature);
+void INTERNAL_LOG_flush(void);
+uint32_t INTERNAL_LOG_getNewestTimestamp(void);
+uint16_t INTERNAL_LOG_getPageCount(void);
+const INTERNAL_LOG_Block_TypeDef* INTERNAL_LOG_getBlock(uint16_t page, uint8_t block);
+
+#endif // INTERNAL_LOG_H
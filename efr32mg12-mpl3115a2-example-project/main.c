@@ -28,19 +28,114 @@
 #include "init_mcu.h"
 
 #include "MPL3115A2.h"
+#include "delta_detector.h"
+#include "altitude.h"
+#include "calibration.h"
+#include "variometer.h"
+#include "filter.h"
+#include "governor.h"
+#include "rolling_stats.h"
+#include "timestamp.h"
+#include "rollup.h"
+#include "tendency.h"
+#include "mx25flash.h"
+#include "sample_log.h"
+#include "internal_log.h"
+#include "crc.h"
+#include "tables.h"
+#include "retained.h"
+#include "warm_boot.h"
+#include "seal.h"
+#include "ble_publish.h"
+#include "ble_stream.h"
+#include "ble_history.h"
+#include "ble_beacon.h"
+#include "ble_policy.h"
+#include "ble_gecko.h"
 
 #include "em_i2c.h"
 #include "em_cmu.h"
+#include "em_emu.h"
+
+#include "native_gecko.h"
+#include "gatt_db.h"
+
+// Sampling period of the application loop in ms (Altimeter mode, the Barometer mode uses the governor profiles)
+#define MEASUREMENT_INTERVAL_MS (3000)
+// Calm samples before the governor steps down to a slower profile
+#define GOVERNOR_DWELL_SAMPLES (5)
+// Windows of the pressure summaries in samples, one minute and one hour at 1 Hz (8 bytes RAM per sample)
+#define PRESSURE_STATS_MINUTE_SAMPLES (60)
+#define PRESSURE_STATS_HOUR_SAMPLES (3600)
+// Gains of the vertical speed filter, beta = alpha^2 / (2 - alpha) is critically damped
+#define VARIO_ALPHA (VARIO_GAIN(0.5))
+#define VARIO_BETA (VARIO_GAIN(0.1667))
+// Set the macro to 1 for oversampling in software: fast one-shot samples at a low OSR through the filter pipeline
+#define PRESSURE_FILTER_MODE (0)
+// OSR = 2^shift of the one-shot samples, their period in ms and the pipeline settings
+#define PRESSURE_FILTER_OSR_SHIFT (0)
+#define PRESSURE_FILTER_INTERVAL_MS (10)
+#define PRESSURE_FILTER_DECIMATION (16)
+#define PRESSURE_FILTER_IIR_SHIFT (2)
 
 // Set this macro to 1 for displaying detailed debug informations
 #define DEBUG_MODE (0)
 // Set the macro to 1 for using the MPL3115A2 sensor in Altimeter mode
 #define MPL3115A2_ALTIMETER_MODE (0)
+// Initial sea level pressure in Pascal for the altitude, it can be changed on the serial port (see calibration.h)
+#define MPL3115A2_SEA_LEVEL_PRESSURE (ALTITUDE_SEA_LEVEL_PRESSURE_DEFAULT)
+// Set the macro to 1 for waking up only on the threshold and window interrupts of the sensor
+#define MPL3115A2_EVENT_MODE (0)
+// Pressure target and window of the event mode in Pascal, temperature target and window in Celsius degree
+#define MPL3115A2_EVENT_PRESSURE_TARGET (101325)
+#define MPL3115A2_EVENT_PRESSURE_WINDOW (200)
+#define MPL3115A2_EVENT_TEMPERATURE_TARGET (25)
+#define MPL3115A2_EVENT_TEMPERATURE_WINDOW (5)
+// Sampling period of the event mode: 2^step seconds, the thresholds are checked on every sample
+#define MPL3115A2_EVENT_TIME_STEP (0)
+// Set the macro to 1 for waking up only on the pressure change interrupt of the sensor (doors, elevators)
+#define MPL3115A2_DELTA_MODE (0)
+// Set the macro to 1 for logging the samples to the internal flash instead of the SPI flash
+#define INTERNAL_FLASH_LOG (0)
+// Set the macro to 1 for one sample per wakeup from EM4 Hibernate, the samples are collected in the
+// RTCC retention registers and written to the flash log when that is full (see retained.h)
+#define EM4_BURST_MODE (0)
+#define EM4_BURST_INTERVAL_S (10)
+// Set the macro to 1 for publishing the samples on the Environmental Sensing characteristics over BLE
+#define BLE_MODE (0)
+// Notified changes: pressure in Q18.2 Pascal, temperature in 1/16 Celsius degree
+#define BLE_PRESSURE_DEADBAND (4 * 4)
+#define BLE_TEMPERATURE_DEADBAND (8)
+// Longest wait of a sample of the Pressure Stream characteristic for a fuller notification
+#define BLE_STREAM_MAX_AGE_MS (1000)
+// Set the macro to 1 (with BLE_MODE) for AES-128-CCM sealed Pressure Stream notifications (seal.h).
+// The key is provisioned in the user data page, e.g. commander flash key.bin --address 0x0FE00000;
+// without a key there is no stream.
+#define BLE_STREAM_SEAL (0)
+#define SEAL_KEY_ADDRESS (USERDATA_BASE)
+// Set the macro to 1 (with BLE_MODE) for broadcasting the latest sample in non-connectable advertising
+// instead of advertising the GATT services, every sample is advertised about BLE_BEACON_REPEATS times
+#define BLE_BEACON_MODE (0)
+#define BLE_BEACON_REPEATS (3)
+// Soft timer of the notifications refused by the stack (BLE_GECKO_WAIT_TIMER is 0), 10 ms
+#define BLE_RETRY_TIMER (1)
+#define BLE_RETRY_TICKS (328)
+// Soft timer of the Pressure Stream deadlines while the application waits
+#define BLE_STREAM_TIMER (2)
+// Sensor settings of this firmware, a warm boot is only taken with the same settings
+#define SENSOR_CONFIG_ID ((MPL3115A2_ALTIMETER_MODE << 0) | (EM4_BURST_MODE << 1) | (PRESSURE_FILTER_MODE << 2))
+// Sampling period of the delta mode: 2^step seconds
+#define MPL3115A2_DELTA_TIME_STEP (0)
+// Reported pressure change in Q18.2 Pascal (about 12 Pa per meter), decay, confirmation and holdoff in samples
+#define MPL3115A2_DELTA_THRESHOLD (8 * 4)
+#define MPL3115A2_DELTA_LEAK_SHIFT (3)
+#define MPL3115A2_DELTA_CONFIRM (2)
+#define MPL3115A2_DELTA_HOLDOFF (5)
 
 /**************************************************************************//**
  * @brief  Setup I2C peripheral
  *****************************************************************************/
-void initI2C(void)
+void initI2C(bool verbose)
 {
   // Using default settings
   I2C_Init_TypeDef i2cInit = I2C_INIT_DEFAULT;
@@ -48,17 +143,23 @@ void initI2C(void)
   i2cInit.freq = I2C_FREQ_FAST_MAX;
 
   // Enabling clock to the I2C, GPIO
-  printf("Enabling clocks to the I2C, GPIO\r\n");
+  if(verbose) {
+    printf("Enabling clocks to the I2C, GPIO\r\n");
+  }
   CMU_ClockEnable(cmuClock_I2C0, true);
   CMU_ClockEnable(cmuClock_GPIO, true);
 
   // Using PC10 (SDA) and PC11 (SCL)
-  printf("Enable I2C pins: using PC10 (SDA) and PC11 (SCL)\r\n");
+  if(verbose) {
+    printf("Enable I2C pins: using PC10 (SDA) and PC11 (SCL)\r\n");
+  }
   GPIO_PinModeSet(gpioPortC, 10, gpioModeWiredAnd, 1);
   GPIO_PinModeSet(gpioPortC, 11, gpioModeWiredAnd, 1);
 
   // Enable pins at location 15 as specified in datasheet
-  printf("Enable pins at location 15 as specified in datasheet\r\n");
+  if(verbose) {
+    printf("Enable pins at location 15 as specified in datasheet\r\n");
+  }
   I2C0->ROUTEPEN = I2C_ROUTEPEN_SDAPEN | I2C_ROUTEPEN_SCLPEN;
   I2C0->ROUTELOC0 = (I2C0->ROUTELOC0 & (~_I2C_ROUTELOC0_SDALOC_MASK)) | I2C_ROUTELOC0_SDALOC_LOC15;
   I2C0->ROUTELOC0 = (I2C0->ROUTELOC0 & (~_I2C_ROUTELOC0_SCLLOC_MASK)) | I2C_ROUTELOC0_SCLLOC_LOC15;
@@ -94,6 +195,361 @@ uint8_t initMPL3115A2(void)
 	}
 }
 
+// Sampling profiles of the Barometer mode from the calmest to the most dynamic,
+// rates are |dp/dt| in Q18.2 Pascal per second
+static const GOVERNOR_Profile_TypeDef governorProfiles[] = {
+	{ 7, 3, 0,      0      }, // OSR 128, 8 s: weather
+	{ 6, 1, 1 * 4,  1 * 2  }, // OSR 64, 2 s: from 1 Pa/s, back below 0.5 Pa/s
+	{ 4, 0, 5 * 4,  5 * 2  }, // OSR 16, 1 s: from 5 Pa/s (about 0.4 m/s), back below 2.5 Pa/s
+};
+
+static ROLLING_STATS_Slot_TypeDef minuteSlots[PRESSURE_STATS_MINUTE_SAMPLES];
+static ROLLING_STATS_Slot_TypeDef hourSlots[PRESSURE_STATS_HOUR_SAMPLES];
+
+#if BLE_MODE == 1
+// Value of the Pressure Summary characteristic: the minute and the hour window, each
+// count (uint16), mean, stddev, min, max (32 bits, Q18.2 Pascal), little endian
+#define PRESSURE_SUMMARY_SIZE (18)
+static uint8_t summaryValue[2 * PRESSURE_SUMMARY_SIZE];
+
+static uint8_t* putLittleEndian(uint8_t* data, uint32_t value, uint8_t length)
+{
+	while(length-- > 0) {
+		*data++ = (uint8_t)value;
+		value >>= 8;
+	}
+	return data;
+}
+#endif
+
+// Summary of a pressure window (0: minute, 1: hour) instead of the raw samples
+void reportSummary(const char* name, uint8_t window, const ROLLING_STATS_TypeDef* stats)
+{
+	ROLLING_STATS_Summary_TypeDef summary;
+	#if BLE_MODE == 1
+		uint8_t* data = &summaryValue[window * PRESSURE_SUMMARY_SIZE];
+	#else
+		(void)window;
+	#endif
+
+	if(ROLLING_STATS_getSummary(stats, &summary)) {
+		printf("Pressure of the last %s (%u samples): mean %ld, stddev %lu, min %ld, max %ld (Q18.2 Pascal)\r\n",
+			name, summary.count, summary.mean, summary.stdDev, summary.min, summary.max);
+		#if BLE_MODE == 1
+			data = putLittleEndian(data, summary.count, 2);
+			data = putLittleEndian(data, (uint32_t)summary.mean, 4);
+			data = putLittleEndian(data, summary.stdDev, 4);
+			data = putLittleEndian(data, (uint32_t)summary.min, 4);
+			putLittleEndian(data, (uint32_t)summary.max, 4);
+			// Read by the clients from the GATT database
+			BLE_GECKO_stack.writeValue(gattdb_es_pressure_summary, sizeof(summaryValue), summaryValue);
+		#endif
+	}
+}
+
+// The hourly means feed the 3-hour pressure tendency
+void onRollupClose(uint8_t tier, const ROLLUP_Bucket_TypeDef* bucket)
+{
+	if(tier == ROLLUP_TIER_HOUR) {
+		TENDENCY_onHour(bucket->start, bucket->mean);
+	}
+}
+
+void onTendencyAlert(const TENDENCY_Result_TypeDef* tendency)
+{
+	printf("\r\nPressure tendency: characteristic %u, rate %d, %ld Pascal in 3 hours%s\r\n", tendency->characteristic,
+		tendency->rate, tendency->change / 4, tendency->stormWarning ? ", STORM WARNING" : "");
+}
+
+// Calibration commands received on the serial port since the last call
+void processSerial(void)
+{
+	int c = 0;
+
+	while ((c = RETARGET_ReadChar()) >= 0) {
+		CALIBRATION_processChar(c);
+	}
+}
+
+// Sample to the flash log selected by INTERNAL_FLASH_LOG
+void logSample(uint32_t timestamp, uint32_t pressure, int16_t temperature)
+{
+	#if INTERNAL_FLASH_LOG == 1
+		INTERNAL_LOG_append(timestamp, pressure, temperature);
+	#else
+		SAMPLE_LOG_append(timestamp, pressure, temperature);
+		SAMPLE_LOG_process();
+	#endif
+}
+
+void flushLog(void)
+{
+	#if INTERNAL_FLASH_LOG == 1
+		INTERNAL_LOG_flush();
+	#else
+		SAMPLE_LOG_flush();
+	#endif
+}
+
+// Timestamp of the newest sample of the flash log selected by INTERNAL_FLASH_LOG
+uint32_t getNewestLogTimestamp(void)
+{
+	#if INTERNAL_FLASH_LOG == 1
+		return INTERNAL_LOG_getNewestTimestamp();
+	#else
+		return SAMPLE_LOG_getNewestTimestamp();
+	#endif
+}
+
+// The clock starts at 0 after a reset: continue after the newest sample so the log stays in time order
+void continueTime(uint32_t newest)
+{
+	if(TIMESTAMP_get() <= newest) {
+		TIMESTAMP_set(newest + 1);
+	}
+}
+
+#if MPL3115A2_EVENT_MODE == 1
+void onMPL3115A2Event(uint8_t intSource)
+{
+	printf("\r\nMPL3115A2 event: 0x%02X\r\n", intSource);
+	if(intSource & MPL3115A2_INT_PTH) {
+		printf("Pressure threshold crossed\r\n");
+	}
+	if(intSource & MPL3115A2_INT_PW) {
+		printf("Pressure inside the window\r\n");
+	}
+	if(intSource & MPL3115A2_INT_TTH) {
+		printf("Temperature threshold crossed\r\n");
+	}
+	if(intSource & MPL3115A2_INT_TW) {
+		printf("Temperature inside the window\r\n");
+	}
+}
+
+void initMPL3115A2Events(void)
+{
+	// Pressure target and window registers are in 2 Pa units in Barometer mode
+	MPL3115A2_setPressureTarget(MPL3115A2_EVENT_PRESSURE_TARGET / 2);
+	MPL3115A2_setPressureWindow(MPL3115A2_EVENT_PRESSURE_WINDOW / 2);
+	MPL3115A2_setTemperatureTarget(MPL3115A2_EVENT_TEMPERATURE_TARGET);
+	MPL3115A2_setTemperatureWindow(MPL3115A2_EVENT_TEMPERATURE_WINDOW);
+	// Own period instead of the one of the first governor profile
+	MPL3115A2_setAutoAcquisitionStep(MPL3115A2_EVENT_TIME_STEP);
+	MPL3115A2_configureInterrupts(MPL3115A2_INT_PTH | MPL3115A2_INT_PW | MPL3115A2_INT_TTH | MPL3115A2_INT_TW);
+	MPL3115A2_eventInit(onMPL3115A2Event);
+}
+#endif
+
+#if MPL3115A2_DELTA_MODE == 1
+static DELTA_Detector_TypeDef pressureDetector;
+
+void onMPL3115A2Delta(uint8_t intSource)
+{
+	int32_t deltaPressure = 0;
+	int16_t deltaTemperature = 0;
+	int32_t magnitude = 0;
+	int8_t event = DELTA_EVENT_NONE;
+
+	if(intSource & MPL3115A2_INT_PCHG) {
+		MPL3115A2_readDelta(&deltaPressure, &deltaTemperature);
+		event = DELTA_update(&pressureDetector, deltaPressure);
+		if(event != DELTA_EVENT_NONE) {
+			magnitude = (deltaPressure < 0) ? -deltaPressure : deltaPressure;
+			printf("\r\nPressure %s: %ld.%02ld Pascal in the last sample\r\n", event == DELTA_EVENT_RISING ? "rising" : "falling",
+				magnitude >> 2, (magnitude % 4) * 25);
+		}
+	}
+}
+
+void initMPL3115A2Delta(void)
+{
+	DELTA_init(&pressureDetector, MPL3115A2_DELTA_THRESHOLD, MPL3115A2_DELTA_LEAK_SHIFT,
+		MPL3115A2_DELTA_CONFIRM, MPL3115A2_DELTA_HOLDOFF);
+	MPL3115A2_setAutoAcquisitionStep(MPL3115A2_DELTA_TIME_STEP);
+	MPL3115A2_configureInterrupts(MPL3115A2_INT_PCHG);
+	MPL3115A2_eventInit(onMPL3115A2Delta);
+}
+#endif
+
+#if BLE_STREAM_SEAL == 1
+// The user data page is erased (all 0xFF) until a key is flashed
+bool sealKeyProvisioned(void)
+{
+	const uint8_t* key = (const uint8_t*)SEAL_KEY_ADDRESS;
+	uint8_t i;
+
+	for(i = 0; i < SEAL_KEY_SIZE; i++) {
+		if(key[i] != 0xFF) {
+			return true;
+		}
+	}
+	return false;
+}
+#endif
+
+// Age deadline of the Pressure Stream, with BLE_MODE a soft timer calls it again while the loop sleeps
+void processStream(void)
+{
+	uint32_t nextMs = BLE_STREAM_process(TIMESTAMP_getMilliseconds());
+
+	#if BLE_MODE == 1
+		if(nextMs > 0) {
+			gecko_cmd_hardware_set_soft_timer((uint32_t)(((uint64_t)nextMs * TIMESTAMP_TICKS_PER_SECOND + 999) / 1000),
+				BLE_STREAM_TIMER, 1);
+		}
+	#else
+		(void)nextMs;
+	#endif
+}
+
+#if BLE_MODE == 1
+/**************************************************************************//**
+ * @brief  Bluetooth stack events received between the samples
+ *****************************************************************************/
+void onBleEvent(struct gecko_cmd_packet* evt)
+{
+	uint8_t connection = 0;
+	uint16_t characteristic = 0;
+	uint8_t attError = 0;
+	bool notify = false;
+	uint32_t seaLevelPressure = 0;
+	uint8_t value[4];
+
+	switch (BGLIB_MSG_ID(evt->header)) {
+		case gecko_evt_system_boot_id:
+			#if BLE_BEACON_MODE == 1
+				BLE_BEACON_start();
+			#else
+				gecko_cmd_gatt_set_max_mtu(BLE_STREAM_MAX_MTU);
+				gecko_cmd_le_gap_start_advertising(0, le_gap_general_discoverable, le_gap_connectable_scannable);
+			#endif
+			break;
+		case gecko_evt_le_connection_opened_id:
+			BLE_POLICY_onOpened(evt->data.evt_le_connection_opened.connection);
+			break;
+		case gecko_evt_le_connection_parameters_id:
+			// Parameters chosen by the central, or the answer to a request of the policy
+			BLE_POLICY_onParameters(evt->data.evt_le_connection_parameters.connection, evt->data.evt_le_connection_parameters.interval,
+				evt->data.evt_le_connection_parameters.latency, evt->data.evt_le_connection_parameters.timeout);
+			BLE_POLICY_printReport();
+			break;
+		case gecko_evt_le_connection_closed_id:
+			connection = evt->data.evt_le_connection_closed.connection;
+			BLE_POLICY_onDisconnect(connection);
+			BLE_POLICY_printReport();
+			BLE_PUBLISH_onDisconnect(connection);
+			BLE_STREAM_onDisconnect(connection);
+			#if INTERNAL_FLASH_LOG == 0
+				BLE_HISTORY_onDisconnect(connection);
+			#endif
+			gecko_cmd_le_gap_start_advertising(0, le_gap_general_discoverable, le_gap_connectable_scannable);
+			break;
+		case gecko_evt_gatt_server_characteristic_status_id:
+			if(evt->data.evt_gatt_server_characteristic_status.status_flags == gatt_server_client_config) {
+				connection = evt->data.evt_gatt_server_characteristic_status.connection;
+				characteristic = evt->data.evt_gatt_server_characteristic_status.characteristic;
+				notify = (evt->data.evt_gatt_server_characteristic_status.client_config_flags & gatt_notification) != 0;
+				BLE_PUBLISH_onSubscription(connection, characteristic, notify);
+				BLE_STREAM_onSubscription(connection, characteristic, notify);
+				#if INTERNAL_FLASH_LOG == 0
+					// Notifications of the data, indications of the control point
+					BLE_HISTORY_onSubscription(connection, characteristic,
+						evt->data.evt_gatt_server_characteristic_status.client_config_flags != 0);
+				#endif
+			}
+			break;
+		case gecko_evt_gatt_mtu_exchanged_id:
+			BLE_STREAM_onMtu(evt->data.evt_gatt_mtu_exchanged.connection, evt->data.evt_gatt_mtu_exchanged.mtu);
+			#if INTERNAL_FLASH_LOG == 0
+				BLE_HISTORY_onMtu(evt->data.evt_gatt_mtu_exchanged.connection, evt->data.evt_gatt_mtu_exchanged.mtu);
+			#endif
+			break;
+		case gecko_evt_gatt_server_user_read_request_id:
+			// The sample values are kept in the GATT database, the other type="user" ones are not readable
+			characteristic = evt->data.evt_gatt_server_user_read_request.characteristic;
+			if(characteristic == gattdb_es_sea_level_pressure) {
+				seaLevelPressure = CALIBRATION_getSeaLevelPressure();
+				value[0] = (uint8_t)seaLevelPressure;
+				value[1] = (uint8_t)(seaLevelPressure >> 8);
+				value[2] = (uint8_t)(seaLevelPressure >> 16);
+				value[3] = (uint8_t)(seaLevelPressure >> 24);
+				gecko_cmd_gatt_server_send_user_read_response(evt->data.evt_gatt_server_user_read_request.connection,
+					characteristic, 0, sizeof(value), value);
+			}
+			else {
+				gecko_cmd_gatt_server_send_user_read_response(evt->data.evt_gatt_server_user_read_request.connection,
+					characteristic, (uint8_t)bg_err_att_read_not_permitted, 0, NULL);
+			}
+			break;
+		case gecko_evt_gatt_server_user_write_request_id:
+			characteristic = evt->data.evt_gatt_server_user_write_request.characteristic;
+			attError = (uint8_t)bg_err_att_write_not_permitted;
+			if(characteristic == gattdb_es_sea_level_pressure) {
+				// Same range check as the P command of the serial port
+				if(evt->data.evt_gatt_server_user_write_request.value.len != sizeof(value)) {
+					attError = (uint8_t)bg_err_att_invalid_att_length;
+				}
+				else {
+					memcpy(value, evt->data.evt_gatt_server_user_write_request.value.data, sizeof(value));
+					seaLevelPressure = value[0] | ((uint32_t)value[1] << 8) | ((uint32_t)value[2] << 16) | ((uint32_t)value[3] << 24);
+					attError = (CALIBRATION_setReferencePressure(seaLevelPressure) == 0) ? 0 : (uint8_t)bg_err_att_value_not_allowed;
+				}
+			}
+			#if INTERNAL_FLASH_LOG == 0
+				if(characteristic == gattdb_hist_control_point) {
+					// The result is indicated on the control point, the write itself always succeeds
+					BLE_HISTORY_onControl(evt->data.evt_gatt_server_user_write_request.connection,
+						evt->data.evt_gatt_server_user_write_request.value.data, evt->data.evt_gatt_server_user_write_request.value.len);
+					attError = 0;
+				}
+			#endif
+			// A write request waits for the response, a write command has none
+			if(evt->data.evt_gatt_server_user_write_request.att_opcode == gatt_write_request) {
+				gecko_cmd_gatt_server_send_user_write_response(evt->data.evt_gatt_server_user_write_request.connection,
+					characteristic, attError);
+			}
+			break;
+		default:
+			break;
+	}
+	#if INTERNAL_FLASH_LOG == 0
+		// History download: the acknowledgements open the window, a full stack queue is tried again on a timer
+		if(BLE_HISTORY_process()) {
+			gecko_cmd_hardware_set_soft_timer(BLE_RETRY_TICKS, BLE_RETRY_TIMER, 1);
+		}
+	#endif
+	// Also on the BLE_STREAM_TIMER event: the deadline of a stream packet passed during a wait
+	processStream();
+}
+#endif
+
+// Wait in EM2, the Bluetooth stack is served meanwhile
+static void waitMs(uint32_t ms)
+{
+	if(ms == 0) {
+		return;
+	}
+	#if BLE_MODE == 1
+		BLE_GECKO_wait(ms, onBleEvent);
+	#else
+		UTIL_delay(ms);
+	#endif
+}
+
+// Wait between the samples. A page program of the sample log is followed in 1 ms
+// steps, so the flash is in deep power-down right after it and not only at the next sample.
+static void waitInterval(uint32_t ms)
+{
+	#if INTERNAL_FLASH_LOG == 0
+		while((ms > 0) && SAMPLE_LOG_process()) {
+			waitMs(1);
+			ms--;
+		}
+	#endif
+	waitMs(ms);
+}
+
 int main(void)
 {
 	/**************************************************************************/
@@ -101,6 +557,22 @@ int main(void)
 	/**************************************************************************/
 	uint8_t status = 1;
 	int32_t altitude = 0;
+	int32_t altitudeCm = 0;
+	uint32_t intervalMs = MEASUREMENT_INTERVAL_MS;
+	GOVERNOR_TypeDef governor;
+	const GOVERNOR_Profile_TypeDef* profiles = NULL;
+	uint8_t profileCount = 0;
+	uint8_t recovered = 0;
+	uint32_t clockSeconds = 0;
+	uint32_t clockCounter = 0;
+	bool warmBoot = false;
+	static ROLLING_STATS_TypeDef minuteStats;
+	static ROLLING_STATS_TypeDef hourStats;
+	uint16_t summarySamples = 0;
+	VARIO_Filter_TypeDef vario;
+	int32_t filteredAltitude = 0;
+	int32_t verticalSpeed = 0;
+	int32_t verticalSpeedCm = 0;
 	int16_t temperature = 0;
 	uint32_t pressure = 0;
 
@@ -115,28 +587,229 @@ int main(void)
 	initModule();
 
 	/**************************************************************************/
-	/* I2C peripheral init                                                    */
+	/* Warm boot check: EM4 wakeup with a retained sensor configuration       */
 	/**************************************************************************/
-	printf("initI2C...\r\n");
-	initI2C();
-	printf("initI2C: DONE\r\n");
+	CRC_init();
+	warmBoot = WARM_BOOT_begin(SENSOR_CONFIG_ID);
 
 	/**************************************************************************/
-	/* MPL3115A2 init                                                         */
+	/* I2C peripheral init                                                    */
 	/**************************************************************************/
-	printf("initMPL3115A2...\r\n");
-	status = initMPL3115A2();
-	printf("initMPL3115A2: %s\r\n", status == 0 ? "DONE" : "FAILED");
+	if(!warmBoot) {
+		printf("initI2C...\r\n");
+	}
+	initI2C(!warmBoot);
+	if(warmBoot) {
+		// One CTRL_REG1 read instead of the identification and the configuration
+		warmBoot = WARM_BOOT_confirm();
+	}
 
-	/**************************************************************************/
-	/* Set the mode of the MPL3115A2 sensor                                   */
-	/**************************************************************************/
-	#if MPL3115A2_ALTIMETER_MODE == 1
-		printf("Set the MPL3115A2 sensor to Altimeter mode\r\n");
-		MPL3115A2_setAltimeterMode();
+	if(warmBoot) {
+		status = 0;
+	}
+	else {
+		printf("initI2C: DONE\r\n");
+		printf("CRC: %s\r\n", CRC_isHardware() ? "GPCRC" : "software");
+
+		/**********************************************************************/
+		/* MPL3115A2 init                                                     */
+		/**********************************************************************/
+		printf("initMPL3115A2...\r\n");
+		status = initMPL3115A2();
+		printf("initMPL3115A2: %s\r\n", status == 0 ? "DONE" : "FAILED");
+
+		/**********************************************************************/
+		/* Set the mode of the MPL3115A2 sensor                               */
+		/**********************************************************************/
+		#if MPL3115A2_ALTIMETER_MODE == 1
+			printf("Set the MPL3115A2 sensor to Altimeter mode\r\n");
+			MPL3115A2_setAltimeterMode();
+		#else
+			printf("Set the MPL3115A2 sensor to Barometer mode\r\n");
+			MPL3115A2_setBarometerMode();
+		#endif
+	}
+	// Altitude, calibration and governor tables of the RFS image (rfs_data.c), checked with CRC-32
+	TABLES_init(!warmBoot);
+	if(warmBoot) {
+		CALIBRATION_initWarm();
+	}
+	else {
+		CALIBRATION_init(MPL3115A2_SEA_LEVEL_PRESSURE);
+	}
+	#if MPL3115A2_ALTIMETER_MODE == 0
+		profiles = TABLES_getGovernorProfiles(&profileCount);
+		if(profiles == NULL) {
+			profiles = governorProfiles;
+			profileCount = sizeof(governorProfiles) / sizeof(governorProfiles[0]);
+		}
+		GOVERNOR_init(&governor, profiles, profileCount, GOVERNOR_DWELL_SAMPLES);
+		if(!warmBoot) {
+			MPL3115A2_setOversampleRatio(GOVERNOR_getProfile(&governor)->oversampleShift);
+			MPL3115A2_setAutoAcquisitionStep(GOVERNOR_getProfile(&governor)->timeStep);
+		}
+		intervalMs = GOVERNOR_getIntervalMs(&governor);
+	#endif
+	VARIO_init(&vario, VARIO_ALPHA, VARIO_BETA, intervalMs);
+	ROLLING_STATS_init(&minuteStats, minuteSlots, PRESSURE_STATS_MINUTE_SAMPLES);
+	ROLLING_STATS_init(&hourStats, hourSlots, PRESSURE_STATS_HOUR_SAMPLES);
+	ROLLUP_init();
+	ROLLUP_setCloseCallback(onRollupClose);
+	TENDENCY_init(onTendencyAlert);
+	#if INTERNAL_FLASH_LOG == 1
+		INTERNAL_LOG_init();
 	#else
-		printf("Set the MPL3115A2 sensor to Barometer mode\r\n");
-		MPL3115A2_setBarometerMode();
+		// Raw sample log on the SPI flash. MX25_init() waits for the first flush or read like the
+		// mount, an EM4 wakeup that only appends to the RAM page does not set up USART2 and LDMA.
+		SAMPLE_LOG_init(&MX25_flashDevice, 0, MX25_FLASH_SIZE);
+	#endif
+	// Samples buffered before an EM4 Hibernate or a reset are not lost
+	recovered = RETAINED_init(&RTCC->RET[0].REG);
+	#if EM4_BURST_MODE == 0
+		if(recovered > 0) {
+			printf("Recovered %u samples of the retention registers\r\n", recovered);
+			RETAINED_drain(logSample);
+			flushLog();
+		}
+	#endif
+	// The clock continues across EM4 Hibernate with the RTCC, after other resets it continues
+	// after the newest sample: the log is mounted for it
+	if(RETAINED_takeClock(&clockSeconds, &clockCounter)) {
+		TIMESTAMP_setState(clockSeconds, clockCounter);
+	}
+	else {
+		continueTime(getNewestLogTimestamp());
+		continueTime(RETAINED_getNewestTimestamp());
+	}
+
+	#if EM4_BURST_MODE == 1
+		/**********************************************************************/
+		/* Burst: one sample per wakeup, the flash is written once per ring   */
+		/**********************************************************************/
+		printf("EM4 burst: %u samples in the retention registers\r\n", recovered);
+		MPL3115A2_measureOneShot(&pressure, &temperature);
+		pressure = TABLES_correctPressure(pressure);
+		if(!RETAINED_push(TIMESTAMP_get(), pressure, temperature)) {
+			RETAINED_drain(logSample);
+			flushLog();
+			RETAINED_push(TIMESTAMP_get(), pressure, temperature);
+		}
+		#if INTERNAL_FLASH_LOG == 0
+			MX25_powerDown(); // Waits for the page program
+		#endif
+		if(status == 0) {
+			WARM_BOOT_save(SENSOR_CONFIG_ID);
+		}
+		TIMESTAMP_getState(&clockSeconds, &clockCounter);
+		RETAINED_saveClock(clockSeconds, clockCounter);
+		RETAINED_hibernate(EM4_BURST_INTERVAL_S);
+	#endif
+
+	#if BLE_MODE == 1
+		/**********************************************************************/
+		/* Bluetooth: live samples and the history download                  */
+		/**********************************************************************/
+		printf("BLE init: %s\r\n", BLE_GECKO_init() == 0 ? "DONE" : "FAILED");
+		BLE_PUBLISH_init(&BLE_GECKO_stack, gattdb_es_pressure, gattdb_es_temperature, BLE_PRESSURE_DEADBAND, BLE_TEMPERATURE_DEADBAND);
+		#if BLE_STREAM_SEAL == 1
+			if(sealKeyProvisioned()) {
+				SEAL_init((const uint8_t*)SEAL_KEY_ADDRESS);
+				BLE_STREAM_init(&BLE_GECKO_stack, gattdb_ps_stream, BLE_STREAM_MAX_AGE_MS);
+				BLE_STREAM_enableSeal(DEVINFO->UNIQUEL, BLE_GECKO_random);
+				printf("Pressure Stream sealed with %s AES\r\n", SEAL_isHardware() ? "CRYPTO" : "software");
+			}
+			else {
+				printf("Pressure Stream off: no key in the user data page\r\n");
+			}
+		#else
+			BLE_STREAM_init(&BLE_GECKO_stack, gattdb_ps_stream, BLE_STREAM_MAX_AGE_MS);
+		#endif
+		#if INTERNAL_FLASH_LOG == 0
+			BLE_HISTORY_init(&BLE_GECKO_stack, gattdb_hist_control_point, gattdb_hist_data);
+		#endif
+		// Connection parameters matched to the notification period, at most the stream age apart
+		BLE_POLICY_init(&BLE_GECKO_stack, TIMESTAMP_getMilliseconds, BLE_STREAM_MAX_AGE_MS);
+		#if BLE_BEACON_MODE == 1 && PRESSURE_FILTER_MODE == 1
+			BLE_BEACON_init(&BLE_GECKO_stack, BLE_BEACON_REPEATS, PRESSURE_FILTER_INTERVAL_MS * PRESSURE_FILTER_DECIMATION);
+		#elif BLE_BEACON_MODE == 1
+			BLE_BEACON_init(&BLE_GECKO_stack, BLE_BEACON_REPEATS, intervalMs);
+		#endif
+	#endif
+
+	#if PRESSURE_FILTER_MODE == 1
+		/**********************************************************************/
+		/* Filter loop: median, decimator and IIR over fast one-shot samples  */
+		/**********************************************************************/
+		#if (4 << PRESSURE_FILTER_OSR_SHIFT) + 2 >= PRESSURE_FILTER_INTERVAL_MS
+			#error "The one-shot conversion does not fit in PRESSURE_FILTER_INTERVAL_MS"
+		#endif
+		FILTER_Pipeline_TypeDef pressureFilter;
+		int32_t filteredPressure = 0;
+		uint32_t nextSampleMs = 0;
+		uint32_t nowMs = 0;
+
+		printf("Set up the pressure filter pipeline\r\n");
+		FILTER_pipelineInit(&pressureFilter, true, PRESSURE_FILTER_DECIMATION, PRESSURE_FILTER_IIR_SHIFT);
+		MPL3115A2_setOversampleRatio(PRESSURE_FILTER_OSR_SHIFT);
+		nextSampleMs = TIMESTAMP_getMilliseconds();
+		while (1) {
+			MPL3115A2_measureOneShot(&pressure, &temperature);
+			if(FILTER_pipelinePush(&pressureFilter, (int32_t)pressure, &filteredPressure)) {
+				// The per-unit curve is smooth, it is applied once per output instead of per raw sample
+				filteredPressure = (int32_t)TABLES_correctPressure((uint32_t)filteredPressure);
+				printf("Pressure (filtered): %ld.%02ld Pascal\r\n", filteredPressure >> 2, (filteredPressure % 4) * 25);
+				BLE_STREAM_push(TIMESTAMP_getMilliseconds(), (uint32_t)filteredPressure, temperature);
+				#if BLE_BEACON_MODE == 1
+					BLE_BEACON_update((uint32_t)filteredPressure, temperature);
+				#endif
+				BLE_POLICY_setProduction(PRESSURE_FILTER_INTERVAL_MS * PRESSURE_FILTER_DECIMATION, BLE_STREAM_getBatchSize());
+			}
+			processStream();
+			processSerial();
+			// The period starts at the previous conversion, so the conversion and the I2C time are
+			// inside PRESSURE_FILTER_INTERVAL_MS and the output rate is the one given to BLE
+			nextSampleMs += PRESSURE_FILTER_INTERVAL_MS;
+			nowMs = TIMESTAMP_getMilliseconds();
+			if((int32_t)(nextSampleMs - nowMs) > 0) {
+				waitInterval(nextSampleMs - nowMs);
+			}
+			else {
+				nextSampleMs = nowMs; // Late (e.g. a long print), no catching up with a burst
+			}
+		}
+	#endif
+
+	#if MPL3115A2_EVENT_MODE == 1 || MPL3115A2_DELTA_MODE == 1
+		/**********************************************************************/
+		/* Event loop: sleep until the sensor signals on INT1                 */
+		/**********************************************************************/
+		#if MPL3115A2_DELTA_MODE == 1
+			printf("Set up the MPL3115A2 pressure change interrupt\r\n");
+			initMPL3115A2Delta();
+		#else
+			printf("Set up the MPL3115A2 threshold and window interrupts\r\n");
+			initMPL3115A2Events();
+		#endif
+		#if BLE_MODE == 1
+			// The stack owns the sleep, INT1 wakes it with an external signal
+			MPL3115A2_eventSetWakeup(BLE_GECKO_wakeup);
+		#endif
+		while (1) {
+			#if BLE_MODE == 1
+				if(!MPL3115A2_eventPending()) {
+					BLE_GECKO_waitWakeup(onBleEvent);
+				}
+			#else
+				// The pending flag is checked with interrupts masked, so an INT1 edge cannot be lost before sleeping
+				__disable_irq();
+				if(!MPL3115A2_eventPending()) {
+					EMU_EnterEM2(true);
+				}
+				__enable_irq();
+			#endif
+			MPL3115A2_eventProcess();
+			processSerial();
+		}
 	#endif
 
 	/**************************************************************************/
@@ -148,15 +821,65 @@ int main(void)
 			MPL3115A2_measureAltitudeAndTemperature(&altitude, &temperature);
 		#else
 			MPL3115A2_measurePressureAndTemperature(&pressure, &temperature);
+			pressure = TABLES_correctPressure(pressure);
 		#endif
 		#if MPL3115A2_ALTIMETER_MODE == 1
 			printf("Altimeter mode:\r\n");
 			printf("Altitude: %ld.%ld meter\r\n", altitude >> 16, altitude % 65536);
 		#else
 			printf("Pressure: %lu.%lu Pascal\r\n", pressure >> 2, pressure % 2);
+			// The same sample gives the altitude, no need to switch to Altimeter mode
+			CALIBRATION_onSample(pressure);
+			// Summary of the last window instead of the raw samples
+			ROLLING_STATS_push(&minuteStats, (int32_t)pressure);
+			ROLLING_STATS_push(&hourStats, (int32_t)pressure);
+			// Minute/hour/day history
+			ROLLUP_push(TIMESTAMP_get(), (int32_t)pressure);
+			// Raw samples, the flash is written once per page (block)
+			logSample(TIMESTAMP_get(), pressure, temperature);
+			// Notified only to subscribers and only beyond the deadbands
+			BLE_PUBLISH_update(pressure, temperature);
+			// Batched into MTU sized notifications
+			BLE_STREAM_push(TIMESTAMP_getMilliseconds(), pressure, temperature);
+			processStream();
+			#if BLE_BEACON_MODE == 1
+				BLE_BEACON_update(pressure, temperature);
+			#endif
+			// Follows the governor profile and the samples per stream notification
+			BLE_POLICY_setProduction(intervalMs, BLE_STREAM_getBatchSize());
+			// Once per window, the hour is a multiple of the minute
+			summarySamples++;
+			if((summarySamples % PRESSURE_STATS_MINUTE_SAMPLES) == 0) {
+				reportSummary("minute", 0, &minuteStats);
+			}
+			if(summarySamples == PRESSURE_STATS_HOUR_SAMPLES) {
+				summarySamples = 0;
+				reportSummary("hour", 1, &hourStats);
+			}
+			altitude = ALTITUDE_fromPressure(pressure);
+			altitudeCm = (int32_t)(((int64_t)altitude * 100) >> 16);
+			printf("Altitude (computed): %ld.%02ld meter\r\n", altitudeCm / 100, labs(altitudeCm % 100));
+		#endif
+		VARIO_update(&vario, altitude, &filteredAltitude, &verticalSpeed);
+		verticalSpeedCm = (int32_t)(((int64_t)verticalSpeed * 100) >> 16);
+		printf("Vertical speed: %s%ld.%02ld m/s\r\n", verticalSpeedCm < 0 ? "-" : "", labs(verticalSpeedCm) / 100, labs(verticalSpeedCm) % 100);
+		#if MPL3115A2_ALTIMETER_MODE == 0
+			// Faster sampling while the pressure moves, slower when it is calm
+			if(GOVERNOR_update(&governor, pressure)) {
+				MPL3115A2_setOversampleRatio(GOVERNOR_getProfile(&governor)->oversampleShift);
+				MPL3115A2_setAutoAcquisitionStep(GOVERNOR_getProfile(&governor)->timeStep);
+				intervalMs = GOVERNOR_getIntervalMs(&governor);
+				VARIO_setInterval(&vario, intervalMs);
+				#if BLE_BEACON_MODE == 1
+					BLE_BEACON_setSampleInterval(intervalMs);
+				#endif
+				printf("Sampling profile changed, every %lu ms\r\n", intervalMs);
+				GOVERNOR_printReport(&governor);
+			}
 		#endif
 		printf("Temperature: %d.%d C\r\n", temperature >> 4, temperature % 16);
 		printf("---------------\r\n");
-		UTIL_delay(3000);
+		processSerial();
+		waitInterval(intervalMs);
 	}
 }
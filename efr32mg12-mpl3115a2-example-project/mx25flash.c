@@ -0,0 +1,243 @@
+/***************************************************************************//**
+ * @file
+ * @brief mx25flash.c
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "em_cmu.h"
+#include "em_gpio.h"
+#include "em_usart.h"
+#include "em_emu.h"
+#include "em_core.h"
+#include "dmadrv.h"
+#include "mx25flash_config.h"
+
+#include "thunderboard/util.h"
+
+#include "mx25flash.h"
+
+const FLASH_DEVICE_TypeDef MX25_flashDevice = {
+	MX25_FLASH_SIZE,
+	MX25_powerUp,
+	MX25_powerDown,
+	MX25_read,
+	MX25_programPage,
+	MX25_eraseSector,
+	MX25_busy,
+};
+
+static unsigned int txChannel = 0;
+static unsigned int rxChannel = 0;
+static volatile bool dmaActive = false; // Data phase of a read or page program in progress
+static bool programActive = false;      // Page program started, WIP not checked yet
+static uint8_t dummyTx = 0xFF;          // Clocked out during reads
+static uint8_t dummyRx = 0;             // Sink of the bytes received during a page program
+static bool initialized = false;        // USART2 and the DMA channels are set up
+
+static void MX25_select(void)
+{
+	GPIO_PinOutClear(MX25_PORT_CS, MX25_PIN_CS);
+}
+
+static void MX25_deselect(void)
+{
+	GPIO_PinOutSet(MX25_PORT_CS, MX25_PIN_CS);
+}
+
+// Command with a 24 bit address, chip select is left low for the data phase
+static void MX25_sendCommand(uint8_t command, uint32_t address)
+{
+	MX25_select();
+	USART_SpiTransfer(MX25_USART, command);
+	USART_SpiTransfer(MX25_USART, (uint8_t)(address >> 16));
+	USART_SpiTransfer(MX25_USART, (uint8_t)(address >> 8));
+	USART_SpiTransfer(MX25_USART, (uint8_t)(address));
+}
+
+static void MX25_writeEnable(void)
+{
+	MX25_select();
+	USART_SpiTransfer(MX25_USART, MX25_CMD_WRITE_ENABLE);
+	MX25_deselect();
+}
+
+// Wait for the end of a program or erase operation
+static void MX25_waitReady(void)
+{
+	uint8_t status = 0;
+
+	MX25_select();
+	USART_SpiTransfer(MX25_USART, MX25_CMD_READ_STATUS);
+	do {
+		status = USART_SpiTransfer(MX25_USART, 0xFF);
+	} while(status & MX25_STATUS_WIP);
+	MX25_deselect();
+}
+
+// The last byte is received after it was sent: the RX channel ends the transfer
+static bool MX25_dmaDone(unsigned int channel, unsigned int sequenceNo, void* userParam)
+{
+	(void)channel;
+	(void)sequenceNo;
+	(void)userParam;
+	MX25_deselect();
+	dmaActive = false;
+	return true;
+}
+
+// Data phase over LDMA, chip select goes high in the RX completion interrupt
+static void MX25_startTransfer(uint8_t* rxData, const uint8_t* txData, uint32_t length)
+{
+	dmaActive = true;
+	DMADRV_PeripheralMemory(rxChannel, MX25_DMA_SIGNAL_RX, (rxData != NULL) ? rxData : &dummyRx,
+		(void*)&MX25_USART->RXDATA, rxData != NULL, (int)length, dmadrvDataSize1, MX25_dmaDone, NULL);
+	DMADRV_MemoryPeripheral(txChannel, MX25_DMA_SIGNAL_TX, (void*)&MX25_USART->TXDATA,
+		(txData != NULL) ? (void*)txData : &dummyTx, txData != NULL, (int)length, dmadrvDataSize1, NULL, NULL);
+}
+
+// Sleep in EM1 until the DMA transfer ends
+static void MX25_waitTransfer(void)
+{
+	CORE_DECLARE_IRQ_STATE;
+
+	CORE_ENTER_CRITICAL();
+	while(dmaActive) {
+		EMU_EnterEM1(); // Wakes up on the pending interrupt even with IRQs masked
+		CORE_EXIT_CRITICAL();
+		CORE_ENTER_CRITICAL();
+	}
+	CORE_EXIT_CRITICAL();
+}
+
+// Wait for the page program started by MX25_programPage()
+static void MX25_waitProgram(void)
+{
+	MX25_waitTransfer();
+	if(programActive) {
+		MX25_waitReady();
+		programActive = false;
+	}
+}
+
+// Set up USART2 for SPI (same settings as the BSP) and put the flash in deep power-down.
+// Called by the first MX25_powerUp(), so a boot that does not touch the flash skips it.
+void MX25_init(void)
+{
+	USART_InitSync_TypeDef init = USART_INITSYNC_DEFAULT;
+
+	initialized = true;
+	CMU_ClockEnable(cmuClock_GPIO, true);
+	CMU_ClockEnable(MX25_USART_CLK, true);
+
+	GPIO_PinModeSet(MX25_PORT_MOSI, MX25_PIN_MOSI, gpioModePushPull, 1);
+	GPIO_PinModeSet(MX25_PORT_MISO, MX25_PIN_MISO, gpioModeInput, 0);
+	GPIO_PinModeSet(MX25_PORT_SCLK, MX25_PIN_SCLK, gpioModePushPull, 1);
+	GPIO_PinModeSet(MX25_PORT_CS, MX25_PIN_CS, gpioModePushPull, 1);
+
+	init.msbf     = true;
+	init.baudrate = 8000000;
+	USART_InitSync(MX25_USART, &init);
+
+	MX25_USART->ROUTELOC0 = (MX25_USART_LOC_MISO | MX25_USART_LOC_MOSI | MX25_USART_LOC_SCLK);
+	MX25_USART->ROUTEPEN  = (USART_ROUTEPEN_RXPEN | USART_ROUTEPEN_TXPEN | USART_ROUTEPEN_CLKPEN);
+
+	DMADRV_Init(); // ECODE_EMDRV_DMADRV_ALREADY_INITIALIZED is fine
+	DMADRV_AllocateChannel(&txChannel, NULL);
+	DMADRV_AllocateChannel(&rxChannel, NULL);
+
+	/* The flash may be in deep power-down already (BOARD_flashDeepPowerDown) */
+	MX25_powerUp();
+	MX25_powerDown();
+}
+
+void MX25_powerUp(void)
+{
+	if(!initialized) {
+		MX25_init();
+	}
+	MX25_waitProgram();
+	MX25_select();
+	USART_SpiTransfer(MX25_USART, MX25_CMD_RELEASE_POWER_DOWN);
+	MX25_deselect();
+	// tRES1 is 35 us
+	UTIL_delay(1);
+}
+
+// Nothing to do before the first MX25_powerUp(): BOARD_init() leaves the flash in deep power-down
+void MX25_powerDown(void)
+{
+	if(!initialized) {
+		return;
+	}
+	MX25_waitProgram();
+	MX25_select();
+	USART_SpiTransfer(MX25_USART, MX25_CMD_DEEP_POWER_DOWN);
+	MX25_deselect();
+}
+
+// Short reads (page headers) are cheaper on the CPU than setting up the DMA
+void MX25_read(uint32_t address, uint8_t* data, uint32_t length)
+{
+	uint32_t i;
+	uint32_t chunk;
+
+	MX25_waitProgram();
+	if(length < MX25_DMA_MIN_LENGTH) {
+		MX25_sendCommand(MX25_CMD_READ, address);
+		for(i = 0; i < length; i++) {
+			data[i] = USART_SpiTransfer(MX25_USART, 0xFF);
+		}
+		MX25_deselect();
+		return;
+	}
+	/* One read command per DMA transfer, chip select goes high at the end of each */
+	while(length > 0) {
+		chunk = (length > DMADRV_MAX_XFER_COUNT) ? DMADRV_MAX_XFER_COUNT : length;
+		MX25_sendCommand(MX25_CMD_READ, address);
+		MX25_startTransfer(data, NULL, chunk);
+		MX25_waitTransfer();
+		address += chunk;
+		data += chunk;
+		length -= chunk;
+	}
+}
+
+// Start programming up to one page (not crossing a page boundary) and return,
+// data has to stay valid until MX25_busy() returns false
+void MX25_programPage(uint32_t address, const uint8_t* data, uint32_t length)
+{
+	MX25_waitProgram();
+	MX25_writeEnable();
+	MX25_sendCommand(MX25_CMD_PAGE_PROGRAM, address);
+	programActive = true;
+	MX25_startTransfer(NULL, data, length);
+}
+
+// True while the page program runs, checks the flash status once without blocking
+bool MX25_busy(void)
+{
+	uint8_t status = 0;
+
+	if(dmaActive) {
+		return true;
+	}
+	if(programActive) {
+		MX25_select();
+		USART_SpiTransfer(MX25_USART, MX25_CMD_READ_STATUS);
+		status = USART_SpiTransfer(MX25_USART, 0xFF);
+		MX25_deselect();
+		programActive = (status & MX25_STATUS_WIP) != 0;
+	}
+	return programActive;
+}
+
+void MX25_eraseSector(uint32_t address)
+{
+	MX25_waitProgram();
+	MX25_writeEnable();
+	MX25_sendCommand(MX25_CMD_SECTOR_ERASE, address);
+	MX25_deselect();
+	MX25_waitReady();
+}
@@ -0,0 +1,48 @@
+/***************************************************************************//**
+ * @file
+ * @brief mx25flash.h
+ ******************************************************************************/
+
+#ifndef MX25FLASH_H
+#define MX25FLASH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "flash_device.h"
+
+/*
+ * Macronix MX25R8035F SPI flash of the Thunderboard Sense 2 (USART2, pins in
+ * mx25flash_config.h). The chip is kept in deep power-down between operations.
+ * Page programs and long reads move the data with LDMA (DMADRV): a page
+ * program returns after the command bytes and ends in the DMA interrupt.
+ * The peripherals are set up on the first MX25_powerUp(), MX25_init() needs
+ * no separate call.
+ */
+
+#define MX25_FLASH_SIZE       (1024UL * 1024UL) // 8 Mbit
+
+#define MX25_CMD_WRITE_ENABLE (0x06)
+#define MX25_CMD_READ_STATUS  (0x05)
+#define MX25_CMD_READ         (0x03)
+#define MX25_CMD_PAGE_PROGRAM (0x02)
+#define MX25_CMD_SECTOR_ERASE (0x20)
+#define MX25_CMD_DEEP_POWER_DOWN (0xB9)
+#define MX25_CMD_RELEASE_POWER_DOWN (0xAB)
+#define MX25_STATUS_WIP       (0x01) // Write in progress
+
+#define MX25_DMA_SIGNAL_TX    dmadrvPeripheralSignal_USART2_TXBL
+#define MX25_DMA_SIGNAL_RX    dmadrvPeripheralSignal_USART2_RXDATAV
+#define MX25_DMA_MIN_LENGTH   (32) // Shorter reads are done by the CPU
+
+extern const FLASH_DEVICE_TypeDef MX25_flashDevice;
+
+void MX25_init(void);
+void MX25_powerUp(void);
+void MX25_powerDown(void);
+void MX25_read(uint32_t address, uint8_t* data, uint32_t length);
+void MX25_programPage(uint32_t address, const uint8_t* data, uint32_t length);
+void MX25_eraseSector(uint32_t address);
+bool MX25_busy(void);
+
+#endif // MX25FLASH_H
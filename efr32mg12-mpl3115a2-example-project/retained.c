@@ -0,0 +1,196 @@
+/***************************************************************************//**
+ * @file
+ * @brief retained.c
+ ******************************************************************************/
+
+#include <stddef.h>
+
+#if !defined(RETAINED_SOFTWARE_ONLY)
+#include "em_device.h"
+#include "em_emu.h"
+#include "em_gpio.h"
+#include "em_rtcc.h"
+
+#include "thunderboard/board.h"
+#endif
+
+#include "crc.h"
+#include "sample_log.h"
+#include "timestamp.h"
+#include "retained.h"
+
+#define RETAINED_HEADER(sequence, count) (((uint32_t)RETAINED_MAGIC << 24) | ((uint32_t)(sequence) << 8) | (count))
+#define RETAINED_CLOCK_SAVED             (0x80) // Header bit of a saved clock
+#define RETAINED_WAKEUP_CHANNEL          (1) // RTCC compare channel of the EM4 wakeup
+
+static volatile uint32_t* words = NULL; // RET[0..31]
+static uint8_t count = 0;               // Samples in the ring
+static uint16_t sequence = 0;           // Drains so far
+static bool clockSaved = false;         // RET[29..30] hold the clock
+
+// CRC-32 of the ring with RET[1] taken as 0
+static uint32_t RETAINED_crc(void)
+{
+	uint32_t ring[RETAINED_WARM_BOOT_WORD];
+	uint8_t i;
+
+	for(i = 0; i < RETAINED_WARM_BOOT_WORD; i++) {
+		ring[i] = words[i];
+	}
+	ring[1] = 0;
+	return CRC_crc32(ring, sizeof(ring));
+}
+
+static void RETAINED_commit(void)
+{
+	words[0] = RETAINED_HEADER(sequence, count) | (clockSaved ? RETAINED_CLOCK_SAVED : 0);
+	words[1] = RETAINED_crc();
+}
+
+// Check the ring after a reset, returns the surviving samples (0 after a power-on or a corrupted ring).
+// retention: the 32 retention registers, &RTCC->RET[0].REG. Call it after CRC_init().
+uint8_t RETAINED_init(volatile uint32_t* retention)
+{
+	uint32_t header = retention[0];
+
+	words = retention;
+
+	count = (uint8_t)(header & ~RETAINED_CLOCK_SAVED);
+	sequence = (uint16_t)(header >> 8);
+	clockSaved = ((header & RETAINED_CLOCK_SAVED) != 0);
+	if(((header >> 24) != RETAINED_MAGIC) || (count > RETAINED_CAPACITY) || (words[1] != RETAINED_crc())) {
+		count = 0;
+		sequence = 0;
+		clockSaved = false;
+		RETAINED_commit();
+	}
+	return count;
+}
+
+// Store a sample, returns false if the ring is full or the timestamp is more than RETAINED_TOLERANCE_S
+// off the interval: drain the ring and push it again
+bool RETAINED_push(uint32_t timestamp, uint32_t pressure, int16_t temperature)
+{
+	int32_t error = 0;
+
+	if(count == RETAINED_CAPACITY) {
+		return false;
+	}
+	if(count == 0) {
+		words[2] = timestamp;
+		words[3] = 0;
+	}
+	else if(count == 1) {
+		words[3] = timestamp - words[2];
+	}
+	else {
+		error = (int32_t)(timestamp - (words[2] + count * words[3])); // Wraps correctly
+		if((error < -RETAINED_TOLERANCE_S) || (error > RETAINED_TOLERANCE_S)) {
+			return false;
+		}
+	}
+	words[RETAINED_FIRST_WORD + count] = SAMPLE_LOG_PACK(pressure, temperature);
+	count++;
+	RETAINED_commit();
+	return true;
+}
+
+// Hand the samples over (to the flash log) and empty the ring, returns the number of samples
+uint8_t RETAINED_drain(RETAINED_Sink sink)
+{
+	uint32_t data = 0;
+	uint8_t drained = count;
+	uint8_t i;
+
+	for(i = 0; i < count; i++) {
+		data = words[RETAINED_FIRST_WORD + i];
+		sink(words[2] + i * words[3], SAMPLE_LOG_PRESSURE(data), SAMPLE_LOG_TEMPERATURE(data));
+	}
+	if(drained > 0) {
+		count = 0;
+		sequence++;
+		RETAINED_commit();
+	}
+	return drained;
+}
+
+uint8_t RETAINED_getCount(void)
+{
+	return count;
+}
+
+uint16_t RETAINED_getSequence(void)
+{
+	return sequence;
+}
+
+// Timestamp of the newest sample in the ring, 0 if it is empty
+uint32_t RETAINED_getNewestTimestamp(void)
+{
+	return (count > 0) ? words[2] + (count - 1) * words[3] : 0;
+}
+
+// Keep the clock (TIMESTAMP_getState) for the next boot, call it right before EM4 Hibernate
+void RETAINED_saveClock(uint32_t seconds, uint32_t counter)
+{
+	words[RETAINED_CLOCK_WORD] = seconds;
+	words[RETAINED_CLOCK_WORD + 1] = counter;
+	clockSaved = true;
+	RETAINED_commit();
+}
+
+// Clock saved before the EM4 Hibernate, returns false after any other reset. It is taken
+// only once: the RTCC of a later reset may not have kept counting.
+bool RETAINED_takeClock(uint32_t* seconds, uint32_t* counter)
+{
+	if(!clockSaved) {
+		return false;
+	}
+	*seconds = words[RETAINED_CLOCK_WORD];
+	*counter = words[RETAINED_CLOCK_WORD + 1];
+	clockSaved = false;
+	RETAINED_commit();
+	return true;
+}
+
+// Next wakeup on the grid: the previous one plus interval, or now plus interval if that is not
+// in (now, now + interval] (first call, button wakeup). All in RTCC ticks, wraps correctly.
+uint32_t RETAINED_nextWakeup(uint32_t previous, uint32_t now, uint32_t interval)
+{
+	uint32_t wakeup = previous + interval;
+
+	if((wakeup - now - 1) >= interval) {
+		wakeup = now + interval;
+	}
+	return wakeup;
+}
+
+#if !defined(RETAINED_SOFTWARE_ONLY)
+// EM4 Hibernate until the RTCC reaches the wakeup time (or button 0 is pressed), the
+// RTCC keeps counting and the retention registers are kept. It wakes up through a reset.
+// The compare register survives the reset too, it holds the previous wakeup of the grid.
+void RETAINED_hibernate(uint32_t seconds)
+{
+	EMU_EM4Init_TypeDef em4Init = EMU_EM4INIT_DEFAULT;
+	RTCC_CCChConf_TypeDef compare = RTCC_CH_INIT_COMPARE_DEFAULT;
+	uint32_t interval = seconds * TIMESTAMP_TICKS_PER_SECOND;
+	uint32_t wakeup = RETAINED_nextWakeup(RTCC_ChannelCCVGet(RETAINED_WAKEUP_CHANNEL), RTCC_CounterGet(), interval);
+
+	em4Init.em4State = emuEM4Hibernate;
+	em4Init.retainLfxo = true;
+	em4Init.pinRetentionMode = emuPinRetentionEm4Exit;
+	EMU_EM4Init(&em4Init);
+
+	RTCC_ChannelInit(RETAINED_WAKEUP_CHANNEL, &compare);
+	RTCC_ChannelCCVSet(RETAINED_WAKEUP_CHANNEL, wakeup);
+	RTCC_IntClear(RTCC_IF_CC1);
+	RTCC_IntEnable(RTCC_IEN_CC1);
+	RTCC_EM4WakeupEnable(true);
+
+	/* Same button wakeup as UTIL_shutdown */
+	GPIO_PinModeSet(BOARD_BUTTON0_PORT, BOARD_BUTTON0_PIN, gpioModeInputPullFilter, 1);
+	GPIO_EM4EnablePinWakeup((BOARD_BUTTON0_EM4WUEN_MASK << _GPIO_EM4WUEN_EM4WUEN_SHIFT), 0);
+
+	EMU_EnterEM4();
+}
+#endif
@@ -0,0 +1,58 @@
+/***************************************************************************//**
+ * @file
+ * @brief retained.h
+ ******************************************************************************/
+
+#ifndef RETAINED_H
+#define RETAINED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Sample ring that survives EM4. The RAM of the EFR32MG12 is lost in EM4, so
+ * the ring lives in the 32 RTCC retention registers, kept in EM4 Hibernate
+ * (RETAINED_hibernate) but not in EM4 Shutoff (UTIL_shutdown). A sample is
+ * packed into one word like the sample log records (20 bit pressure, 12 bit
+ * temperature), the timestamps are the first one plus a fixed interval, a
+ * sample within RETAINED_TOLERANCE_S of its slot takes the slot time.
+ * RETAINED_hibernate wakes up on a fixed grid (previous wakeup plus the
+ * interval), so the boot and measurement time does not add up to a drift.
+ * A CRC-32 covers the ring and the sequence counter counts the drains.
+ * The ring works on the word array given to RETAINED_init, so the host build
+ * (RETAINED_SOFTWARE_ONLY, without RETAINED_hibernate) runs it on RAM.
+ *
+ * The clock (timestamp.h) is kept next to the ring across EM4 Hibernate: the
+ * RTCC keeps counting, only the seconds and the counter value they belong to
+ * are lost with the RAM. A saved clock is taken once by the next boot.
+ *
+ * RET[0]: magic (8 bits), sequence (16 bits), clock saved (1 bit), count (7 bits)
+ * RET[1]: CRC-32 of RET[0] and RET[2..30]
+ * RET[2]: timestamp of the first sample, RET[3]: interval in seconds
+ * RET[4..28]: samples
+ * RET[29]: clock seconds, RET[30]: RTCC counter of the clock seconds
+ * RET[31]: not part of the ring, warm boot state (warm_boot.h)
+ */
+
+#define RETAINED_MAGIC           (0xA5)
+#define RETAINED_FIRST_WORD      (4)
+#define RETAINED_CLOCK_WORD      (29)
+#define RETAINED_WARM_BOOT_WORD  (31)
+#define RETAINED_CAPACITY        (RETAINED_CLOCK_WORD - RETAINED_FIRST_WORD)
+#define RETAINED_TOLERANCE_S     (1) // Jitter of a timestamp around its slot
+
+// Takes one recovered sample, same signature as SAMPLE_LOG_append and INTERNAL_LOG_append
+typedef void (*RETAINED_Sink)(uint32_t timestamp, uint32_t pressure, int16_t temperature);
+
+uint8_t RETAINED_init(volatile uint32_t* retention);
+bool RETAINED_push(uint32_t timestamp, uint32_t pressure, int16_t temperature);
+uint8_t RETAINED_drain(RETAINED_Sink sink);
+uint8_t RETAINED_getCount(void);
+uint16_t RETAINED_getSequence(void);
+uint32_t RETAINED_getNewestTimestamp(void);
+void RETAINED_saveClock(uint32_t seconds, uint32_t counter);
+bool RETAINED_takeClock(uint32_t* seconds, uint32_t* counter);
+uint32_t RETAINED_nextWakeup(uint32_t previous, uint32_t now, uint32_t interval);
+void RETAINED_hibernate(uint32_t seconds);
+
+#endif // RETAINED_H
@@ -0,0 +1,202 @@
+/***************************************************************************//**
+ * @file
+ * @brief rfs_data.c
+ ******************************************************************************/
+
+// Generated by generate_tables.py, do not edit
+
+#include <stdint.h>
+
+static const uint8_t altitude_tbl[2580] __attribute__((aligned(4))) = {
+	0x54, 0x54, 0x42, 0x4C, 0x01, 0x00, 0x81, 0x02, 0x0A, 0x00, 0x00, 0x00, 0x34, 0x61, 0x5C, 0x29,
+	0x38, 0x3F, 0x65, 0x15, 0xF1, 0xD1, 0x56, 0x15, 0x7E, 0x6A, 0x48, 0x15, 0xD9, 0x08, 0x3A, 0x15,
+	0xFD, 0xAC, 0x2B, 0x15, 0xE4, 0x56, 0x1D, 0x15, 0x89, 0x06, 0x0F, 0x15, 0xE8, 0xBB, 0x00, 0x15,
+	0xFB, 0x76, 0xF2, 0x14, 0xBD, 0x37, 0xE4, 0x14, 0x29, 0xFE, 0xD5, 0x14, 0x3A, 0xCA, 0xC7, 0x14,
+	0xEB, 0x9B, 0xB9, 0x14, 0x37, 0x73, 0xAB, 0x14, 0x19, 0x50, 0x9D, 0x14, 0x8D, 0x32, 0x8F, 0x14,
+	0x8C, 0x1A, 0x81, 0x14, 0x13, 0x08, 0x73, 0x14, 0x1D, 0xFB, 0x64, 0x14, 0xA4, 0xF3, 0x56, 0x14,
+	0xA4, 0xF1, 0x48, 0x14, 0x19, 0xF5, 0x3A, 0x14, 0xFD, 0xFD, 0x2C, 0x14, 0x4C, 0x0C, 0x1F, 0x14,
+	0x01, 0x20, 0x11, 0x14, 0x17, 0x39, 0x03, 0x14, 0x8A, 0x57, 0xF5, 0x13, 0x55, 0x7B, 0xE7, 0x13,
+	0x74, 0xA4, 0xD9, 0x13, 0xE2, 0xD2, 0xCB, 0x13, 0x9A, 0x06, 0xBE, 0x13, 0x98, 0x3F, 0xB0, 0x13,
+	0xD8, 0x7D, 0xA2, 0x13, 0x54, 0xC1, 0x94, 0x13, 0x0A, 0x0A, 0x87, 0x13, 0xF3, 0x57, 0x79, 0x13,
+	0x0C, 0xAB, 0x6B, 0x13, 0x50, 0x03, 0x5E, 0x13, 0xBB, 0x60, 0x50, 0x13, 0x49, 0xC3, 0x42, 0x13,
+	0xF5, 0x2A, 0x35, 0x13, 0xBB, 0x97, 0x27, 0x13, 0x97, 0x09, 0x1A, 0x13, 0x85, 0x80, 0x0C, 0x13,
+	0x7F, 0xFC, 0xFE, 0x12, 0x83, 0x7D, 0xF1, 0x12, 0x8C, 0x03, 0xE4, 0x12, 0x95, 0x8E, 0xD6, 0x12,
+	0x9B, 0x1E, 0xC9, 0x12, 0x99, 0xB3, 0xBB, 0x12, 0x8C, 0x4D, 0xAE, 0x12, 0x6E, 0xEC, 0xA0, 0x12,
+	0x3E, 0x90, 0x93, 0x12, 0xF5, 0x38, 0x86, 0x12, 0x90, 0xE6, 0x78, 0x12, 0x0C, 0x99, 0x6B, 0x12,
+	0x63, 0x50, 0x5E, 0x12, 0x93, 0x0C, 0x51, 0x12, 0x97, 0xCD, 0x43, 0x12, 0x6C, 0x93, 0x36, 0x12,
+	0x0D, 0x5E, 0x29, 0x12, 0x76, 0x2D, 0x1C, 0x12, 0xA4, 0x01, 0x0F, 0x12, 0x93, 0xDA, 0x01, 0x12,
+	0x3F, 0xB8, 0xF4, 0x11, 0xA4, 0x9A, 0xE7, 0x11, 0xBE, 0x81, 0xDA, 0x11, 0x8B, 0x6D, 0xCD, 0x11,
+	0x05, 0x5E, 0xC0, 0x11, 0x29, 0x53, 0xB3, 0x11, 0xF3, 0x4C, 0xA6, 0x11, 0x61, 0x4B, 0x99, 0x11,
+	0x6D, 0x4E, 0x8C, 0x11, 0x15, 0x56, 0x7F, 0x11, 0x54, 0x62, 0x72, 0x11, 0x28, 0x73, 0x65, 0x11,
+	0x8C, 0x88, 0x58, 0x11, 0x7D, 0xA2, 0x4B, 0x11, 0xF8, 0xC0, 0x3E, 0x11, 0xF8, 0xE3, 0x31, 0x11,
+	0x7A, 0x0B, 0x25, 0x11, 0x7B, 0x37, 0x18, 0x11, 0xF7, 0x67, 0x0B, 0x11, 0xEB, 0x9C, 0xFE, 0x10,
+	0x53, 0xD6, 0xF1, 0x10, 0x2C, 0x14, 0xE5, 0x10, 0x73, 0x56, 0xD8, 0x10, 0x23, 0x9D, 0xCB, 0x10,
+	0x39, 0xE8, 0xBE, 0x10, 0xB3, 0x37, 0xB2, 0x10, 0x8C, 0x8B, 0xA5, 0x10, 0xC2, 0xE3, 0x98, 0x10,
+	0x51, 0x40, 0x8C, 0x10, 0x35, 0xA1, 0x7F, 0x10, 0x6C, 0x06, 0x73, 0x10, 0xF2, 0x6F, 0x66, 0x10,
+	0xC3, 0xDD, 0x59, 0x10, 0xDD, 0x4F, 0x4D, 0x10, 0x3D, 0xC6, 0x40, 0x10, 0xDE, 0x40, 0x34, 0x10,
+	0xBE, 0xBF, 0x27, 0x10, 0xD9, 0x42, 0x1B, 0x10, 0x2D, 0xCA, 0x0E, 0x10, 0xB6, 0x55, 0x02, 0x10,
+	0x71, 0xE5, 0xF5, 0x0F, 0x5B, 0x79, 0xE9, 0x0F, 0x71, 0x11, 0xDD, 0x0F, 0xAF, 0xAD, 0xD0, 0x0F,
+	0x13, 0x4E, 0xC4, 0x0F, 0x99, 0xF2, 0xB7, 0x0F, 0x3E, 0x9B, 0xAB, 0x0F, 0x00, 0x48, 0x9F, 0x0F,
+	0xDB, 0xF8, 0x92, 0x0F, 0xCB, 0xAD, 0x86, 0x0F, 0xCF, 0x66, 0x7A, 0x0F, 0xE3, 0x23, 0x6E, 0x0F,
+	0x05, 0xE5, 0x61, 0x0F, 0x30, 0xAA, 0x55, 0x0F, 0x62, 0x73, 0x49, 0x0F, 0x99, 0x40, 0x3D, 0x0F,
+	0xD1, 0x11, 0x31, 0x0F, 0x07, 0xE7, 0x24, 0x0F, 0x38, 0xC0, 0x18, 0x0F, 0x62, 0x9D, 0x0C, 0x0F,
+	0x82, 0x7E, 0x00, 0x0F, 0x94, 0x63, 0xF4, 0x0E, 0x96, 0x4C, 0xE8, 0x0E, 0x85, 0x39, 0xDC, 0x0E,
+	0x5E, 0x2A, 0xD0, 0x0E, 0x1E, 0x1F, 0xC4, 0x0E, 0xC3, 0x17, 0xB8, 0x0E, 0x49, 0x14, 0xAC, 0x0E,
+	0xAF, 0x14, 0xA0, 0x0E, 0xF0, 0x18, 0x94, 0x0E, 0x0B, 0x21, 0x88, 0x0E, 0xFC, 0x2C, 0x7C, 0x0E,
+	0xC1, 0x3C, 0x70, 0x0E, 0x57, 0x50, 0x64, 0x0E, 0xBB, 0x67, 0x58, 0x0E, 0xEC, 0x82, 0x4C, 0x0E,
+	0xE5, 0xA1, 0x40, 0x0E, 0xA4, 0xC4, 0x34, 0x0E, 0x27, 0xEB, 0x28, 0x0E, 0x6A, 0x15, 0x1D, 0x0E,
+	0x6C, 0x43, 0x11, 0x0E, 0x2A, 0x75, 0x05, 0x0E, 0xA0, 0xAA, 0xF9, 0x0D, 0xCD, 0xE3, 0xED, 0x0D,
+	0xAE, 0x20, 0xE2, 0x0D, 0x40, 0x61, 0xD6, 0x0D, 0x80, 0xA5, 0xCA, 0x0D, 0x6D, 0xED, 0xBE, 0x0D,
+	0x02, 0x39, 0xB3, 0x0D, 0x3F, 0x88, 0xA7, 0x0D, 0x20, 0xDB, 0x9B, 0x0D, 0xA3, 0x31, 0x90, 0x0D,
+	0xC5, 0x8B, 0x84, 0x0D, 0x84, 0xE9, 0x78, 0x0D, 0xDD, 0x4A, 0x6D, 0x0D, 0xCE, 0xAF, 0x61, 0x0D,
+	0x54, 0x18, 0x56, 0x0D, 0x6D, 0x84, 0x4A, 0x0D, 0x17, 0xF4, 0x3E, 0x0D, 0x4E, 0x67, 0x33, 0x0D,
+	0x11, 0xDE, 0x27, 0x0D, 0x5D, 0x58, 0x1C, 0x0D, 0x2F, 0xD6, 0x10, 0x0D, 0x86, 0x57, 0x05, 0x0D,
+	0x5F, 0xDC, 0xF9, 0x0C, 0xB7, 0x64, 0xEE, 0x0C, 0x8C, 0xF0, 0xE2, 0x0C, 0xDB, 0x7F, 0xD7, 0x0C,
+	0xA4, 0x12, 0xCC, 0x0C, 0xE2, 0xA8, 0xC0, 0x0C, 0x93, 0x42, 0xB5, 0x0C, 0xB7, 0xDF, 0xA9, 0x0C,
+	0x49, 0x80, 0x9E, 0x0C, 0x47, 0x24, 0x93, 0x0C, 0xB1, 0xCB, 0x87, 0x0C, 0x82, 0x76, 0x7C, 0x0C,
+	0xB9, 0x24, 0x71, 0x0C, 0x54, 0xD6, 0x65, 0x0C, 0x50, 0x8B, 0x5A, 0x0C, 0xAA, 0x43, 0x4F, 0x0C,
+	0x62, 0xFF, 0x43, 0x0C, 0x74, 0xBE, 0x38, 0x0C, 0xDF, 0x80, 0x2D, 0x0C, 0xA0, 0x46, 0x22, 0x0C,
+	0xB4, 0x0F, 0x17, 0x0C, 0x1A, 0xDC, 0x0B, 0x0C, 0xD0, 0xAB, 0x00, 0x0C, 0xD3, 0x7E, 0xF5, 0x0B,
+	0x21, 0x55, 0xEA, 0x0B, 0xB8, 0x2E, 0xDF, 0x0B, 0x96, 0x0B, 0xD4, 0x0B, 0xB9, 0xEB, 0xC8, 0x0B,
+	0x1E, 0xCF, 0xBD, 0x0B, 0xC3, 0xB5, 0xB2, 0x0B, 0xA7, 0x9F, 0xA7, 0x0B, 0xC7, 0x8C, 0x9C, 0x0B,
+	0x21, 0x7D, 0x91, 0x0B, 0xB3, 0x70, 0x86, 0x0B, 0x7A, 0x67, 0x7B, 0x0B, 0x76, 0x61, 0x70, 0x0B,
+	0xA3, 0x5E, 0x65, 0x0B, 0x00, 0x5F, 0x5A, 0x0B, 0x8A, 0x62, 0x4F, 0x0B, 0x40, 0x69, 0x44, 0x0B,
+	0x20, 0x73, 0x39, 0x0B, 0x26, 0x80, 0x2E, 0x0B, 0x53, 0x90, 0x23, 0x0B, 0xA2, 0xA3, 0x18, 0x0B,
+	0x13, 0xBA, 0x0D, 0x0B, 0xA4, 0xD3, 0x02, 0x0B, 0x52, 0xF0, 0xF7, 0x0A, 0x1B, 0x10, 0xED, 0x0A,
+	0xFE, 0x32, 0xE2, 0x0A, 0xF8, 0x58, 0xD7, 0x0A, 0x07, 0x82, 0xCC, 0x0A, 0x2B, 0xAE, 0xC1, 0x0A,
+	0x5F, 0xDD, 0xB6, 0x0A, 0xA4, 0x0F, 0xAC, 0x0A, 0xF6, 0x44, 0xA1, 0x0A, 0x54, 0x7D, 0x96, 0x0A,
+	0xBC, 0xB8, 0x8B, 0x0A, 0x2C, 0xF7, 0x80, 0x0A, 0xA1, 0x38, 0x76, 0x0A, 0x1B, 0x7D, 0x6B, 0x0A,
+	0x98, 0xC4, 0x60, 0x0A, 0x14, 0x0F, 0x56, 0x0A, 0x90, 0x5C, 0x4B, 0x0A, 0x07, 0xAD, 0x40, 0x0A,
+	0x7A, 0x00, 0x36, 0x0A, 0xE6, 0x56, 0x2B, 0x0A, 0x48, 0xB0, 0x20, 0x0A, 0xA0, 0x0C, 0x16, 0x0A,
+	0xEB, 0x6B, 0x0B, 0x0A, 0x28, 0xCE, 0x00, 0x0A, 0x55, 0x33, 0xF6, 0x09, 0x6F, 0x9B, 0xEB, 0x09,
+	0x76, 0x06, 0xE1, 0x09, 0x67, 0x74, 0xD6, 0x09, 0x41, 0xE5, 0xCB, 0x09, 0x01, 0x59, 0xC1, 0x09,
+	0xA6, 0xCF, 0xB6, 0x09, 0x2F, 0x49, 0xAC, 0x09, 0x99, 0xC5, 0xA1, 0x09, 0xE2, 0x44, 0x97, 0x09,
+	0x0A, 0xC7, 0x8C, 0x09, 0x0E, 0x4C, 0x82, 0x09, 0xEC, 0xD3, 0x77, 0x09, 0xA3, 0x5E, 0x6D, 0x09,
+	0x31, 0xEC, 0x62, 0x09, 0x94, 0x7C, 0x58, 0x09, 0xCB, 0x0F, 0x4E, 0x09, 0xD3, 0xA5, 0x43, 0x09,
+	0xAC, 0x3E, 0x39, 0x09, 0x53, 0xDA, 0x2E, 0x09, 0xC7, 0x78, 0x24, 0x09, 0x06, 0x1A, 0x1A, 0x09,
+	0x0E, 0xBE, 0x0F, 0x09, 0xDE, 0x64, 0x05, 0x09, 0x74, 0x0E, 0xFB, 0x08, 0xCF, 0xBA, 0xF0, 0x08,
+	0xEC, 0x69, 0xE6, 0x08, 0xCA, 0x1B, 0xDC, 0x08, 0x68, 0xD0, 0xD1, 0x08, 0xC4, 0x87, 0xC7, 0x08,
+	0xDC, 0x41, 0xBD, 0x08, 0xAE, 0xFE, 0xB2, 0x08, 0x39, 0xBE, 0xA8, 0x08, 0x7C, 0x80, 0x9E, 0x08,
+	0x74, 0x45, 0x94, 0x08, 0x21, 0x0D, 0x8A, 0x08, 0x80, 0xD7, 0x7F, 0x08, 0x8F, 0xA4, 0x75, 0x08,
+	0x4F, 0x74, 0x6B, 0x08, 0xBC, 0x46, 0x61, 0x08, 0xD5, 0x1B, 0x57, 0x08, 0x99, 0xF3, 0x4C, 0x08,
+	0x06, 0xCE, 0x42, 0x08, 0x1A, 0xAB, 0x38, 0x08, 0xD5, 0x8A, 0x2E, 0x08, 0x34, 0x6D, 0x24, 0x08,
+	0x36, 0x52, 0x1A, 0x08, 0xD9, 0x39, 0x10, 0x08, 0x1C, 0x24, 0x06, 0x08, 0xFD, 0x10, 0xFC, 0x07,
+	0x7B, 0x00, 0xF2, 0x07, 0x95, 0xF2, 0xE7, 0x07, 0x48, 0xE7, 0xDD, 0x07, 0x93, 0xDE, 0xD3, 0x07,
+	0x75, 0xD8, 0xC9, 0x07, 0xED, 0xD4, 0xBF, 0x07, 0xF8, 0xD3, 0xB5, 0x07, 0x96, 0xD5, 0xAB, 0x07,
+	0xC4, 0xD9, 0xA1, 0x07, 0x82, 0xE0, 0x97, 0x07, 0xCD, 0xE9, 0x8D, 0x07, 0xA6, 0xF5, 0x83, 0x07,
+	0x09, 0x04, 0x7A, 0x07, 0xF5, 0x14, 0x70, 0x07, 0x6A, 0x28, 0x66, 0x07, 0x65, 0x3E, 0x5C, 0x07,
+	0xE6, 0x56, 0x52, 0x07, 0xEA, 0x71, 0x48, 0x07, 0x71, 0x8F, 0x3E, 0x07, 0x79, 0xAF, 0x34, 0x07,
+	0x00, 0xD2, 0x2A, 0x07, 0x05, 0xF7, 0x20, 0x07, 0x87, 0x1E, 0x17, 0x07, 0x85, 0x48, 0x0D, 0x07,
+	0xFC, 0x74, 0x03, 0x07, 0xEC, 0xA3, 0xF9, 0x06, 0x53, 0xD5, 0xEF, 0x06, 0x2F, 0x09, 0xE6, 0x06,
+	0x80, 0x3F, 0xDC, 0x06, 0x44, 0x78, 0xD2, 0x06, 0x7A, 0xB3, 0xC8, 0x06, 0x20, 0xF1, 0xBE, 0x06,
+	0x35, 0x31, 0xB5, 0x06, 0xB7, 0x73, 0xAB, 0x06, 0xA6, 0xB8, 0xA1, 0x06, 0xFF, 0xFF, 0x97, 0x06,
+	0xC2, 0x49, 0x8E, 0x06, 0xEE, 0x95, 0x84, 0x06, 0x80, 0xE4, 0x7A, 0x06, 0x77, 0x35, 0x71, 0x06,
+	0xD3, 0x88, 0x67, 0x06, 0x91, 0xDE, 0x5D, 0x06, 0xB2, 0x36, 0x54, 0x06, 0x32, 0x91, 0x4A, 0x06,
+	0x12, 0xEE, 0x40, 0x06, 0x4F, 0x4D, 0x37, 0x06, 0xE8, 0xAE, 0x2D, 0x06, 0xDD, 0x12, 0x24, 0x06,
+	0x2B, 0x79, 0x1A, 0x06, 0xD2, 0xE1, 0x10, 0x06, 0xD0, 0x4C, 0x07, 0x06, 0x23, 0xBA, 0xFD, 0x05,
+	0xCC, 0x29, 0xF4, 0x05, 0xC8, 0x9B, 0xEA, 0x05, 0x16, 0x10, 0xE1, 0x05, 0xB5, 0x86, 0xD7, 0x05,
+	0xA4, 0xFF, 0xCD, 0x05, 0xE1, 0x7A, 0xC4, 0x05, 0x6B, 0xF8, 0xBA, 0x05, 0x41, 0x78, 0xB1, 0x05,
+	0x62, 0xFA, 0xA7, 0x05, 0xCC, 0x7E, 0x9E, 0x05, 0x7E, 0x05, 0x95, 0x05, 0x77, 0x8E, 0x8B, 0x05,
+	0xB6, 0x19, 0x82, 0x05, 0x3A, 0xA7, 0x78, 0x05, 0x01, 0x37, 0x6F, 0x05, 0x09, 0xC9, 0x65, 0x05,
+	0x53, 0x5D, 0x5C, 0x05, 0xDD, 0xF3, 0x52, 0x05, 0xA5, 0x8C, 0x49, 0x05, 0xAA, 0x27, 0x40, 0x05,
+	0xEB, 0xC4, 0x36, 0x05, 0x68, 0x64, 0x2D, 0x05, 0x1E, 0x06, 0x24, 0x05, 0x0C, 0xAA, 0x1A, 0x05,
+	0x32, 0x50, 0x11, 0x05, 0x8E, 0xF8, 0x07, 0x05, 0x20, 0xA3, 0xFE, 0x04, 0xE5, 0x4F, 0xF5, 0x04,
+	0xDC, 0xFE, 0xEB, 0x04, 0x06, 0xB0, 0xE2, 0x04, 0x60, 0x63, 0xD9, 0x04, 0xE9, 0x18, 0xD0, 0x04,
+	0xA0, 0xD0, 0xC6, 0x04, 0x84, 0x8A, 0xBD, 0x04, 0x94, 0x46, 0xB4, 0x04, 0xCE, 0x04, 0xAB, 0x04,
+	0x33, 0xC5, 0xA1, 0x04, 0xBF, 0x87, 0x98, 0x04, 0x73, 0x4C, 0x8F, 0x04, 0x4D, 0x13, 0x86, 0x04,
+	0x4D, 0xDC, 0x7C, 0x04, 0x70, 0xA7, 0x73, 0x04, 0xB6, 0x74, 0x6A, 0x04, 0x1E, 0x44, 0x61, 0x04,
+	0xA6, 0x15, 0x58, 0x04, 0x4E, 0xE9, 0x4E, 0x04, 0x14, 0xBF, 0x45, 0x04, 0xF8, 0x96, 0x3C, 0x04,
+	0xF8, 0x70, 0x33, 0x04, 0x13, 0x4D, 0x2A, 0x04, 0x49, 0x2B, 0x21, 0x04, 0x97, 0x0B, 0x18, 0x04,
+	0xFD, 0xED, 0x0E, 0x04, 0x7A, 0xD2, 0x05, 0x04, 0x0D, 0xB9, 0xFC, 0x03, 0xB5, 0xA1, 0xF3, 0x03,
+	0x70, 0x8C, 0xEA, 0x03, 0x3E, 0x79, 0xE1, 0x03, 0x1E, 0x68, 0xD8, 0x03, 0x0E, 0x59, 0xCF, 0x03,
+	0x0D, 0x4C, 0xC6, 0x03, 0x1B, 0x41, 0xBD, 0x03, 0x36, 0x38, 0xB4, 0x03, 0x5E, 0x31, 0xAB, 0x03,
+	0x91, 0x2C, 0xA2, 0x03, 0xCE, 0x29, 0x99, 0x03, 0x14, 0x29, 0x90, 0x03, 0x63, 0x2A, 0x87, 0x03,
+	0xB9, 0x2D, 0x7E, 0x03, 0x14, 0x33, 0x75, 0x03, 0x75, 0x3A, 0x6C, 0x03, 0xDB, 0x43, 0x63, 0x03,
+	0x43, 0x4F, 0x5A, 0x03, 0xAD, 0x5C, 0x51, 0x03, 0x19, 0x6C, 0x48, 0x03, 0x84, 0x7D, 0x3F, 0x03,
+	0xEF, 0x90, 0x36, 0x03, 0x57, 0xA6, 0x2D, 0x03, 0xBD, 0xBD, 0x24, 0x03, 0x1F, 0xD7, 0x1B, 0x03,
+	0x7C, 0xF2, 0x12, 0x03, 0xD3, 0x0F, 0x0A, 0x03, 0x24, 0x2F, 0x01, 0x03, 0x6C, 0x50, 0xF8, 0x02,
+	0xAC, 0x73, 0xEF, 0x02, 0xE2, 0x98, 0xE6, 0x02, 0x0D, 0xC0, 0xDD, 0x02, 0x2D, 0xE9, 0xD4, 0x02,
+	0x40, 0x14, 0xCC, 0x02, 0x45, 0x41, 0xC3, 0x02, 0x3C, 0x70, 0xBA, 0x02, 0x23, 0xA1, 0xB1, 0x02,
+	0xFA, 0xD3, 0xA8, 0x02, 0xBF, 0x08, 0xA0, 0x02, 0x72, 0x3F, 0x97, 0x02, 0x11, 0x78, 0x8E, 0x02,
+	0x9C, 0xB2, 0x85, 0x02, 0x12, 0xEF, 0x7C, 0x02, 0x72, 0x2D, 0x74, 0x02, 0xBB, 0x6D, 0x6B, 0x02,
+	0xEC, 0xAF, 0x62, 0x02, 0x04, 0xF4, 0x59, 0x02, 0x02, 0x3A, 0x51, 0x02, 0xE5, 0x81, 0x48, 0x02,
+	0xAC, 0xCB, 0x3F, 0x02, 0x57, 0x17, 0x37, 0x02, 0xE4, 0x64, 0x2E, 0x02, 0x53, 0xB4, 0x25, 0x02,
+	0xA3, 0x05, 0x1D, 0x02, 0xD2, 0x58, 0x14, 0x02, 0xE0, 0xAD, 0x0B, 0x02, 0xCC, 0x04, 0x03, 0x02,
+	0x95, 0x5D, 0xFA, 0x01, 0x3B, 0xB8, 0xF1, 0x01, 0xBB, 0x14, 0xE9, 0x01, 0x16, 0x73, 0xE0, 0x01,
+	0x4A, 0xD3, 0xD7, 0x01, 0x57, 0x35, 0xCF, 0x01, 0x3C, 0x99, 0xC6, 0x01, 0xF8, 0xFE, 0xBD, 0x01,
+	0x89, 0x66, 0xB5, 0x01, 0xEF, 0xCF, 0xAC, 0x01, 0x2A, 0x3B, 0xA4, 0x01, 0x38, 0xA8, 0x9B, 0x01,
+	0x19, 0x17, 0x93, 0x01, 0xCB, 0x87, 0x8A, 0x01, 0x4E, 0xFA, 0x81, 0x01, 0xA0, 0x6E, 0x79, 0x01,
+	0xC2, 0xE4, 0x70, 0x01, 0xB2, 0x5C, 0x68, 0x01, 0x6F, 0xD6, 0x5F, 0x01, 0xF9, 0x51, 0x57, 0x01,
+	0x4F, 0xCF, 0x4E, 0x01, 0x6F, 0x4E, 0x46, 0x01, 0x59, 0xCF, 0x3D, 0x01, 0x0C, 0x52, 0x35, 0x01,
+	0x87, 0xD6, 0x2C, 0x01, 0xCA, 0x5C, 0x24, 0x01, 0xD4, 0xE4, 0x1B, 0x01, 0xA3, 0x6E, 0x13, 0x01,
+	0x37, 0xFA, 0x0A, 0x01, 0x8F, 0x87, 0x02, 0x01, 0xAB, 0x16, 0xFA, 0x00, 0x89, 0xA7, 0xF1, 0x00,
+	0x28, 0x3A, 0xE9, 0x00, 0x89, 0xCE, 0xE0, 0x00, 0xA9, 0x64, 0xD8, 0x00, 0x89, 0xFC, 0xCF, 0x00,
+	0x27, 0x96, 0xC7, 0x00, 0x82, 0x31, 0xBF, 0x00, 0x9A, 0xCE, 0xB6, 0x00, 0x6F, 0x6D, 0xAE, 0x00,
+	0xFE, 0x0D, 0xA6, 0x00, 0x48, 0xB0, 0x9D, 0x00, 0x4C, 0x54, 0x95, 0x00, 0x08, 0xFA, 0x8C, 0x00,
+	0x7C, 0xA1, 0x84, 0x00, 0xA7, 0x4A, 0x7C, 0x00, 0x89, 0xF5, 0x73, 0x00, 0x21, 0xA2, 0x6B, 0x00,
+	0x6D, 0x50, 0x63, 0x00, 0x6D, 0x00, 0x5B, 0x00, 0x21, 0xB2, 0x52, 0x00, 0x87, 0x65, 0x4A, 0x00,
+	0x9F, 0x1A, 0x42, 0x00, 0x68, 0xD1, 0x39, 0x00, 0xE1, 0x89, 0x31, 0x00, 0x09, 0x44, 0x29, 0x00,
+	0xE0, 0xFF, 0x20, 0x00, 0x65, 0xBD, 0x18, 0x00, 0x97, 0x7C, 0x10, 0x00, 0x76, 0x3D, 0x08, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x35, 0xC4, 0xF7, 0xFF, 0x14, 0x8A, 0xEF, 0xFF, 0x9C, 0x51, 0xE7, 0xFF,
+	0xCD, 0x1A, 0xDF, 0xFF, 0xA6, 0xE5, 0xD6, 0xFF, 0x26, 0xB2, 0xCE, 0xFF, 0x4D, 0x80, 0xC6, 0xFF,
+	0x19, 0x50, 0xBE, 0xFF, 0x8A, 0x21, 0xB6, 0xFF, 0x9F, 0xF4, 0xAD, 0xFF, 0x57, 0xC9, 0xA5, 0xFF,
+	0xB2, 0x9F, 0x9D, 0xFF, 0xAF, 0x77, 0x95, 0xFF, 0x4E, 0x51, 0x8D, 0xFF, 0x8C, 0x2C, 0x85, 0xFF,
+	0x6B, 0x09, 0x7D, 0xFF, 0xE9, 0xE7, 0x74, 0xFF, 0x05, 0xC8, 0x6C, 0xFF, 0xBE, 0xA9, 0x64, 0xFF,
+	0x15, 0x8D, 0x5C, 0xFF, 0x07, 0x72, 0x54, 0xFF, 0x95, 0x58, 0x4C, 0xFF, 0xBE, 0x40, 0x44, 0xFF,
+	0x81, 0x2A, 0x3C, 0xFF, 0xDD, 0x15, 0x34, 0xFF, 0xD2, 0x02, 0x2C, 0xFF, 0x5F, 0xF1, 0x23, 0xFF,
+	0x83, 0xE1, 0x1B, 0xFF, 0x3D, 0xD3, 0x13, 0xFF, 0x8E, 0xC6, 0x0B, 0xFF, 0x73, 0xBB, 0x03, 0xFF,
+	0xED, 0xB1, 0xFB, 0xFE, 0xFA, 0xA9, 0xF3, 0xFE, 0x9B, 0xA3, 0xEB, 0xFE, 0xCE, 0x9E, 0xE3, 0xFE,
+	0x93, 0x9B, 0xDB, 0xFE, 0xE8, 0x99, 0xD3, 0xFE, 0xCE, 0x99, 0xCB, 0xFE, 0x44, 0x9B, 0xC3, 0xFE,
+	0x49, 0x9E, 0xBB, 0xFE, 0xDB, 0xA2, 0xB3, 0xFE, 0xFC, 0xA8, 0xAB, 0xFE, 0xA9, 0xB0, 0xA3, 0xFE,
+	0xE2, 0xB9, 0x9B, 0xFE, 0xA8, 0xC4, 0x93, 0xFE, 0xF7, 0xD0, 0x8B, 0xFE, 0xD2, 0xDE, 0x83, 0xFE,
+	0x35, 0xEE, 0x7B, 0xFE, 0x22, 0xFF, 0x73, 0xFE, 0x97, 0x11, 0x6C, 0xFE, 0x93, 0x25, 0x64, 0xFE,
+	0x17, 0x3B, 0x5C, 0xFE, 0x20, 0x52, 0x54, 0xFE, 0xB0, 0x6A, 0x4C, 0xFE, 0xC4, 0x84, 0x44, 0xFE,
+	0x5C, 0xA0, 0x3C, 0xFE, 0x78, 0xBD, 0x34, 0xFE, 0x18, 0xDC, 0x2C, 0xFE, 0x39, 0xFC, 0x24, 0xFE,
+	0xDC, 0x1D, 0x1D, 0xFE, 0x01, 0x41, 0x15, 0xFE, 0xA5, 0x65, 0x0D, 0xFE, 0xCA, 0x8B, 0x05, 0xFE,
+	0x6D, 0xB3, 0xFD, 0xFD, 0x8F, 0xDC, 0xF5, 0xFD, 0x2F, 0x07, 0xEE, 0xFD, 0x4C, 0x33, 0xE6, 0xFD,
+	0xE6, 0x60, 0xDE, 0xFD, 0xFC, 0x8F, 0xD6, 0xFD, 0x8D, 0xC0, 0xCE, 0xFD, 0x99, 0xF2, 0xC6, 0xFD,
+	0x1F, 0x26, 0xBF, 0xFD, 0x1E, 0x5B, 0xB7, 0xFD, 0x96, 0x91, 0xAF, 0xFD, 0x87, 0xC9, 0xA7, 0xFD,
+	0xEF, 0x02, 0xA0, 0xFD, 0xCE, 0x3D, 0x98, 0xFD, 0x23, 0x7A, 0x90, 0xFD, 0xEF, 0xB7, 0x88, 0xFD,
+	0x2F, 0xF7, 0x80, 0xFD, 0xE4, 0x37, 0x79, 0xFD, 0x0C, 0x7A, 0x71, 0xFD, 0xA8, 0xBD, 0x69, 0xFD,
+	0xB7, 0x02, 0x62, 0xFD, 0x38, 0x49, 0x5A, 0xFD, 0x2A, 0x91, 0x52, 0xFD, 0x8E, 0xDA, 0x4A, 0xFD,
+	0x61, 0x25, 0x43, 0xFD, 0xA5, 0x71, 0x3B, 0xFD, 0x57, 0xBF, 0x33, 0xFD, 0x78, 0x0E, 0x2C, 0xFD,
+	0x06, 0x5F, 0x24, 0xFD, 0x02, 0xB1, 0x1C, 0xFD, 0x6B, 0x04, 0x15, 0xFD, 0x40, 0x59, 0x0D, 0xFD,
+	0x81, 0xAF, 0x05, 0xFD, 0x2C, 0x07, 0xFE, 0xFC, 0x42, 0x60, 0xF6, 0xFC, 0xC1, 0xBA, 0xEE, 0xFC,
+	0xAA, 0x16, 0xE7, 0xFC, 0xFB, 0x73, 0xDF, 0xFC, 0xB5, 0xD2, 0xD7, 0xFC, 0xD6, 0x32, 0xD0, 0xFC,
+	0x5E, 0x94, 0xC8, 0xFC, 0x4C, 0xF7, 0xC0, 0xFC, 0x9F, 0x5B, 0xB9, 0xFC, 0x58, 0xC1, 0xB1, 0xFC,
+	0x76, 0x28, 0xAA, 0xFC, 0xF8, 0x90, 0xA2, 0xFC, 0xDD, 0xFA, 0x9A, 0xFC, 0x24, 0x66, 0x93, 0xFC,
+	0xCF, 0xD2, 0x8B, 0xFC, 0xDB, 0x40, 0x84, 0xFC, 0x48, 0xB0, 0x7C, 0xFC, 0x16, 0x21, 0x75, 0xFC,
+	0x44, 0x93, 0x6D, 0xFC, 0xD1, 0x06, 0x66, 0xFC, 0xBD, 0x7B, 0x5E, 0xFC, 0x08, 0xF2, 0x56, 0xFC,
+	0xB1, 0x69, 0x4F, 0xFC, 0xB7, 0xE2, 0x47, 0xFC, 0x19, 0x5D, 0x40, 0xFC, 0xD8, 0xD8, 0x38, 0xFC,
+	0xF3, 0x55, 0x31, 0xFC, 0x68, 0xD4, 0x29, 0xFC, 0x38, 0x54, 0x22, 0xFC, 0x62, 0xD5, 0x1A, 0xFC,
+	0xE6, 0x57, 0x13, 0xFC,
+};
+
+static const uint8_t calibration_tbl[32] __attribute__((aligned(4))) = {
+	0x54, 0x54, 0x42, 0x4C, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x77, 0x1E, 0x0F, 0xA6,
+	0xC0, 0xD4, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0xB6, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static const uint8_t governor_tbl[52] __attribute__((aligned(4))) = {
+	0x54, 0x54, 0x42, 0x4C, 0x03, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0xD1, 0x3D, 0x9C, 0xCB,
+	0x07, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x01, 0x00, 0x00,
+	0x04, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00,
+	0x0A, 0x00, 0x00, 0x00,
+};
+
+const uint32_t RFS_fileCount = 3;
+const uint8_t *RFS_fileNames[] = {
+	(const uint8_t *)"altitude.tbl",
+	(const uint8_t *)"calibration.tbl",
+	(const uint8_t *)"governor.tbl",
+};
+const uint32_t RFS_fileLength[] = {
+	2580,
+	32,
+	52,
+};
+const uint8_t *RFS_fileData[] = {
+	altitude_tbl,
+	calibration_tbl,
+	governor_tbl,
+};
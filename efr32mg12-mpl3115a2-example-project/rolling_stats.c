@@ -0,0 +1,138 @@
+/***************************************************************************//**
+ * @file
+ * @brief rolling_stats.c
+ ******************************************************************************/
+
+#include "rolling_stats.h"
+
+#define ROLLING_STATS_INDEX(stats, i) ((uint16_t)(((uint32_t)(i) >= (stats)->size) ? (uint32_t)(i) - (stats)->size : (uint32_t)(i)))
+
+// The slot buffer holds size entries, size is at least 1
+void ROLLING_STATS_init(ROLLING_STATS_TypeDef* stats, ROLLING_STATS_Slot_TypeDef* slots, uint16_t size)
+{
+	stats->slots = slots;
+	stats->size = size;
+	stats->minHead = 0;
+	stats->minCount = 0;
+	stats->maxHead = 0;
+	stats->maxCount = 0;
+	stats->head = 0;
+	stats->count = 0;
+	stats->offset = 0;
+	stats->sum = 0;
+	stats->sumSquares = 0;
+}
+
+// Push a new sample into the minimum deque, dropping the larger samples from the back
+static void ROLLING_STATS_minPush(ROLLING_STATS_TypeDef* stats, uint16_t position)
+{
+	ROLLING_STATS_Slot_TypeDef* slots = stats->slots;
+
+	while((stats->minCount > 0)
+		&& (slots[slots[ROLLING_STATS_INDEX(stats, stats->minHead + stats->minCount - 1)].minPosition].sample >= slots[position].sample)) {
+		stats->minCount--;
+	}
+	slots[ROLLING_STATS_INDEX(stats, stats->minHead + stats->minCount)].minPosition = position;
+	stats->minCount++;
+}
+
+// Same for the maximum deque, dropping the smaller samples
+static void ROLLING_STATS_maxPush(ROLLING_STATS_TypeDef* stats, uint16_t position)
+{
+	ROLLING_STATS_Slot_TypeDef* slots = stats->slots;
+
+	while((stats->maxCount > 0)
+		&& (slots[slots[ROLLING_STATS_INDEX(stats, stats->maxHead + stats->maxCount - 1)].maxPosition].sample <= slots[position].sample)) {
+		stats->maxCount--;
+	}
+	slots[ROLLING_STATS_INDEX(stats, stats->maxHead + stats->maxCount)].maxPosition = position;
+	stats->maxCount++;
+}
+
+// Drop the fronts of the deques if they are the sample leaving the window
+static void ROLLING_STATS_expire(ROLLING_STATS_TypeDef* stats, uint16_t position)
+{
+	if((stats->minCount > 0) && (stats->slots[stats->minHead].minPosition == position)) {
+		stats->minHead = ROLLING_STATS_INDEX(stats, stats->minHead + 1);
+		stats->minCount--;
+	}
+	if((stats->maxCount > 0) && (stats->slots[stats->maxHead].maxPosition == position)) {
+		stats->maxHead = ROLLING_STATS_INDEX(stats, stats->maxHead + 1);
+		stats->maxCount--;
+	}
+}
+
+void ROLLING_STATS_push(ROLLING_STATS_TypeDef* stats, int32_t sample)
+{
+	int32_t relative = 0;
+	int32_t oldest = 0;
+
+	if((stats->count == 0) && (stats->head == 0)) {
+		stats->offset = sample;
+	}
+	relative = sample - stats->offset;
+
+	/* The sample at head leaves the window when it is full */
+	if(stats->count == stats->size) {
+		oldest = stats->slots[stats->head].sample;
+		stats->sum -= oldest;
+		stats->sumSquares -= (uint64_t)((int64_t)oldest * oldest);
+		ROLLING_STATS_expire(stats, stats->head);
+	}
+	else {
+		stats->count++;
+	}
+
+	stats->slots[stats->head].sample = relative;
+	stats->sum += relative;
+	stats->sumSquares += (uint64_t)((int64_t)relative * relative);
+	ROLLING_STATS_minPush(stats, stats->head);
+	ROLLING_STATS_maxPush(stats, stats->head);
+
+	stats->head = ROLLING_STATS_INDEX(stats, stats->head + 1);
+}
+
+// Integer square root, rounded down
+static uint32_t ROLLING_STATS_sqrt(uint32_t value)
+{
+	uint32_t result = 0;
+	uint32_t bit = 1UL << 30;
+
+	while(bit > value) {
+		bit >>= 2;
+	}
+	while(bit != 0) {
+		if(value >= result + bit) {
+			value -= result + bit;
+			result = (result >> 1) + bit;
+		}
+		else {
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	return result;
+}
+
+// Summary of the samples in the window, returns false if the window is empty
+bool ROLLING_STATS_getSummary(const ROLLING_STATS_TypeDef* stats, ROLLING_STATS_Summary_TypeDef* summary)
+{
+	int64_t mean = 0;
+	uint64_t variance = 0;
+
+	if(stats->count == 0) {
+		return false;
+	}
+
+	/* n * var = sum(x^2) - sum(x)^2 / n */
+	mean = stats->sum / stats->count;
+	variance = (stats->sumSquares - (uint64_t)((stats->sum * stats->sum) / stats->count)) / stats->count;
+
+	summary->count = stats->count;
+	summary->mean = stats->offset + (int32_t)mean;
+	summary->variance = (variance > UINT32_MAX) ? UINT32_MAX : (uint32_t)variance;
+	summary->stdDev = ROLLING_STATS_sqrt(summary->variance);
+	summary->min = stats->offset + stats->slots[stats->slots[stats->minHead].minPosition].sample;
+	summary->max = stats->offset + stats->slots[stats->slots[stats->maxHead].maxPosition].sample;
+	return true;
+}
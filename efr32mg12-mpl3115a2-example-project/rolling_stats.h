@@ -0,0 +1,54 @@
+/***************************************************************************//**
+ * @file
+ * @brief rolling_stats.h
+ ******************************************************************************/
+
+#ifndef ROLLING_STATS_H
+#define ROLLING_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Mean, variance, minimum and maximum over the last N samples, updated in
+ * constant (amortized) time per sample:
+ * - running sum and sum of squares of the samples relative to the first one,
+ *   so the moments are exact integers and the window can slide
+ * - monotonic deques of the window positions for the minimum and maximum
+ * The window size is given at init together with the caller's slot buffer
+ * of that many entries (8 bytes per sample), so windows of different sizes
+ * can run side by side.
+ */
+
+typedef struct {
+	int32_t sample;       // Sample relative to the offset (ring)
+	uint16_t minPosition; // Deque of the window positions with ascending samples
+	uint16_t maxPosition; // Deque of the window positions with descending samples
+} ROLLING_STATS_Slot_TypeDef;
+
+typedef struct {
+	ROLLING_STATS_Slot_TypeDef* slots; // Caller's buffer of size entries
+	uint16_t size;   // Samples in a full window
+	uint16_t minHead, minCount;
+	uint16_t maxHead, maxCount;
+	uint16_t head;   // Position of the next sample in the window
+	uint16_t count;  // Samples in the window
+	int32_t offset;  // First sample, subtracted from all samples
+	int64_t sum;     // Sum of the relative samples in the window
+	uint64_t sumSquares; // Sum of the squared relative samples in the window
+} ROLLING_STATS_TypeDef;
+
+typedef struct {
+	uint16_t count;    // Samples in the window
+	int32_t mean;      // Mean, same unit as the samples
+	uint32_t variance; // Population variance, unit squared
+	uint32_t stdDev;   // Standard deviation, same unit as the samples
+	int32_t min;
+	int32_t max;
+} ROLLING_STATS_Summary_TypeDef;
+
+void ROLLING_STATS_init(ROLLING_STATS_TypeDef* stats, ROLLING_STATS_Slot_TypeDef* slots, uint16_t size);
+void ROLLING_STATS_push(ROLLING_STATS_TypeDef* stats, int32_t sample);
+bool ROLLING_STATS_getSummary(const ROLLING_STATS_TypeDef* stats, ROLLING_STATS_Summary_TypeDef* summary);
+
+#endif // ROLLING_STATS_H
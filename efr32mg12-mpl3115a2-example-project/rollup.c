@@ -0,0 +1,182 @@
+/***************************************************************************//**
+ * @file
+ * @brief rollup.c
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rollup.h"
+
+typedef struct {
+	uint32_t width;                 // Bucket width in seconds
+	ROLLUP_Bucket_TypeDef* buckets; // Closed buckets (ring), oldest at head
+	uint16_t size;
+	uint16_t head;
+	uint16_t count;
+	bool open;                      // The open bucket has samples
+	ROLLUP_Bucket_TypeDef current;  // Open bucket, mean is computed from sum at close
+	int64_t sum;                    // Sum of the samples of the open bucket
+} ROLLUP_Tier_TypeDef;
+
+static ROLLUP_Bucket_TypeDef minuteBuckets[ROLLUP_MINUTE_COUNT];
+static ROLLUP_Bucket_TypeDef hourBuckets[ROLLUP_HOUR_COUNT];
+static ROLLUP_Bucket_TypeDef dayBuckets[ROLLUP_DAY_COUNT];
+
+static ROLLUP_Tier_TypeDef tiers[ROLLUP_TIER_COUNT] = {
+	{ 60,    minuteBuckets, ROLLUP_MINUTE_COUNT, 0, 0, false, { 0 }, 0 },
+	{ 3600,  hourBuckets,   ROLLUP_HOUR_COUNT,   0, 0, false, { 0 }, 0 },
+	{ 86400, dayBuckets,    ROLLUP_DAY_COUNT,    0, 0, false, { 0 }, 0 },
+};
+
+static ROLLUP_CloseCallback closeCallback = NULL;
+
+void ROLLUP_init(void)
+{
+	uint8_t i;
+
+	for(i = 0; i < ROLLUP_TIER_COUNT; i++) {
+		tiers[i].head = 0;
+		tiers[i].count = 0;
+		tiers[i].open = false;
+		tiers[i].sum = 0;
+	}
+}
+
+void ROLLUP_setCloseCallback(ROLLUP_CloseCallback callback)
+{
+	closeCallback = callback;
+}
+
+// Closed bucket of a tier by age order, 0 is the oldest
+static ROLLUP_Bucket_TypeDef* ROLLUP_bucketAt(const ROLLUP_Tier_TypeDef* tier, uint16_t index)
+{
+	index += tier->head;
+	if(index >= tier->size) {
+		index -= tier->size;
+	}
+	return &tier->buckets[index];
+}
+
+static void ROLLUP_close(uint8_t tierIndex)
+{
+	ROLLUP_Tier_TypeDef* tier = &tiers[tierIndex];
+	ROLLUP_Bucket_TypeDef* bucket = NULL;
+
+	tier->current.mean = (int32_t)(tier->sum / (int64_t)tier->current.count);
+	if(tier->count == tier->size) {
+		/* Full: the oldest bucket is overwritten */
+		bucket = &tier->buckets[tier->head];
+		tier->head = (tier->head + 1 == tier->size) ? 0 : tier->head + 1;
+	}
+	else {
+		bucket = ROLLUP_bucketAt(tier, tier->count);
+		tier->count++;
+	}
+	*bucket = tier->current;
+	tier->open = false;
+
+	if(closeCallback != NULL) {
+		closeCallback(tierIndex, bucket);
+	}
+}
+
+// Add a sample taken at timestamp (seconds, not decreasing)
+void ROLLUP_push(uint32_t timestamp, int32_t sample)
+{
+	ROLLUP_Tier_TypeDef* tier = NULL;
+	uint32_t start = 0;
+	uint8_t i;
+
+	for(i = 0; i < ROLLUP_TIER_COUNT; i++) {
+		tier = &tiers[i];
+		start = timestamp - (timestamp % tier->width);
+		if(tier->open && (tier->current.start != start)) {
+			ROLLUP_close(i);
+		}
+		if(!tier->open) {
+			tier->current.start = start;
+			tier->current.count = 0;
+			tier->current.min = sample;
+			tier->current.max = sample;
+			tier->sum = 0;
+			tier->open = true;
+		}
+		tier->current.count++;
+		tier->sum += sample;
+		if(sample < tier->current.min) {
+			tier->current.min = sample;
+		}
+		if(sample > tier->current.max) {
+			tier->current.max = sample;
+		}
+	}
+}
+
+// The tier still holds data back to from
+static bool ROLLUP_covers(const ROLLUP_Tier_TypeDef* tier, uint32_t from)
+{
+	if(tier->count > 0) {
+		return ROLLUP_bucketAt(tier, 0)->start <= from;
+	}
+	return tier->open && (tier->current.start <= from);
+}
+
+// Tier to answer a query from: the coarsest tier with buckets not wider than
+// resolution (seconds) that still holds data back to from. If no such tier
+// holds data back to from, the coarsest tier that does, else the day tier.
+uint8_t ROLLUP_selectTier(uint32_t from, uint32_t resolution)
+{
+	int8_t i;
+
+	for(i = ROLLUP_TIER_COUNT - 1; i >= 0; i--) {
+		if((tiers[i].width <= resolution) && ROLLUP_covers(&tiers[i], from)) {
+			return (uint8_t)i;
+		}
+	}
+	for(i = ROLLUP_TIER_COUNT - 1; i >= 0; i--) {
+		if(ROLLUP_covers(&tiers[i], from)) {
+			return (uint8_t)i;
+		}
+	}
+	return ROLLUP_TIER_DAY;
+}
+
+// Copy the buckets of a tier overlapping [from, to) into result, oldest first, the
+// open bucket included. The first bucket is found with a binary search over the ring.
+// Returns the number of buckets copied (at most maxBuckets).
+uint16_t ROLLUP_query(uint8_t tierIndex, uint32_t from, uint32_t to, ROLLUP_Bucket_TypeDef* result, uint16_t maxBuckets)
+{
+	const ROLLUP_Tier_TypeDef* tier = &tiers[tierIndex];
+	const ROLLUP_Bucket_TypeDef* bucket = NULL;
+	uint16_t low = 0;
+	uint16_t high = tier->count;
+	uint16_t middle = 0;
+	uint16_t copied = 0;
+
+	/* First closed bucket ending after from */
+	while(low < high) {
+		middle = low + ((high - low) >> 1);
+		if(ROLLUP_bucketAt(tier, middle)->start + tier->width <= from) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+
+	for(; (low < tier->count) && (copied < maxBuckets); low++) {
+		bucket = ROLLUP_bucketAt(tier, low);
+		if(bucket->start >= to) {
+			return copied;
+		}
+		result[copied++] = *bucket;
+	}
+
+	if(tier->open && (copied < maxBuckets) && (tier->current.start < to) && (tier->current.start + tier->width > from)) {
+		result[copied] = tier->current;
+		result[copied].mean = (int32_t)(tier->sum / (int64_t)tier->current.count);
+		copied++;
+	}
+	return copied;
+}
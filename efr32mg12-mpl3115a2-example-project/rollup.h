@@ -0,0 +1,51 @@
+/***************************************************************************//**
+ * @file
+ * @brief rollup.h
+ ******************************************************************************/
+
+#ifndef ROLLUP_H
+#define ROLLUP_H
+
+#include <stdint.h>
+
+/*
+ * Multi-resolution history of the samples: per-minute, per-hour and per-day
+ * buckets (min, max, mean, count) in fixed size rings. Every sample updates
+ * the open bucket of each tier, a bucket goes to its ring when the sample
+ * time leaves it, so insertion is constant time. The oldest buckets of a
+ * ring are overwritten.
+ */
+
+#define ROLLUP_TIER_MINUTE (0)
+#define ROLLUP_TIER_HOUR   (1)
+#define ROLLUP_TIER_DAY    (2)
+#define ROLLUP_TIER_COUNT  (3)
+
+#ifndef ROLLUP_MINUTE_COUNT
+#define ROLLUP_MINUTE_COUNT (180) // 3 hours of minutes
+#endif
+#ifndef ROLLUP_HOUR_COUNT
+#define ROLLUP_HOUR_COUNT   (72)  // 3 days of hours
+#endif
+#ifndef ROLLUP_DAY_COUNT
+#define ROLLUP_DAY_COUNT    (56)  // 8 weeks of days
+#endif
+
+typedef struct {
+	uint32_t start;  // Start of the bucket in seconds
+	uint32_t count;  // Number of samples
+	int32_t min;
+	int32_t max;
+	int32_t mean;
+} ROLLUP_Bucket_TypeDef;
+
+// Called when a bucket of a tier is closed, e.g. every hour for the hour tier
+typedef void (*ROLLUP_CloseCallback)(uint8_t tier, const ROLLUP_Bucket_TypeDef* bucket);
+
+void ROLLUP_init(void);
+void ROLLUP_setCloseCallback(ROLLUP_CloseCallback callback);
+void ROLLUP_push(uint32_t timestamp, int32_t sample);
+uint8_t ROLLUP_selectTier(uint32_t from, uint32_t resolution);
+uint16_t ROLLUP_query(uint8_t tier, uint32_t from, uint32_t to, ROLLUP_Bucket_TypeDef* result, uint16_t maxBuckets);
+
+#endif // ROLLUP_H
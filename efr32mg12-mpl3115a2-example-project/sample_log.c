@@ -0,0 +1,496 @@
+/***************************************************************************//**
+ * @file
+ * @brief sample_log.c
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "crc.h"
+#include "sample_log.h"
+
+// The page layout has to match the flash page exactly
+typedef char SAMPLE_LOG_pageSizeCheck[(sizeof(SAMPLE_LOG_Page_TypeDef) == FLASH_DEVICE_PAGE_SIZE) ? 1 : -1];
+
+static const FLASH_DEVICE_TypeDef* flash = NULL;
+static uint32_t logStart = 0;      // Address of the first sector of the log
+static uint16_t sectorCount = 0;   // Sectors of the log
+static uint16_t writeSector = 0;   // Sector of the next page
+static uint8_t writePage = 0;      // Page of the next page in writeSector
+static uint16_t oldestSector = 0;  // Sector with the oldest pages
+static bool empty = true;          // No page was written yet
+static uint32_t nextSequence = 0;  // Sequence number of the next page
+static uint32_t eraseCounts[SAMPLE_LOG_MAX_SECTORS];
+static SAMPLE_LOG_IndexEntry_TypeDef sectorIndex[SAMPLE_LOG_MAX_SECTORS]; // Written sectors in log order
+static uint16_t indexFirst = 0;    // Entry of the oldest sector
+static uint16_t indexCount = 0;    // Entries in use
+static SAMPLE_LOG_Page_TypeDef pages[2];   // One is filled while the other may be programmed
+static SAMPLE_LOG_Page_TypeDef* pageBuffer = &pages[0]; // Page being filled
+static bool programming = false;   // Page program started, flash not powered down yet
+static bool mounted = false;       // The write position and the index are known
+
+static uint32_t SAMPLE_LOG_pageAddress(uint16_t sector, uint8_t page)
+{
+	return logStart + (uint32_t)sector * FLASH_DEVICE_SECTOR_SIZE + (uint32_t)page * FLASH_DEVICE_PAGE_SIZE;
+}
+
+// Next sector of the ring, worn out sectors are skipped
+static uint16_t SAMPLE_LOG_nextSector(uint16_t sector)
+{
+	uint16_t i;
+	uint16_t candidate = sector;
+
+	for(i = 0; i < sectorCount; i++) {
+		candidate = (candidate + 1 == sectorCount) ? 0 : candidate + 1;
+		if(eraseCounts[candidate] < SAMPLE_LOG_ERASE_LIMIT) {
+			return candidate;
+		}
+	}
+	return (sector + 1 == sectorCount) ? 0 : sector + 1;
+}
+
+static bool SAMPLE_LOG_headerErased(const SAMPLE_LOG_PageHeader_TypeDef* header)
+{
+	const uint8_t* bytes = (const uint8_t*)header;
+	uint8_t i;
+
+	for(i = 0; i < sizeof(SAMPLE_LOG_PageHeader_TypeDef); i++) {
+		if(bytes[i] != 0xFF) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void SAMPLE_LOG_clearBuffer(void)
+{
+	memset(pageBuffer, 0xFF, sizeof(*pageBuffer));
+	pageBuffer->header.count = 0;
+}
+
+// CRC-32 of the page with the crc field as erased
+static uint32_t SAMPLE_LOG_pageCrc(SAMPLE_LOG_Page_TypeDef* page)
+{
+	uint32_t saved = page->header.crc;
+	uint32_t crc = 0;
+
+	page->header.crc = 0xFFFFFFFF;
+	crc = CRC_crc32(page, sizeof(SAMPLE_LOG_Page_TypeDef));
+	page->header.crc = saved;
+	return crc;
+}
+
+// Page read back from the flash is complete and has the expected sequence number
+static bool SAMPLE_LOG_pageValid(SAMPLE_LOG_Page_TypeDef* page, uint32_t sequence)
+{
+	return (page->header.magic == SAMPLE_LOG_MAGIC) && (page->header.sequence == sequence)
+		&& (page->header.count <= SAMPLE_LOG_RECORDS_PER_PAGE) && (page->header.crc == SAMPLE_LOG_pageCrc(page));
+}
+
+// Index entry in log order, 0 is the oldest sector
+static SAMPLE_LOG_IndexEntry_TypeDef* SAMPLE_LOG_entry(uint16_t position)
+{
+	return &sectorIndex[(indexFirst + position) % SAMPLE_LOG_MAX_SECTORS];
+}
+
+// Add a sector started with the page sequence, its oldest data is dropped from the index when it was reused
+static void SAMPLE_LOG_indexAdd(uint16_t sector, uint32_t sequence, uint32_t timestamp)
+{
+	SAMPLE_LOG_IndexEntry_TypeDef* entry = NULL;
+
+	if((indexCount > 0) && (SAMPLE_LOG_entry(0)->sector == sector)) {
+		indexFirst = (indexFirst + 1) % SAMPLE_LOG_MAX_SECTORS;
+		indexCount--;
+	}
+	if(indexCount == SAMPLE_LOG_MAX_SECTORS) {
+		return;
+	}
+	entry = SAMPLE_LOG_entry(indexCount);
+	entry->sequence = sequence;
+	entry->timestamp = timestamp;
+	entry->sector = sector;
+	indexCount++;
+}
+
+// Position of the sector that starts with the page sequence, indexCount if it is not in the index
+static uint16_t SAMPLE_LOG_indexFind(uint32_t sequence)
+{
+	uint16_t low = 0;
+	uint16_t high = indexCount;
+	uint16_t middle = 0;
+
+	while(low < high) {
+		middle = (low + high) / 2;
+		if(SAMPLE_LOG_entry(middle)->sequence < sequence) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	if((low < indexCount) && (SAMPLE_LOG_entry(low)->sequence == sequence)) {
+		return low;
+	}
+	return indexCount;
+}
+
+// Written pages of the sector at the index position
+static uint8_t SAMPLE_LOG_pagesWritten(uint16_t position)
+{
+	if((position == indexCount - 1) && (SAMPLE_LOG_entry(position)->sector == writeSector) && (writePage > 0)) {
+		return writePage;
+	}
+	return SAMPLE_LOG_PAGES_PER_SECTOR;
+}
+
+// Find the newest page (head) and the oldest sector from the first page header of every sector
+static void SAMPLE_LOG_mount(void)
+{
+	SAMPLE_LOG_PageHeader_TypeDef header;
+	SAMPLE_LOG_IndexEntry_TypeDef entry;
+	SAMPLE_LOG_Record_TypeDef first;
+	uint32_t newest = 0;
+	uint32_t oldest = 0;
+	uint32_t maxErase = 0;
+	uint16_t headSector = 0;
+	uint16_t sector;
+	uint16_t i;
+	uint16_t j;
+	uint8_t page;
+	bool known[SAMPLE_LOG_MAX_SECTORS];
+
+	empty = true;
+	indexFirst = 0;
+	indexCount = 0;
+	for(sector = 0; sector < sectorCount; sector++) {
+		flash->read(SAMPLE_LOG_pageAddress(sector, 0), (uint8_t*)&header, sizeof(header));
+		known[sector] = (header.magic == SAMPLE_LOG_MAGIC);
+		if(!known[sector]) {
+			continue;
+		}
+		flash->read(SAMPLE_LOG_pageAddress(sector, 0) + sizeof(header), (uint8_t*)&first, sizeof(first));
+		sectorIndex[indexCount].sequence = header.sequence;
+		sectorIndex[indexCount].timestamp = first.timestamp;
+		sectorIndex[indexCount].sector = sector;
+		indexCount++;
+		eraseCounts[sector] = header.eraseCount;
+		if(header.eraseCount > maxErase) {
+			maxErase = header.eraseCount;
+		}
+		if(empty || (header.sequence > newest)) {
+			newest = header.sequence;
+			headSector = sector;
+		}
+		if(empty || (header.sequence < oldest)) {
+			oldest = header.sequence;
+			oldestSector = sector;
+		}
+		empty = false;
+	}
+
+	/* Index in log order, this runs once at boot */
+	for(i = 1; i < indexCount; i++) {
+		entry = sectorIndex[i];
+		for(j = i; (j > 0) && (sectorIndex[j - 1].sequence > entry.sequence); j--) {
+			sectorIndex[j] = sectorIndex[j - 1];
+		}
+		sectorIndex[j] = entry;
+	}
+
+	/* Sectors without a valid first page: assume the most worn */
+	for(sector = 0; sector < sectorCount; sector++) {
+		if(!known[sector]) {
+			eraseCounts[sector] = maxErase;
+		}
+	}
+
+	if(empty) {
+		writeSector = 0;
+		writePage = 0;
+		oldestSector = 0;
+		nextSequence = 0;
+		return;
+	}
+
+	/* First free page of the head sector. A torn page keeps its sequence number,
+	   so the pages of a sector are always numbered from the first one in order. */
+	writeSector = headSector;
+	for(page = 1; page < SAMPLE_LOG_PAGES_PER_SECTOR; page++) {
+		flash->read(SAMPLE_LOG_pageAddress(headSector, page), (uint8_t*)&header, sizeof(header));
+		if(SAMPLE_LOG_headerErased(&header)) {
+			break;
+		}
+	}
+	nextSequence = newest + page;
+	writePage = page;
+	if(writePage == SAMPLE_LOG_PAGES_PER_SECTOR) {
+		writePage = 0;
+		writeSector = SAMPLE_LOG_nextSector(headSector);
+	}
+}
+
+// Mount on the first use of the flash
+static void SAMPLE_LOG_requireMount(void)
+{
+	if(mounted) {
+		return;
+	}
+	flash->powerUp();
+	SAMPLE_LOG_mount();
+	flash->powerDown();
+	mounted = true;
+}
+
+// Use size bytes from start (sector aligned) of the device and continue the log found there
+void SAMPLE_LOG_init(const FLASH_DEVICE_TypeDef* device, uint32_t start, uint32_t size)
+{
+	flash = device;
+	logStart = start;
+	sectorCount = (uint16_t)(size / FLASH_DEVICE_SECTOR_SIZE);
+	if(sectorCount > SAMPLE_LOG_MAX_SECTORS) {
+		sectorCount = SAMPLE_LOG_MAX_SECTORS;
+	}
+	SAMPLE_LOG_clearBuffer();
+	mounted = false;
+}
+
+// Add a sample, the flash is only accessed when the RAM page is full
+void SAMPLE_LOG_append(uint32_t timestamp, uint32_t pressure, int16_t temperature)
+{
+	SAMPLE_LOG_Record_TypeDef* record = &pageBuffer->records[pageBuffer->header.count];
+
+	record->timestamp = timestamp;
+	record->data = SAMPLE_LOG_PACK(pressure, temperature);
+	pageBuffer->header.count++;
+	if(pageBuffer->header.count == SAMPLE_LOG_RECORDS_PER_PAGE) {
+		SAMPLE_LOG_flush();
+	}
+}
+
+// Start programming the RAM page (also a partially filled one) in one page program
+// operation, the next samples go to the other page while the flash is busy
+void SAMPLE_LOG_flush(void)
+{
+	uint32_t address = 0;
+
+	if(pageBuffer->header.count == 0) {
+		return;
+	}
+	SAMPLE_LOG_requireMount();
+
+	address = SAMPLE_LOG_pageAddress(writeSector, writePage);
+	flash->powerUp();
+	if(writePage == 0) {
+		/* The ring wrapped: the oldest sector is reused */
+		if(!empty && (writeSector == oldestSector)) {
+			oldestSector = SAMPLE_LOG_nextSector(oldestSector);
+		}
+		flash->eraseSector(address);
+		eraseCounts[writeSector]++;
+		SAMPLE_LOG_indexAdd(writeSector, nextSequence, pageBuffer->records[0].timestamp);
+	}
+
+	pageBuffer->header.magic = SAMPLE_LOG_MAGIC;
+	pageBuffer->header.sequence = nextSequence++;
+	pageBuffer->header.eraseCount = eraseCounts[writeSector];
+	pageBuffer->header.crc = SAMPLE_LOG_pageCrc(pageBuffer);
+	flash->programPage(address, (const uint8_t*)pageBuffer, FLASH_DEVICE_PAGE_SIZE);
+	programming = true;
+
+	empty = false;
+	writePage++;
+	if(writePage == SAMPLE_LOG_PAGES_PER_SECTOR) {
+		writePage = 0;
+		writeSector = SAMPLE_LOG_nextSector(writeSector);
+	}
+	pageBuffer = (pageBuffer == &pages[0]) ? &pages[1] : &pages[0];
+	SAMPLE_LOG_clearBuffer();
+}
+
+// Power down the flash when the page program has finished, call it from the main loop.
+// Returns true while the program is still running.
+bool SAMPLE_LOG_process(void)
+{
+	if(programming && !flash->busy()) {
+		flash->powerDown();
+		programming = false;
+	}
+	return programming;
+}
+
+// Read a page of the log by its index from the start of the log, returns false if it holds no samples or it is corrupted
+bool SAMPLE_LOG_readPage(uint32_t page, SAMPLE_LOG_Page_TypeDef* result)
+{
+	flash->powerUp();
+	flash->read(logStart + page * FLASH_DEVICE_PAGE_SIZE, (uint8_t*)result, FLASH_DEVICE_PAGE_SIZE);
+	flash->powerDown();
+	programming = false;
+	return (result->header.magic == SAMPLE_LOG_MAGIC) && (result->header.count <= SAMPLE_LOG_RECORDS_PER_PAGE)
+		&& (result->header.crc == SAMPLE_LOG_pageCrc(result));
+}
+
+// Timestamp of the newest sample in the RAM page or in the flash, 0 if the log is empty. A clock
+// that starts at 0 after a reset continues from it, the time index needs ascending timestamps.
+uint32_t SAMPLE_LOG_getNewestTimestamp(void)
+{
+	SAMPLE_LOG_Page_TypeDef* page = (pageBuffer == &pages[0]) ? &pages[1] : &pages[0];
+	const SAMPLE_LOG_IndexEntry_TypeDef* entry = NULL;
+	uint32_t newest = 0;
+	uint16_t position = 0;
+	uint8_t written = 0;
+	bool found = false;
+
+	if(pageBuffer->header.count > 0) {
+		return pageBuffer->records[pageBuffer->header.count - 1].timestamp;
+	}
+	SAMPLE_LOG_requireMount();
+
+	/* Newest valid page, torn pages are skipped like in the reads */
+	flash->powerUp();
+	for(position = indexCount; !found && (position > 0); position--) {
+		entry = SAMPLE_LOG_entry(position - 1);
+		for(written = SAMPLE_LOG_pagesWritten(position - 1); !found && (written > 0); written--) {
+			flash->read(SAMPLE_LOG_pageAddress(entry->sector, written - 1), (uint8_t*)page, FLASH_DEVICE_PAGE_SIZE);
+			if(SAMPLE_LOG_pageValid(page, entry->sequence + written - 1) && (page->header.count > 0)) {
+				newest = page->records[page->header.count - 1].timestamp;
+				found = true;
+			}
+		}
+	}
+	flash->powerDown();
+	programming = false;
+	return newest;
+}
+
+uint32_t SAMPLE_LOG_getEraseCount(uint16_t sector)
+{
+	SAMPLE_LOG_requireMount();
+	return (sector < sectorCount) ? eraseCounts[sector] : 0;
+}
+
+// Position the cursor on the first sample at or after from, in O(log n) page reads:
+// binary search over the sector index in RAM, then over the pages of the sector
+bool SAMPLE_LOG_seek(SAMPLE_LOG_Cursor_TypeDef* cursor, uint32_t from, uint32_t to)
+{
+	SAMPLE_LOG_PageHeader_TypeDef header;
+	SAMPLE_LOG_Record_TypeDef first;
+	uint16_t low = 0;
+	uint16_t high = 0;
+	uint16_t middle = 0;
+	uint16_t position = 0;
+	uint32_t address = 0;
+
+	SAMPLE_LOG_requireMount();
+	cursor->from = from;
+	cursor->to = to;
+	cursor->page = 0;
+	cursor->record = 0;
+	if(indexCount == 0) {
+		cursor->sequence = nextSequence;
+		return false;
+	}
+
+	/* Last sector starting at or before from */
+	high = indexCount - 1;
+	while(low < high) {
+		middle = (uint16_t)((low + high + 1) / 2);
+		if(SAMPLE_LOG_entry(middle)->timestamp <= from) {
+			low = middle;
+		}
+		else {
+			high = middle - 1;
+		}
+	}
+	position = low;
+	cursor->sequence = SAMPLE_LOG_entry(position)->sequence;
+
+	/* Last page of the sector starting at or before from */
+	low = 0;
+	high = SAMPLE_LOG_pagesWritten(position) - 1;
+	flash->powerUp();
+	while(low < high) {
+		middle = (uint16_t)((low + high + 1) / 2);
+		address = SAMPLE_LOG_pageAddress(SAMPLE_LOG_entry(position)->sector, (uint8_t)middle);
+		flash->read(address, (uint8_t*)&header, sizeof(header));
+		flash->read(address + sizeof(header), (uint8_t*)&first, sizeof(first));
+		if((header.magic == SAMPLE_LOG_MAGIC) && (first.timestamp <= from)) {
+			low = middle;
+		}
+		else {
+			high = middle - 1;
+		}
+	}
+	flash->powerDown();
+	programming = false;
+	cursor->page = (uint8_t)low;
+	return true;
+}
+
+// Stream the samples of the cursor range to the sink (BLE or UART buffer) until the
+// sink is full, the end of the range or the end of the log. Returns the streamed
+// samples. The cursor stays on the first sample not taken, call it again to resume.
+uint32_t SAMPLE_LOG_readRange(SAMPLE_LOG_Cursor_TypeDef* cursor, SAMPLE_LOG_Sink sink, void* context)
+{
+	SAMPLE_LOG_Page_TypeDef* page = (pageBuffer == &pages[0]) ? &pages[1] : &pages[0];
+	SAMPLE_LOG_Record_TypeDef* record = NULL;
+	uint32_t streamed = 0;
+	uint16_t position = 0;
+	bool done = false;
+	bool valid = false;
+
+	SAMPLE_LOG_requireMount();
+	position = SAMPLE_LOG_indexFind(cursor->sequence);
+	if(position == indexCount) {
+		if((indexCount == 0) || (cursor->sequence > SAMPLE_LOG_entry(indexCount - 1)->sequence)) {
+			return 0; // Nothing new since the last call
+		}
+		/* The sector was overwritten, continue with the oldest one */
+		position = 0;
+		cursor->sequence = SAMPLE_LOG_entry(0)->sequence;
+		cursor->page = 0;
+		cursor->record = 0;
+	}
+
+	/* The other RAM page is free once the pending page program has finished */
+	flash->powerUp();
+	while(!done && (position < indexCount)) {
+		if(cursor->page >= SAMPLE_LOG_pagesWritten(position)) {
+			break; // Not written yet
+		}
+		flash->read(SAMPLE_LOG_pageAddress(SAMPLE_LOG_entry(position)->sector, cursor->page), (uint8_t*)page, FLASH_DEVICE_PAGE_SIZE);
+		// A torn or corrupted page is skipped, the next ones are still read
+		valid = SAMPLE_LOG_pageValid(page, cursor->sequence + cursor->page);
+		for(; valid && (cursor->record < page->header.count); cursor->record++) {
+			record = &page->records[cursor->record];
+			if(record->timestamp > cursor->to) {
+				done = true;
+				break;
+			}
+			if(record->timestamp < cursor->from) {
+				continue;
+			}
+			if(!sink(record, context)) {
+				done = true;
+				break;
+			}
+			streamed++;
+		}
+		if(done) {
+			break;
+		}
+		cursor->record = 0;
+		cursor->page++;
+		if(cursor->page == SAMPLE_LOG_PAGES_PER_SECTOR) {
+			cursor->page = 0;
+			position++;
+			if(position < indexCount) {
+				cursor->sequence = SAMPLE_LOG_entry(position)->sequence;
+			}
+			else {
+				cursor->sequence += SAMPLE_LOG_PAGES_PER_SECTOR;
+			}
+		}
+	}
+	flash->powerDown();
+	programming = false;
+	return streamed;
+}
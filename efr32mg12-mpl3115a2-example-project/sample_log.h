@@ -0,0 +1,95 @@
+/***************************************************************************//**
+ * @file
+ * @brief sample_log.h
+ ******************************************************************************/
+
+#ifndef SAMPLE_LOG_H
+#define SAMPLE_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "flash_device.h"
+
+/*
+ * Append-only sample log on a NOR flash device. Samples are collected in a
+ * RAM page and the page is programmed in one operation when it is full. The
+ * program runs in the background (two RAM pages), SAMPLE_LOG_process() puts
+ * the flash back into power-down when it has finished. The sectors are used as a
+ * ring, the oldest sector is erased when the log wraps. Every page header
+ * carries the erase count of its sector, sectors over SAMPLE_LOG_ERASE_LIMIT
+ * erases are skipped by the rotation.
+ *
+ * A RAM index holds the first timestamp of every written sector in log
+ * order. It is rebuilt at mount from the first page of the sectors, which is
+ * read anyway, so it needs no separate checkpoint in the flash. The log is
+ * mounted on its first flush or read, not in SAMPLE_LOG_init: a boot that
+ * only appends to the RAM page (EM4 wakeup) does not touch the flash. A time range
+ * is found with a binary search over the index and over the pages of one
+ * sector, then the samples are streamed to a sink with a resumable cursor.
+ * Samples still in RAM are not included. A page torn by a power loss keeps
+ * its sequence number and is skipped, the reads continue after it.
+ * The timestamps have to go up along the log: after a reset the clock
+ * continues from SAMPLE_LOG_getNewestTimestamp().
+ */
+
+#define SAMPLE_LOG_MAGIC            (0x4C54) // Valid page header (0x4C53: pages without CRC)
+#define SAMPLE_LOG_RECORDS_PER_PAGE (30)
+#define SAMPLE_LOG_PAGES_PER_SECTOR (FLASH_DEVICE_SECTOR_SIZE / FLASH_DEVICE_PAGE_SIZE)
+#ifndef SAMPLE_LOG_MAX_SECTORS
+#define SAMPLE_LOG_MAX_SECTORS      (256)    // 1 MB, the whole MX25 flash
+#endif
+#ifndef SAMPLE_LOG_ERASE_LIMIT
+#define SAMPLE_LOG_ERASE_LIMIT      (100000) // Rated endurance of a sector
+#endif
+
+typedef struct {
+	uint32_t timestamp; // Seconds
+	uint32_t data;      // Pressure in Q18.2 Pascal in bits 31..12, temperature in Q8.4 Celsius in bits 11..0
+} SAMPLE_LOG_Record_TypeDef;
+
+typedef struct {
+	uint16_t magic;      // SAMPLE_LOG_MAGIC
+	uint16_t count;      // Records in the page
+	uint32_t sequence;   // Page sequence number, increments with every page
+	uint32_t eraseCount; // Erase count of the sector of the page
+	uint32_t crc;        // CRC-32 of the page, calculated with 0xFFFFFFFF in this field
+} SAMPLE_LOG_PageHeader_TypeDef;
+
+typedef struct {
+	SAMPLE_LOG_PageHeader_TypeDef header;
+	SAMPLE_LOG_Record_TypeDef records[SAMPLE_LOG_RECORDS_PER_PAGE];
+} SAMPLE_LOG_Page_TypeDef; // One flash page
+
+typedef struct {
+	uint32_t sequence;  // Sequence number of the first page
+	uint32_t timestamp; // First sample of the sector
+	uint16_t sector;
+} SAMPLE_LOG_IndexEntry_TypeDef;
+
+typedef struct {
+	uint32_t from;      // Range of the timestamps in seconds
+	uint32_t to;
+	uint32_t sequence;  // Sequence number of the first page of the sector
+	uint8_t page;       // Page in the sector
+	uint8_t record;     // Record in the page
+} SAMPLE_LOG_Cursor_TypeDef;
+
+// Takes one sample, returns false if the output buffer is full (the sample is not taken)
+typedef bool (*SAMPLE_LOG_Sink)(const SAMPLE_LOG_Record_TypeDef* record, void* context);
+
+#define SAMPLE_LOG_PACK(pressure, temperature) ((((uint32_t)(pressure)) << 12) | (((uint32_t)(temperature)) & 0xFFF))
+#define SAMPLE_LOG_PRESSURE(data)              ((data) >> 12)
+#define SAMPLE_LOG_TEMPERATURE(data)           ((int16_t)((int16_t)((data) << 4) >> 4))
+
+void SAMPLE_LOG_init(const FLASH_DEVICE_TypeDef* device, uint32_t start, uint32_t size);
+void SAMPLE_LOG_append(uint32_t timestamp, uint32_t pressure, int16_t temperature);
+void SAMPLE_LOG_flush(void);
+bool SAMPLE_LOG_process(void);
+bool SAMPLE_LOG_readPage(uint32_t page, SAMPLE_LOG_Page_TypeDef* result);
+uint32_t SAMPLE_LOG_getNewestTimestamp(void);
+uint32_t SAMPLE_LOG_getEraseCount(uint16_t sector);
+bool SAMPLE_LOG_seek(SAMPLE_LOG_Cursor_TypeDef* cursor, uint32_t from, uint32_t to);
+uint32_t SAMPLE_LOG_readRange(SAMPLE_LOG_Cursor_TypeDef* cursor, SAMPLE_LOG_Sink sink, void* context);
+
+#endif // SAMPLE_LOG_H
@@ -0,0 +1,349 @@
+/***************************************************************************//**
+ * @file
+ * @brief seal.c
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "seal.h"
+
+#if !defined(SEAL_SOFTWARE_ONLY)
+#include "em_device.h"
+#endif
+
+#if defined(CRYPTO_PRESENT)
+#include "em_cmu.h"
+#include "em_crypto.h"
+#endif
+
+#define SEAL_BLOCK_SIZE (16)
+
+static const uint8_t sbox[256] = {
+	0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
+	0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0, 0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
+	0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+	0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
+	0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0, 0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
+	0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+	0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
+	0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5, 0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
+	0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+	0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
+	0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C, 0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
+	0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+	0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
+	0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E, 0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
+	0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+	0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16
+};
+
+static uint8_t sealKey[SEAL_KEY_SIZE];
+static uint8_t roundKeys[11 * SEAL_BLOCK_SIZE]; // Expanded key of the software AES
+static bool hardware = false; // CRYPTO gives the same results as the software
+
+static uint8_t SEAL_xtime(uint8_t value)
+{
+	return (uint8_t)((value << 1) ^ ((value & 0x80) ? 0x1B : 0x00));
+}
+
+static void SEAL_expandKey(const uint8_t* key)
+{
+	uint8_t rcon = 0x01;
+	uint8_t temp[4];
+	uint8_t i;
+	uint8_t j;
+
+	memcpy(roundKeys, key, SEAL_KEY_SIZE);
+	for(i = 4; i < 44; i++) {
+		memcpy(temp, &roundKeys[(i - 1) * 4], 4);
+		if((i % 4) == 0) {
+			/* RotWord, SubWord and the round constant */
+			uint8_t first = temp[0];
+
+			temp[0] = (uint8_t)(sbox[temp[1]] ^ rcon);
+			temp[1] = sbox[temp[2]];
+			temp[2] = sbox[temp[3]];
+			temp[3] = sbox[first];
+			rcon = SEAL_xtime(rcon);
+		}
+		for(j = 0; j < 4; j++) {
+			roundKeys[i * 4 + j] = roundKeys[(i - 4) * 4 + j] ^ temp[j];
+		}
+	}
+}
+
+// AES-128 encryption of one block in software, in place
+static void SEAL_encryptBlockSoftware(uint8_t* block)
+{
+	uint8_t round;
+	uint8_t i;
+	uint8_t temp;
+	uint8_t column[4];
+	uint8_t all;
+
+	for(i = 0; i < SEAL_BLOCK_SIZE; i++) {
+		block[i] ^= roundKeys[i];
+	}
+	for(round = 1; round <= 10; round++) {
+		/* SubBytes */
+		for(i = 0; i < SEAL_BLOCK_SIZE; i++) {
+			block[i] = sbox[block[i]];
+		}
+		/* ShiftRows, the state is column major */
+		temp = block[1]; block[1] = block[5]; block[5] = block[9]; block[9] = block[13]; block[13] = temp;
+		temp = block[2]; block[2] = block[10]; block[10] = temp;
+		temp = block[6]; block[6] = block[14]; block[14] = temp;
+		temp = block[15]; block[15] = block[11]; block[11] = block[7]; block[7] = block[3]; block[3] = temp;
+		/* MixColumns, not in the last round */
+		if(round < 10) {
+			for(i = 0; i < SEAL_BLOCK_SIZE; i += 4) {
+				memcpy(column, &block[i], 4);
+				all = column[0] ^ column[1] ^ column[2] ^ column[3];
+				block[i] ^= all ^ SEAL_xtime(column[0] ^ column[1]);
+				block[i + 1] ^= all ^ SEAL_xtime(column[1] ^ column[2]);
+				block[i + 2] ^= all ^ SEAL_xtime(column[2] ^ column[3]);
+				block[i + 3] ^= all ^ SEAL_xtime(column[3] ^ column[0]);
+			}
+		}
+		for(i = 0; i < SEAL_BLOCK_SIZE; i++) {
+			block[i] ^= roundKeys[round * SEAL_BLOCK_SIZE + i];
+		}
+	}
+}
+
+static void SEAL_encryptBlock(uint8_t* block)
+{
+#if defined(CRYPTO_PRESENT)
+	if(hardware) {
+		CRYPTO_AES_ECB128(CRYPTO, block, block, SEAL_BLOCK_SIZE, sealKey, true);
+		return;
+	}
+#endif
+	SEAL_encryptBlockSoftware(block);
+}
+
+// CBC-MAC step over up to one block of data, a short block is zero padded
+static void SEAL_macUpdate(uint8_t* mac, const uint8_t* data, uint8_t length)
+{
+	uint8_t i;
+
+	for(i = 0; i < length; i++) {
+		mac[i] ^= data[i];
+	}
+	SEAL_encryptBlock(mac);
+}
+
+// CBC-MAC of B0, the length prefixed associated data and the plain text
+static void SEAL_mac(const uint8_t* nonce, const uint8_t* aad, uint16_t aadLength, const uint8_t* data, uint16_t length, uint8_t* mac)
+{
+	uint8_t block[SEAL_BLOCK_SIZE];
+	uint16_t done = 0;
+	uint8_t chunk = 0;
+
+	/* B0: flags (Adata, M' = (M - 2) / 2, L' = L - 1), nonce, message length */
+	mac[0] = (uint8_t)(((aadLength > 0) ? 0x40 : 0x00) | (((SEAL_TAG_SIZE - 2) / 2) << 3) | (15 - SEAL_NONCE_SIZE - 1));
+	memcpy(&mac[1], nonce, SEAL_NONCE_SIZE);
+	mac[14] = (uint8_t)(length >> 8);
+	mac[15] = (uint8_t)length;
+	SEAL_encryptBlock(mac);
+
+	if(aadLength > 0) {
+		/* The first block starts with the 2 byte length of the associated data */
+		memset(block, 0, sizeof(block));
+		block[0] = (uint8_t)(aadLength >> 8);
+		block[1] = (uint8_t)aadLength;
+		chunk = (aadLength < SEAL_BLOCK_SIZE - 2) ? (uint8_t)aadLength : SEAL_BLOCK_SIZE - 2;
+		memcpy(&block[2], aad, chunk);
+		SEAL_macUpdate(mac, block, SEAL_BLOCK_SIZE);
+		for(done = chunk; done < aadLength; done += chunk) {
+			chunk = (aadLength - done < SEAL_BLOCK_SIZE) ? (uint8_t)(aadLength - done) : SEAL_BLOCK_SIZE;
+			SEAL_macUpdate(mac, &aad[done], chunk);
+		}
+	}
+	for(done = 0; done < length; done += chunk) {
+		chunk = (length - done < SEAL_BLOCK_SIZE) ? (uint8_t)(length - done) : SEAL_BLOCK_SIZE;
+		SEAL_macUpdate(mac, &data[done], chunk);
+	}
+}
+
+// Counter block A_i: flags (L' = L - 1), nonce, counter
+static void SEAL_counter(uint8_t* counter, const uint8_t* nonce, uint16_t value)
+{
+	counter[0] = (uint8_t)(15 - SEAL_NONCE_SIZE - 1);
+	memcpy(&counter[1], nonce, SEAL_NONCE_SIZE);
+	counter[14] = (uint8_t)(value >> 8);
+	counter[15] = (uint8_t)value;
+}
+
+#if defined(CRYPTO_PRESENT)
+// Only the 2 byte counter field changes, a batch is shorter than 2^16 blocks
+static void SEAL_counterIncrement(uint8_t* counter)
+{
+	if(++counter[15] == 0) {
+		counter[14]++;
+	}
+}
+#endif
+
+// CTR encryption of the data with the counters from 1, the same operation decrypts
+static void SEAL_ctr(const uint8_t* nonce, uint8_t* data, uint16_t length)
+{
+	uint8_t counter[SEAL_BLOCK_SIZE];
+	uint8_t keystream[SEAL_BLOCK_SIZE];
+	uint16_t done = 0;
+	uint8_t i;
+
+	SEAL_counter(counter, nonce, 1);
+#if defined(CRYPTO_PRESENT)
+	if(hardware && (length >= SEAL_BLOCK_SIZE)) {
+		/* Full blocks in one call, the counter is left on the next block */
+		done = length & ~(SEAL_BLOCK_SIZE - 1);
+		CRYPTO_AES_CTR128(CRYPTO, data, data, done, sealKey, counter, SEAL_counterIncrement);
+	}
+#endif
+	while(done < length) {
+		memcpy(keystream, counter, SEAL_BLOCK_SIZE);
+		SEAL_encryptBlock(keystream);
+		for(i = 0; (i < SEAL_BLOCK_SIZE) && (done < length); i++, done++) {
+			data[done] ^= keystream[i];
+		}
+		if(++counter[15] == 0) {
+			counter[14]++;
+		}
+	}
+}
+
+// Encrypted CBC-MAC: the tag
+static void SEAL_tag(const uint8_t* nonce, uint8_t* mac)
+{
+	uint8_t s0[SEAL_BLOCK_SIZE];
+	uint8_t i;
+
+	SEAL_counter(s0, nonce, 0);
+	SEAL_encryptBlock(s0);
+	for(i = 0; i < SEAL_TAG_SIZE; i++) {
+		mac[i] ^= s0[i];
+	}
+}
+
+static void SEAL_loadKey(const uint8_t* key)
+{
+	memcpy(sealKey, key, SEAL_KEY_SIZE);
+	SEAL_expandKey(key);
+}
+
+#if defined(CRYPTO_PRESENT)
+// Check every CRYPTO path of SEAL_encrypt with the hardware enabled: RFC 3610 packet vector #1
+// (ECB for the CBC-MAC, one CTR128 block, then the software tail from the written back counter),
+// then several CTR128 blocks (the counter increment of the peripheral) against the software AES
+static bool SEAL_checkHardware(void)
+{
+	static const uint8_t rfcKey[SEAL_KEY_SIZE] = {
+		0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF
+	};
+	static const uint8_t rfcNonce[SEAL_NONCE_SIZE] = {
+		0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5
+	};
+	static const uint8_t rfcResult[23 + SEAL_TAG_SIZE] = {
+		0x58, 0x8C, 0x97, 0x9A, 0x61, 0xC6, 0x63, 0xD2, 0xF0, 0x66, 0xD0, 0xC2, 0xC0, 0xF9, 0x89, 0x80,
+		0x6D, 0x5F, 0x6B, 0x61, 0xDA, 0xC3, 0x84, 0x17, 0xE8, 0xD1, 0x2C, 0xFD, 0xF9, 0x26, 0xE0
+	};
+	uint8_t aad[8];
+	uint8_t data[4 * SEAL_BLOCK_SIZE + 7];
+	uint8_t software[sizeof(data)];
+	uint8_t tag[SEAL_TAG_SIZE];
+	uint8_t softwareTag[SEAL_TAG_SIZE];
+	uint8_t i;
+
+	for(i = 0; i < sizeof(aad); i++) {
+		aad[i] = i;
+	}
+	for(i = 0; i < 23; i++) {
+		data[i] = (uint8_t)(sizeof(aad) + i);
+	}
+	SEAL_loadKey(rfcKey);
+	hardware = true;
+	SEAL_encrypt(rfcNonce, aad, sizeof(aad), data, 23, tag);
+	if((memcmp(data, rfcResult, 23) != 0) || (memcmp(tag, &rfcResult[23], SEAL_TAG_SIZE) != 0)) {
+		return false;
+	}
+
+	for(i = 0; i < sizeof(data); i++) {
+		data[i] = (uint8_t)(i * 29 + 3);
+		software[i] = data[i];
+	}
+	SEAL_encrypt(rfcNonce, aad, sizeof(aad), data, sizeof(data), tag);
+	hardware = false;
+	SEAL_encrypt(rfcNonce, aad, sizeof(aad), software, sizeof(software), softwareTag);
+	return (memcmp(data, software, sizeof(data)) == 0) && (memcmp(tag, softwareTag, SEAL_TAG_SIZE) == 0);
+}
+#endif
+
+// Check the CRYPTO peripheral against the RFC 3610 vector and the software AES, then load the key
+void SEAL_init(const uint8_t* key)
+{
+	hardware = false;
+#if defined(CRYPTO_PRESENT)
+	CMU_ClockEnable(cmuClock_CRYPTO, true);
+	hardware = SEAL_checkHardware();
+#endif
+	SEAL_loadKey(key);
+}
+
+// Big endian device identifier (8 bytes), batch counter (4 bytes) and a 0 byte
+void SEAL_makeNonce(uint8_t* nonce, uint64_t deviceId, uint32_t counter)
+{
+	uint8_t i;
+
+	for(i = 0; i < 8; i++) {
+		nonce[i] = (uint8_t)(deviceId >> (56 - 8 * i));
+	}
+	for(i = 0; i < 4; i++) {
+		nonce[8 + i] = (uint8_t)(counter >> (24 - 8 * i));
+	}
+	nonce[12] = 0;
+}
+
+// Encrypt the batch in place and calculate its tag, the associated data (header) is authenticated only
+void SEAL_encrypt(const uint8_t* nonce, const uint8_t* aad, uint16_t aadLength, uint8_t* data, uint16_t length, uint8_t* tag)
+{
+	uint8_t mac[SEAL_BLOCK_SIZE];
+
+	if(aadLength > SEAL_MAX_AAD) {
+		aadLength = SEAL_MAX_AAD;
+	}
+	SEAL_mac(nonce, aad, aadLength, data, length, mac);
+	SEAL_ctr(nonce, data, length);
+	SEAL_tag(nonce, mac);
+	memcpy(tag, mac, SEAL_TAG_SIZE);
+}
+
+// Decrypt the batch in place, returns false (and wipes the data) if the tag does not match
+bool SEAL_decrypt(const uint8_t* nonce, const uint8_t* aad, uint16_t aadLength, uint8_t* data, uint16_t length, const uint8_t* tag)
+{
+	uint8_t mac[SEAL_BLOCK_SIZE];
+	uint8_t difference = 0;
+	uint8_t i;
+
+	if(aadLength > SEAL_MAX_AAD) {
+		aadLength = SEAL_MAX_AAD;
+	}
+	SEAL_ctr(nonce, data, length);
+	SEAL_mac(nonce, aad, aadLength, data, length, mac);
+	SEAL_tag(nonce, mac);
+	/* Constant time comparison */
+	for(i = 0; i < SEAL_TAG_SIZE; i++) {
+		difference |= mac[i] ^ tag[i];
+	}
+	if(difference != 0) {
+		memset(data, 0, length);
+		return false;
+	}
+	return true;
+}
+
+bool SEAL_isHardware(void)
+{
+	return hardware;
+}
@@ -0,0 +1,36 @@
+/***************************************************************************//**
+ * @file
+ * @brief seal.h
+ ******************************************************************************/
+
+#ifndef SEAL_H
+#define SEAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Authenticated encryption of telemetry batches with AES-128-CCM (RFC 3610,
+ * 13 byte nonce, 8 byte tag). A whole batch (for example a codec block) is
+ * sealed at once: the CRYPTO peripheral runs the CTR part over the full
+ * blocks in one call and the CBC-MAC block by block. The software AES is the
+ * fallback and the host implementation (SEAL_SOFTWARE_ONLY). SEAL_init()
+ * checks the peripheral with RFC 3610 packet vector #1 and against the
+ * software AES over several CTR blocks, and only uses it if both match.
+ *
+ * The nonce must never repeat with the same key: SEAL_makeNonce() builds it
+ * from a device identifier and a batch counter.
+ */
+
+#define SEAL_KEY_SIZE   (16)
+#define SEAL_NONCE_SIZE (13)
+#define SEAL_TAG_SIZE   (8)
+#define SEAL_MAX_AAD    (0xFEFF) // Longer associated data needs a longer length field
+
+void SEAL_init(const uint8_t* key);
+void SEAL_makeNonce(uint8_t* nonce, uint64_t deviceId, uint32_t counter);
+void SEAL_encrypt(const uint8_t* nonce, const uint8_t* aad, uint16_t aadLength, uint8_t* data, uint16_t length, uint8_t* tag);
+bool SEAL_decrypt(const uint8_t* nonce, const uint8_t* aad, uint16_t aadLength, uint8_t* data, uint16_t length, const uint8_t* tag);
+bool SEAL_isHardware(void);
+
+#endif // SEAL_H
@@ -0,0 +1,112 @@
+/***************************************************************************//**
+ * @file
+ * @brief tables.c
+ ******************************************************************************/
+
+#include <stddef.h>
+
+#include "thunderboard/rfs/rfs.h"
+
+#include "altitude.h"
+#include "crc.h"
+#include "tables.h"
+
+static const TABLES_CalibrationPoint_TypeDef* calibration = NULL;
+static uint16_t calibrationCount = 0;
+static const GOVERNOR_Profile_TypeDef* profiles = NULL;
+static uint8_t profileCount = 0;
+
+// Entries of a valid table file in the flash, NULL if the file is missing or invalid
+static const void* TABLES_open(const char* name, uint16_t type, uint32_t entrySize, const TABLES_Header_TypeDef** header, bool verify)
+{
+	RFS_FileHandle file;
+	const uint8_t* data = NULL;
+	int32_t length = 0;
+
+	if(RFS_fileOpen(&file, (uint8_t*)name) < 0) {
+		return NULL;
+	}
+	data = RFS_fileGetRawData(&file);
+	length = RFS_getFileLength(&file);
+	if((data == NULL) || (length < (int32_t)sizeof(TABLES_Header_TypeDef)) || (((uintptr_t)data & 3) != 0)) {
+		return NULL;
+	}
+	*header = (const TABLES_Header_TypeDef*)data;
+	if(((*header)->magic != TABLES_MAGIC) || ((*header)->type != type)
+		|| ((uint32_t)length != sizeof(TABLES_Header_TypeDef) + (*header)->count * entrySize)
+		|| (verify && ((*header)->crc != CRC_crc32(data + sizeof(TABLES_Header_TypeDef), (*header)->count * entrySize)))) {
+		return NULL;
+	}
+	return data + sizeof(TABLES_Header_TypeDef);
+}
+
+// Check the table files and hand them to the modules, call it after CRC_init().
+// verify: check the CRC-32 of the entries, false after a warm boot.
+void TABLES_init(bool verify)
+{
+	const TABLES_Header_TypeDef* header = NULL;
+	const int32_t* altitudes = NULL;
+
+	altitudes = TABLES_open("altitude.tbl", TABLES_TYPE_ALTITUDE, sizeof(int32_t), &header, verify);
+	if(altitudes != NULL) {
+		ALTITUDE_setTable(altitudes, header->count, (uint8_t)header->parameter);
+	}
+
+	calibration = TABLES_open("calibration.tbl", TABLES_TYPE_CALIBRATION, sizeof(TABLES_CalibrationPoint_TypeDef), &header, verify);
+	calibrationCount = (calibration != NULL) ? header->count : 0;
+
+	profiles = TABLES_open("governor.tbl", TABLES_TYPE_GOVERNOR, sizeof(GOVERNOR_Profile_TypeDef), &header, verify);
+	profileCount = 0;
+	if(profiles != NULL) {
+		profileCount = (header->count > GOVERNOR_MAX_PROFILES) ? GOVERNOR_MAX_PROFILES : (uint8_t)header->count;
+	}
+}
+
+// Pressure (Q18.2 Pascal) corrected with the calibration curve of the unit: binary search
+// of the segment and linear interpolation, constant offset out of the curve
+uint32_t TABLES_correctPressure(uint32_t pressure)
+{
+	uint16_t low = 0;
+	uint16_t high = 0;
+	uint16_t middle = 0;
+	const TABLES_CalibrationPoint_TypeDef* left = NULL;
+	const TABLES_CalibrationPoint_TypeDef* right = NULL;
+	int32_t offset = 0;
+
+	if(calibrationCount == 0) {
+		return pressure;
+	}
+	if(pressure <= calibration[0].pressure) {
+		return pressure + calibration[0].offset;
+	}
+	if(pressure >= calibration[calibrationCount - 1].pressure) {
+		return pressure + calibration[calibrationCount - 1].offset;
+	}
+
+	/* Last point at or below the pressure */
+	high = calibrationCount - 1;
+	while(low < high) {
+		middle = (uint16_t)((low + high + 1) / 2);
+		if(calibration[middle].pressure <= pressure) {
+			low = middle;
+		}
+		else {
+			high = middle - 1;
+		}
+	}
+	left = &calibration[low];
+	right = &calibration[low + 1];
+	if(right->pressure == left->pressure) {
+		return pressure + left->offset;
+	}
+	offset = left->offset + (int32_t)(((int64_t)(right->offset - left->offset) * (pressure - left->pressure))
+		/ (int32_t)(right->pressure - left->pressure));
+	return (uint32_t)((int32_t)pressure + offset);
+}
+
+// Sampling profiles from the governor table, NULL if there is none
+const GOVERNOR_Profile_TypeDef* TABLES_getGovernorProfiles(uint8_t* count)
+{
+	*count = profileCount;
+	return profiles;
+}
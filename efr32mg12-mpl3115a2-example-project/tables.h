@@ -0,0 +1,45 @@
+/***************************************************************************//**
+ * @file
+ * @brief tables.h
+ ******************************************************************************/
+
+#ifndef TABLES_H
+#define TABLES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "governor.h"
+
+/*
+ * Lookup tables stored as files of the BSP read-only file system (RFS),
+ * generated into rfs_data.c by generate_tables.py. The tables are used in
+ * place through RFS_fileGetRawData() pointers, nothing is copied to RAM,
+ * and a table update is a data-only change. A file is only used if its
+ * header and CRC-32 are valid, otherwise the built-in defaults stay. After a
+ * warm boot the CRC-32 is skipped, the cold boot checked the same flash.
+ */
+
+#define TABLES_MAGIC            (0x4C425454) // "TTBL"
+#define TABLES_TYPE_ALTITUDE    (1)          // int32_t altitudes, parameter: step shift (altitude.c)
+#define TABLES_TYPE_CALIBRATION (2)          // TABLES_CalibrationPoint_TypeDef, ascending pressure
+#define TABLES_TYPE_GOVERNOR    (3)          // GOVERNOR_Profile_TypeDef
+
+typedef struct {
+	uint32_t magic;     // TABLES_MAGIC
+	uint16_t type;      // TABLES_TYPE_...
+	uint16_t count;     // Entries after the header
+	uint32_t parameter; // Depends on the type
+	uint32_t crc;       // CRC-32 of the entries
+} TABLES_Header_TypeDef;
+
+typedef struct {
+	uint32_t pressure;  // Measured pressure in Q18.2 Pascal
+	int32_t offset;     // Correction at this pressure in Q18.2 Pascal
+} TABLES_CalibrationPoint_TypeDef;
+
+void TABLES_init(bool verify);
+uint32_t TABLES_correctPressure(uint32_t pressure);
+const GOVERNOR_Profile_TypeDef* TABLES_getGovernorProfiles(uint8_t* count);
+
+#endif // TABLES_H
@@ -0,0 +1,149 @@
+/***************************************************************************//**
+ * @file
+ * @brief tendency.c
+ ******************************************************************************/
+
+#include <stddef.h>
+
+#include "tendency.h"
+
+#define TENDENCY_HOURS       (4)    // Means of the hours t-3h ... t
+#define TENDENCY_SECONDS     (3600) // Hour in seconds
+#define TENDENCY_HPA         (400)  // 1 hPa in Q18.2 Pascal
+#define TENDENCY_STEADY_LIMIT (TENDENCY_HPA / 10) // Changes below 0.1 hPa are steady
+
+static TENDENCY_AlertCallback alertCallback = NULL;
+static int32_t hourly[TENDENCY_HOURS]; // Ring of the hourly means
+static uint8_t head = 0;               // Position of the next mean
+static uint8_t count = 0;              // Consecutive hours in the ring
+static uint32_t lastStart = 0;         // Start of the last hour
+static bool valid = false;             // The result is available
+static TENDENCY_Result_TypeDef result;
+
+void TENDENCY_init(TENDENCY_AlertCallback callback)
+{
+	alertCallback = callback;
+	head = 0;
+	count = 0;
+	valid = false;
+}
+
+static int8_t TENDENCY_sign(int32_t change)
+{
+	if(change >= TENDENCY_STEADY_LIMIT / 2) {
+		return 1;
+	}
+	if(change <= -(TENDENCY_STEADY_LIMIT / 2)) {
+		return -1;
+	}
+	return 0;
+}
+
+// WMO 0200 characteristic from the change of the first and the second half of the 3 hours
+static uint8_t TENDENCY_characteristic(int32_t first, int32_t second)
+{
+	int32_t change = first + second;
+	int8_t firstSign = TENDENCY_sign(first);
+	int8_t secondSign = TENDENCY_sign(second);
+
+	if(change >= TENDENCY_STEADY_LIMIT) {
+		if((firstSign > 0) && (secondSign < 0)) {
+			return TENDENCY_INCREASING_THEN_DECREASING;
+		}
+		if((firstSign > 0) && ((secondSign == 0) || (2 * second < first))) {
+			return TENDENCY_INCREASING_THEN_STEADY;
+		}
+		if((secondSign > 0) && ((firstSign <= 0) || (second > 2 * first))) {
+			return TENDENCY_DECREASING_THEN_INCREASING_UP;
+		}
+		return TENDENCY_INCREASING;
+	}
+	if(change <= -TENDENCY_STEADY_LIMIT) {
+		if((firstSign < 0) && (secondSign > 0)) {
+			return TENDENCY_DECREASING_THEN_INCREASING;
+		}
+		if((firstSign < 0) && ((secondSign == 0) || (2 * second > first))) {
+			return TENDENCY_DECREASING_THEN_STEADY;
+		}
+		if((secondSign < 0) && ((firstSign >= 0) || (second < 2 * first))) {
+			return TENDENCY_INCREASING_THEN_DECREASING_DOWN;
+		}
+		return TENDENCY_DECREASING;
+	}
+	/* Same as 3 hours ago */
+	if((firstSign > 0) && (secondSign < 0)) {
+		return TENDENCY_INCREASING_THEN_DECREASING;
+	}
+	if((firstSign < 0) && (secondSign > 0)) {
+		return TENDENCY_DECREASING_THEN_INCREASING;
+	}
+	return TENDENCY_STEADY;
+}
+
+static int8_t TENDENCY_rate(int32_t change)
+{
+	int32_t magnitude = (change < 0) ? -change : change;
+	int8_t rate = TENDENCY_RATE_STEADY;
+
+	if(magnitude > 6 * TENDENCY_HPA) {
+		rate = TENDENCY_RATE_VERY_RAPIDLY;
+	}
+	else if(magnitude > 35 * TENDENCY_HPA / 10) {
+		rate = TENDENCY_RATE_QUICKLY;
+	}
+	else if(magnitude > 15 * TENDENCY_HPA / 10) {
+		rate = TENDENCY_RATE_NORMAL;
+	}
+	else if(magnitude >= TENDENCY_STEADY_LIMIT) {
+		rate = TENDENCY_RATE_SLOWLY;
+	}
+	return (change < 0) ? -rate : rate;
+}
+
+// Feed the mean pressure (Q18.2 Pascal) of the hour starting at start (seconds).
+// A missing hour restarts the 3-hour window.
+void TENDENCY_onHour(uint32_t start, int32_t meanPressure)
+{
+	int32_t oldest = 0;
+	int32_t middle = 0;
+	int8_t previousRate = result.rate;
+	bool wasValid = valid;
+
+	if((count > 0) && (start - lastStart != TENDENCY_SECONDS)) {
+		count = 0;
+		valid = false;
+	}
+	lastStart = start;
+
+	hourly[head] = meanPressure;
+	head = (head + 1) % TENDENCY_HOURS;
+	if(count < TENDENCY_HOURS) {
+		count++;
+	}
+	if(count < TENDENCY_HOURS) {
+		return;
+	}
+
+	/* head is now the oldest of the four hours: t-3h, t-2h, t-1h, t */
+	oldest = hourly[head];
+	middle = (hourly[(head + 1) % TENDENCY_HOURS] + hourly[(head + 2) % TENDENCY_HOURS]) / 2;
+
+	result.change = meanPressure - oldest;
+	result.characteristic = TENDENCY_characteristic(middle - oldest, meanPressure - middle);
+	result.rate = TENDENCY_rate(result.change);
+	result.stormWarning = (result.rate <= -TENDENCY_RATE_QUICKLY);
+	valid = true;
+
+	if((alertCallback != NULL) && (!wasValid || (result.rate != previousRate))) {
+		alertCallback(&result);
+	}
+}
+
+// Latest tendency, returns false until three consecutive hours are available
+bool TENDENCY_get(TENDENCY_Result_TypeDef* tendency)
+{
+	if(valid) {
+		*tendency = result;
+	}
+	return valid;
+}
@@ -0,0 +1,51 @@
+/***************************************************************************//**
+ * @file
+ * @brief tendency.h
+ ******************************************************************************/
+
+#ifndef TENDENCY_H
+#define TENDENCY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * 3-hour pressure tendency from the hourly means (rollup hour tier):
+ * - characteristic by the WMO code table 0200 (0..8, the shape of the curve)
+ * - amount of change in Q18.2 Pascal over 3 hours and its rate class
+ * Only the last four hourly means are kept, each new hour is one update.
+ * The alert callback runs when the signed rate class changes.
+ */
+
+/* WMO code table 0200, characteristic of pressure tendency */
+#define TENDENCY_INCREASING_THEN_DECREASING     (0) // Same or higher than 3 hours ago
+#define TENDENCY_INCREASING_THEN_STEADY         (1) // Or increasing more slowly, higher
+#define TENDENCY_INCREASING                     (2) // Higher
+#define TENDENCY_DECREASING_THEN_INCREASING_UP  (3) // Or steady then increasing, or increasing more rapidly, higher
+#define TENDENCY_STEADY                         (4) // Same as 3 hours ago
+#define TENDENCY_DECREASING_THEN_INCREASING     (5) // Same or lower than 3 hours ago
+#define TENDENCY_DECREASING_THEN_STEADY         (6) // Or decreasing more slowly, lower
+#define TENDENCY_DECREASING                     (7) // Lower
+#define TENDENCY_INCREASING_THEN_DECREASING_DOWN (8) // Or steady then decreasing, or decreasing more rapidly, lower
+
+/* Rate of the 3-hour change, negative for falling */
+#define TENDENCY_RATE_STEADY       (0) // Less than 0.1 hPa
+#define TENDENCY_RATE_SLOWLY       (1) // 0.1 .. 1.5 hPa
+#define TENDENCY_RATE_NORMAL       (2) // 1.6 .. 3.5 hPa
+#define TENDENCY_RATE_QUICKLY      (3) // 3.6 .. 6.0 hPa
+#define TENDENCY_RATE_VERY_RAPIDLY (4) // More than 6.0 hPa
+
+typedef struct {
+	uint8_t characteristic; // TENDENCY_INCREASING, ...
+	int8_t rate;            // +/- TENDENCY_RATE_*, negative for falling pressure
+	int32_t change;         // Change over 3 hours in Q18.2 Pascal
+	bool stormWarning;      // Falling at least TENDENCY_RATE_QUICKLY
+} TENDENCY_Result_TypeDef;
+
+typedef void (*TENDENCY_AlertCallback)(const TENDENCY_Result_TypeDef* result);
+
+void TENDENCY_init(TENDENCY_AlertCallback callback);
+void TENDENCY_onHour(uint32_t start, int32_t meanPressure);
+bool TENDENCY_get(TENDENCY_Result_TypeDef* result);
+
+#endif // TENDENCY_H
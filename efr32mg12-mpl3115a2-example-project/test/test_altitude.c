@@ -0,0 +1,64 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_altitude.c
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <math.h>
+
+#include "unit.h"
+#include "altitude.h"
+
+// The formula of the sensor's Altimeter mode in meter, pressure in Q18.2 Pascal
+static double reference(uint32_t pressure, uint32_t seaLevel)
+{
+	return 44330.77 * (1.0 - pow(pressure / 4.0 / seaLevel, 0.190263));
+}
+
+// Error against the formula over the table range, and time per sample
+static void testAccuracy(void)
+{
+	double error = 0;
+	double maxError = 0;
+	uint64_t start = 0;
+	int32_t sum = 0;
+	uint32_t pressure = 0;
+	uint32_t count = 0;
+
+	ALTITUDE_setSeaLevelPressure(ALTITUDE_SEA_LEVEL_PRESSURE_DEFAULT);
+	for(pressure = 50663 * 4; pressure <= 113990 * 4; pressure += 7) {
+		error = fabs(ALTITUDE_fromPressure(pressure) / 65536.0 - reference(pressure, ALTITUDE_SEA_LEVEL_PRESSURE_DEFAULT));
+		if(error > maxError) {
+			maxError = error;
+		}
+	}
+	CHECK(maxError < 0.2);
+
+	start = UNIT_NOW_NS();
+	for(pressure = 50663 * 4; pressure <= 113990 * 4; pressure++) {
+		sum += ALTITUDE_fromPressure(pressure);
+		count++;
+	}
+	start = UNIT_NOW_NS() - start;
+	printf("max error %.3f m, %.1f ns/sample (%ld)\n", maxError, (double)start / count, (long)sum);
+}
+
+// The reference stays usable at the clamp, 2^48 / 65536 Pa would not fit in 32 bits
+static void testSeaLevelClamp(void)
+{
+	ALTITUDE_setSeaLevelPressure(65536);
+	CHECK(ALTITUDE_getSeaLevelPressure() == 65537);
+	CHECK(fabs(ALTITUDE_fromPressure(60000 * 4) / 65536.0 - reference(60000 * 4, 65537)) < 0.5);
+
+	/* Bisection: pressure at 261 m, the low bound must not give a reciprocal of 0 */
+	CHECK(abs((int)ALTITUDE_toSeaLevelPressure(98000 * 4, 261 << 16) - 101089) < 4);
+	CHECK(ALTITUDE_toSeaLevelPressure(66000 * 4, 0) >= 65537);
+	ALTITUDE_setSeaLevelPressure(ALTITUDE_SEA_LEVEL_PRESSURE_DEFAULT);
+}
+
+int main(void)
+{
+	testAccuracy();
+	testSeaLevelClamp();
+	return UNIT_RESULT("altitude");
+}
@@ -0,0 +1,50 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_ble_beacon.c
+ ******************************************************************************/
+
+#include "unit.h"
+#include "ble_sim.h"
+#include "sample_log.h"
+#include "ble_beacon.h"
+
+int main(void)
+{
+	const BLE_SIM_Stats_TypeDef* sim = NULL;
+	uint32_t sample = 0;
+
+	BLE_BEACON_init(BLE_SIM_init(), 3, 3000);
+	sim = BLE_SIM_getStats();
+
+	/* Nothing is advertised before the stack is up */
+	BLE_BEACON_update(101325 * 4, 23 * 16 + 8);
+	CHECK(sim->advertisingUpdates == 0);
+	CHECK(sim->broadcastStarts == 0);
+
+	/* Every sample three times: 1 s in 0.625 ms units */
+	BLE_BEACON_start();
+	CHECK(sim->broadcastStarts == 1);
+	CHECK(sim->broadcastInterval == 1600);
+	CHECK(sim->advertisingLength == BLE_BEACON_LENGTH);
+
+	/* Manufacturer specific data with the sequence number and the packed sample */
+	BLE_BEACON_update(101330 * 4 + 1, -5 * 16);
+	CHECK(sim->advertisingData[4] == 0xFF);
+	CHECK((sim->advertisingData[5] | (sim->advertisingData[6] << 8)) == BLE_BEACON_COMPANY_ID);
+	CHECK(sim->advertisingData[7] == BLE_BEACON_FORMAT);
+	CHECK((sim->advertisingData[8] | (sim->advertisingData[9] << 8)) == 2);
+	sample = sim->advertisingData[10] | ((uint32_t)sim->advertisingData[11] << 8) | ((uint32_t)sim->advertisingData[12] << 16)
+		| ((uint32_t)sim->advertisingData[13] << 24);
+	CHECK(SAMPLE_LOG_PRESSURE(sample) == 101330 * 4 + 1);
+	CHECK(SAMPLE_LOG_TEMPERATURE(sample) == -5 * 16);
+
+	/* The advertising restarts only for a new interval, within the limits */
+	BLE_BEACON_setSampleInterval(3000);
+	CHECK(sim->broadcastStarts == 1);
+	BLE_BEACON_setSampleInterval(100);
+	CHECK(sim->broadcastStarts == 2);
+	CHECK(sim->broadcastInterval == BLE_BEACON_MIN_INTERVAL);
+	BLE_BEACON_setSampleInterval(600000);
+	CHECK(sim->broadcastInterval == BLE_BEACON_MAX_INTERVAL);
+	return UNIT_RESULT("ble_beacon");
+}
@@ -0,0 +1,186 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_ble_history.c
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "unit.h"
+#include "ble_sim.h"
+#include "codec.h"
+#include "flash_sim.h"
+#include "sample_log.h"
+#include "ble_history.h"
+
+#define CONTROL_CHARACTERISTIC (1)
+#define DATA_CHARACTERISTIC    (2)
+#define LOG_SIZE               (64 * FLASH_DEVICE_SECTOR_SIZE)
+#define LOG_RECORDS            (20000)
+#define FIRST_REQUESTED        (10000)
+#define QUEUE_SPACE            (3)     // Notifications per connection event
+
+static uint8_t memory[LOG_SIZE];
+static const BLE_STACK_TypeDef* sim = NULL;
+
+// Client side, fed through the stack wrapper below
+static bool linkUp = true;        // false: the notifications are lost in the air
+static uint16_t expected = 0;     // Next data packet
+static uint32_t received = 0;     // Records
+static uint32_t lastTimestamp = 0;
+static uint32_t errors = 0;       // Gaps and wrong values
+static uint32_t lost = 0;         // Packets lost at the disconnection
+static uint32_t responses = 0;
+static uint8_t lastResult = 0xFF;
+static bool complete = false;
+static uint32_t completeRecords = 0;
+
+static uint16_t clientWriteValue(uint16_t characteristic, uint8_t length, const uint8_t* value)
+{
+	return sim->writeValue(characteristic, length, value);
+}
+
+static uint16_t clientNotify(uint8_t connection, uint16_t characteristic, uint8_t length, const uint8_t* value)
+{
+	CODEC_Decoder_TypeDef decoder;
+	uint32_t timestamp = 0;
+	uint32_t pressure = 0;
+	int16_t temperature = 0;
+	uint16_t result = sim->notify(connection, characteristic, length, value);
+
+	if(result != BLE_STACK_SUCCESS) {
+		return result;
+	}
+	if(!linkUp) {
+		lost++;
+	}
+	else if(characteristic == DATA_CHARACTERISTIC) {
+		if((uint16_t)(value[0] | (value[1] << 8)) != expected) {
+			return result; // Resent later, as after a lost packet
+		}
+		expected++;
+		CODEC_decoderInit(&decoder, &value[2], (uint16_t)(length - 2));
+		while(CODEC_decode(&decoder, &timestamp, &pressure, &temperature)) {
+			if((received == 0) ? (timestamp != FIRST_REQUESTED) : (timestamp != lastTimestamp + 1)) {
+				errors++;
+			}
+			if(pressure != 400000 + timestamp % 100) {
+				errors++;
+			}
+			lastTimestamp = timestamp;
+			received++;
+		}
+	}
+	else if(value[0] == BLE_HISTORY_OP_COMPLETE) {
+		complete = true;
+		completeRecords = value[5] | ((uint32_t)value[6] << 8) | ((uint32_t)value[7] << 16) | ((uint32_t)value[8] << 24);
+	}
+	else {
+		responses++;
+		lastResult = value[2];
+	}
+	return result;
+}
+
+static const BLE_STACK_TypeDef clientStack = {
+	clientWriteValue,
+	clientNotify,
+	NULL,
+	NULL,
+	NULL,
+};
+
+static void control(uint8_t connection, const uint8_t* data, uint8_t length)
+{
+	BLE_HISTORY_onControl(connection, data, length);
+}
+
+static void acknowledge(uint8_t connection)
+{
+	uint8_t ack[3] = { BLE_HISTORY_OP_ACK, (uint8_t)expected, (uint8_t)(expected >> 8) };
+
+	control(connection, ack, sizeof(ack));
+}
+
+static void connect(uint8_t connection, uint16_t mtu)
+{
+	BLE_HISTORY_onMtu(connection, mtu);
+	BLE_HISTORY_onSubscription(connection, DATA_CHARACTERISTIC, true);
+	BLE_HISTORY_onSubscription(connection, CONTROL_CHARACTERISTIC, true);
+}
+
+// 10000 records from the middle of the log, the link drops after 20 connection
+// events and the download continues on a new connection with RESUME
+static void testResume(void)
+{
+	const BLE_HISTORY_Stats_TypeDef* stats = BLE_HISTORY_getStats();
+	uint8_t start[9] = { BLE_HISTORY_OP_START, (uint8_t)FIRST_REQUESTED, (uint8_t)(FIRST_REQUESTED >> 8), 0, 0, 0xFF, 0xFF, 0xFF, 0xFF };
+	uint8_t resume[5] = { BLE_HISTORY_OP_RESUME, 1, 0, 0, 0 };
+	uint8_t connection = 5;
+	uint32_t events = 0;
+
+	BLE_HISTORY_init(&clientStack, CONTROL_CHARACTERISTIC, DATA_CHARACTERISTIC);
+	connect(connection, 247);
+	control(connection, start, sizeof(start));
+	for(events = 0; !complete && (events < 100000); events++) {
+		BLE_SIM_setQueueSpace(QUEUE_SPACE);
+		BLE_HISTORY_process();
+		acknowledge(connection);
+		if(events == 20) {
+			linkUp = false;
+			BLE_SIM_setQueueSpace(QUEUE_SPACE);
+			BLE_HISTORY_process();
+			BLE_HISTORY_onDisconnect(connection);
+			linkUp = true;
+
+			connection = 7;
+			connect(connection, 185);
+			resume[3] = (uint8_t)expected;
+			resume[4] = (uint8_t)(expected >> 8);
+			control(connection, resume, sizeof(resume));
+			CHECK(lastResult == BLE_HISTORY_SUCCESS);
+		}
+	}
+	CHECK(complete);
+	CHECK(lost > 0);
+	CHECK(errors == 0);
+	CHECK(received == LOG_RECORDS - FIRST_REQUESTED);
+	CHECK(completeRecords == received);
+	CHECK(stats->resumes == 1);
+	printf("%u records in %u events, %.2f bytes/record, %u packets lost and resent\n", received, events,
+		(double)stats->bytes / stats->records, lost);
+}
+
+// Without indications on the control point the response is dropped, not retried forever
+static void testNoIndications(void)
+{
+	uint8_t start[9] = { BLE_HISTORY_OP_START, 0, 0, 0, 0, 0xFF, 0xFF, 0xFF, 0xFF };
+	uint32_t before = 0;
+
+	BLE_HISTORY_init(&clientStack, CONTROL_CHARACTERISTIC, DATA_CHARACTERISTIC);
+	BLE_HISTORY_onSubscription(3, DATA_CHARACTERISTIC, true);
+	responses = 0;
+	expected = 0;
+	received = 0;
+	control(3, start, sizeof(start));
+	BLE_SIM_setQueueSpace(BLE_SIM_QUEUE_UNLIMITED);
+	before = BLE_SIM_getStats()->notifications;
+	CHECK(!BLE_HISTORY_process());
+	CHECK(responses == 0);
+	CHECK(BLE_SIM_getStats()->notifications - before == BLE_HISTORY_WINDOW); // Only data packets
+	CHECK(received > 0);
+}
+
+int main(void)
+{
+	uint32_t timestamp = 0;
+
+	SAMPLE_LOG_init(FLASH_SIM_init(memory, LOG_SIZE), 0, LOG_SIZE);
+	for(timestamp = 0; timestamp < LOG_RECORDS; timestamp++) {
+		SAMPLE_LOG_append(timestamp, 400000 + timestamp % 100, 250);
+	}
+	SAMPLE_LOG_flush();
+	sim = BLE_SIM_init();
+	testResume();
+	testNoIndications();
+	return UNIT_RESULT("ble_history");
+}
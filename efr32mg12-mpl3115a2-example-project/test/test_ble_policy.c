@@ -0,0 +1,76 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_ble_policy.c
+ ******************************************************************************/
+
+#include "unit.h"
+#include "ble_sim.h"
+#include "ble_policy.h"
+
+#define MAX_AGE_MS (1000)
+
+static uint32_t nowMs = 0;
+
+static uint32_t testClock(void)
+{
+	return nowMs;
+}
+
+// The central applies the requested parameters
+static void accept(const BLE_SIM_Stats_TypeDef* sim)
+{
+	nowMs += 1000;
+	BLE_POLICY_onParameters(1, sim->connectionInterval, sim->connectionLatency, sim->connectionTimeout);
+}
+
+int main(void)
+{
+	const BLE_SIM_Stats_TypeDef* sim = NULL;
+	const BLE_POLICY_Stats_TypeDef* stats = NULL;
+
+	BLE_POLICY_init(BLE_SIM_init(), testClock, MAX_AGE_MS);
+	sim = BLE_SIM_getStats();
+	stats = BLE_POLICY_getStats();
+
+	/* A 3 s sample interval is not capped by the 1 s age: 2.4 s in 1.25 ms units */
+	BLE_POLICY_setProduction(3000, 1);
+	BLE_POLICY_onOpened(1);
+	BLE_POLICY_onParameters(1, 24, 0, 500); // 30 ms, chosen by the central
+	CHECK(sim->connectionUpdates == 1);
+	CHECK(sim->connectionInterval == BLE_POLICY_MAX_INTERVAL);
+	CHECK(sim->connectionLatency == 5);
+	accept(sim);
+	CHECK(sim->connectionUpdates == 1);
+
+	/* The central answers with other parameters: the request is not repeated */
+	BLE_POLICY_onParameters(1, 24, 0, 500);
+	BLE_POLICY_setProduction(3000, 1);
+	CHECK(sim->connectionUpdates == 1);
+
+	/* Faster sampling */
+	BLE_POLICY_setProduction(250, 1);
+	CHECK(sim->connectionUpdates == 2);
+	CHECK(sim->connectionInterval == 200);
+	CHECK(sim->connectionLatency == 0);
+	accept(sim);
+
+	/* Batched stream: 5.8 s of samples per notification, capped by the age */
+	BLE_POLICY_setProduction(100, 58);
+	CHECK(sim->connectionUpdates == 3);
+	CHECK(sim->connectionInterval == BLE_POLICY_MAX_INTERVAL);
+	CHECK(sim->connectionLatency == 1);
+	accept(sim);
+
+	/* Beyond the latency limit the parameters differ from the target, nothing is repeated */
+	BLE_POLICY_setProduction(8000, 1);
+	CHECK(sim->connectionUpdates == 4);
+	CHECK(sim->connectionLatency == BLE_POLICY_MAX_LATENCY);
+	accept(sim);
+	BLE_POLICY_setProduction(8000, 1);
+	CHECK(sim->connectionUpdates == 4);
+
+	nowMs += 600000;
+	CHECK(stats->requests == 4);
+	CHECK(stats->wakeups < stats->initialWakeups);
+	return UNIT_RESULT("ble_policy");
+}
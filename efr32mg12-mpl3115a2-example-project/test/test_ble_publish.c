@@ -0,0 +1,70 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_ble_publish.c
+ ******************************************************************************/
+
+#include "unit.h"
+#include "ble_sim.h"
+#include "ble_publish.h"
+
+#define PRESSURE_CHARACTERISTIC    (30)
+#define TEMPERATURE_CHARACTERISTIC (33)
+#define PRESSURE                   (101325 * 4) // Q18.2 Pa
+#define TEMPERATURE                (25 * 16)    // Q8.4 C
+
+static uint32_t lastValue(void)
+{
+	const BLE_SIM_Stats_TypeDef* sim = BLE_SIM_getStats();
+
+	return sim->lastValue[0] | ((uint32_t)sim->lastValue[1] << 8) | ((uint32_t)sim->lastValue[2] << 16)
+		| ((uint32_t)sim->lastValue[3] << 24);
+}
+
+int main(void)
+{
+	const BLE_SIM_Stats_TypeDef* sim = NULL;
+	const BLE_PUBLISH_Stats_TypeDef* stats = NULL;
+	uint32_t i = 0;
+
+	BLE_PUBLISH_init(BLE_SIM_init(), PRESSURE_CHARACTERISTIC, TEMPERATURE_CHARACTERISTIC, 16, 8);
+	sim = BLE_SIM_getStats();
+	stats = BLE_PUBLISH_getStats();
+
+	/* The GATT values are written, nothing is notified without a subscriber */
+	BLE_PUBLISH_update(PRESSURE, TEMPERATURE);
+	CHECK(sim->writes == 2);
+	CHECK(sim->notifications == 0);
+	CHECK(stats->valueErrors == 0);
+
+	/* A new subscriber gets the current value at once, in 0.1 Pa */
+	BLE_PUBLISH_onSubscription(1, PRESSURE_CHARACTERISTIC, true);
+	CHECK(sim->notifications == 1);
+	CHECK(sim->lastLength == 4);
+	CHECK(lastValue() == 1013250);
+
+	/* Changes within the deadband are suppressed */
+	for(i = 0; i < 100; i++) {
+		BLE_PUBLISH_update(PRESSURE + (i % 3), TEMPERATURE);
+	}
+	CHECK(sim->notifications == 1);
+	CHECK(stats->suppressed == 100);
+
+	/* A refused notification is tried again with the next sample */
+	BLE_SIM_setQueueSpace(0);
+	BLE_PUBLISH_update(PRESSURE + 100, TEMPERATURE);
+	CHECK(stats->refused == 1);
+	BLE_SIM_setQueueSpace(BLE_SIM_QUEUE_UNLIMITED);
+	BLE_PUBLISH_update(PRESSURE + 100, TEMPERATURE);
+	CHECK(sim->notifications == 2);
+
+	/* Temperature in 0.01 C */
+	BLE_PUBLISH_onSubscription(1, TEMPERATURE_CHARACTERISTIC, true);
+	CHECK(sim->lastLength == 2);
+	CHECK((int16_t)lastValue() == 2500);
+
+	/* Nothing is notified after the disconnection */
+	BLE_PUBLISH_onDisconnect(1);
+	BLE_PUBLISH_update(0, 0);
+	CHECK(sim->notifications == 3);
+	return UNIT_RESULT("ble_publish");
+}
@@ -0,0 +1,199 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_ble_stream.c
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "unit.h"
+#include "ble_sim.h"
+#include "codec.h"
+#include "seal.h"
+#include "ble_stream.h"
+
+#define STREAM_CHARACTERISTIC (40)
+#define INTERVAL_MS           (100)
+#define DEVICE_ID             (0x12345678)
+
+static const uint8_t key[SEAL_KEY_SIZE] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F
+};
+
+static uint32_t session = 0;
+static uint32_t decoded = 0;     // Samples received
+static uint32_t lastMs = 0;      // Timestamp of the last sample received
+static uint16_t lastSequence = 0;
+static uint32_t errors = 0;      // Sequence gaps, timestamp gaps, bad tags
+
+static uint32_t nextSession(void)
+{
+	return ++session;
+}
+
+static void start(uint16_t mtu, uint32_t maxAgeMs, bool sealed)
+{
+	BLE_STREAM_init(BLE_SIM_init(), STREAM_CHARACTERISTIC, maxAgeMs);
+	if(sealed) {
+		BLE_STREAM_enableSeal(DEVICE_ID, nextSession);
+	}
+	BLE_STREAM_onSubscription(1, STREAM_CHARACTERISTIC, true);
+	BLE_STREAM_onMtu(1, mtu);
+	decoded = 0;
+	errors = 0;
+}
+
+// Check and decode the last notification as a client would
+static void receive(bool sealed)
+{
+	const BLE_SIM_Stats_TypeDef* sim = BLE_SIM_getStats();
+	uint8_t packet[BLE_STREAM_MAX_PACKET];
+	uint8_t nonce[SEAL_NONCE_SIZE];
+	uint16_t header = sealed ? BLE_STREAM_HEADER_SIZE + BLE_STREAM_SESSION_SIZE : BLE_STREAM_HEADER_SIZE;
+	uint16_t length = sim->lastLength;
+	uint16_t sequence = 0;
+	uint32_t packetSession = 0;
+	CODEC_Decoder_TypeDef decoder;
+	uint32_t timestamp = 0;
+	uint32_t pressure = 0;
+	int16_t temperature = 0;
+
+	memcpy(packet, sim->lastValue, length);
+	sequence = (uint16_t)(packet[0] | (packet[1] << 8));
+	if((decoded > 0) && (sequence != (uint16_t)(lastSequence + 1))) {
+		errors++;
+	}
+	lastSequence = sequence;
+	if(sealed) {
+		packetSession = packet[2] | ((uint32_t)packet[3] << 8) | ((uint32_t)packet[4] << 16) | ((uint32_t)packet[5] << 24);
+		length -= SEAL_TAG_SIZE;
+		SEAL_makeNonce(nonce, ((uint64_t)DEVICE_ID << 32) | packetSession, sequence);
+		if(!SEAL_decrypt(nonce, packet, header, &packet[header], (uint16_t)(length - header), &packet[length])) {
+			errors++;
+			return;
+		}
+	}
+	CODEC_decoderInit(&decoder, &packet[header], (uint16_t)(length - header));
+	while(CODEC_decode(&decoder, &timestamp, &pressure, &temperature)) {
+		if((decoded > 0) && (timestamp != lastMs + INTERVAL_MS)) {
+			errors++;
+		}
+		if(pressure != 101325 * 4 + timestamp / INTERVAL_MS) {
+			errors++;
+		}
+		lastMs = timestamp;
+		decoded++;
+	}
+}
+
+// One minute of samples, every notification is decoded
+static void run(uint16_t mtu, bool sealed)
+{
+	const BLE_SIM_Stats_TypeDef* sim = BLE_SIM_getStats();
+	const BLE_STREAM_Stats_TypeDef* stats = BLE_STREAM_getStats();
+	uint32_t notifications = 0;
+	uint32_t ms = 0;
+
+	start(mtu, 30000, sealed);
+	for(ms = 0; ms < 60000; ms += INTERVAL_MS) {
+		BLE_STREAM_push(ms, 101325 * 4 + ms / INTERVAL_MS, (int16_t)(400 + ms / 5000));
+		BLE_STREAM_process(ms);
+		if(sim->notifications != notifications) {
+			notifications = sim->notifications;
+			receive(sealed);
+		}
+	}
+	BLE_STREAM_process(ms + 30000); // The last packet is due
+	receive(sealed);
+	CHECK(errors == 0);
+	CHECK(stats->droppedSamples == 0);
+	CHECK(decoded == stats->samples);
+	printf("MTU %3u%s: %.1f samples/notification, %.2f bytes/sample\n", mtu, sealed ? " sealed" : "",
+		(double)stats->sentSamples / stats->packets, (double)stats->sentBytes / stats->sentSamples);
+}
+
+// The age deadline: process returns the time left, the packet goes out when it is due
+static void testDeadline(void)
+{
+	const BLE_SIM_Stats_TypeDef* sim = BLE_SIM_getStats();
+
+	start(247, 1000, false);
+	CHECK(BLE_STREAM_process(0) == 0);
+	BLE_STREAM_push(0, 101325 * 4, 400);
+	CHECK(BLE_STREAM_process(300) == 700);
+	CHECK(sim->notifications == 0);
+	CHECK(BLE_STREAM_process(1000) == 0);
+	CHECK(sim->notifications == 1);
+
+	/* A refused packet is retried soon */
+	BLE_SIM_setQueueSpace(0);
+	BLE_STREAM_push(2000, 101325 * 4, 400);
+	CHECK(BLE_STREAM_process(3000) == BLE_STREAM_RETRY_MS);
+	BLE_SIM_setQueueSpace(BLE_SIM_QUEUE_UNLIMITED);
+	CHECK(BLE_STREAM_process(3010) == 0);
+	CHECK(sim->notifications == 2);
+}
+
+// A full queue drops the older packet, not the newest samples
+static void testRefused(void)
+{
+	const BLE_STREAM_Stats_TypeDef* stats = BLE_STREAM_getStats();
+	uint32_t i = 0;
+
+	start(247, 1000000, false);
+	BLE_SIM_setQueueSpace(0);
+	for(i = 0; i < 500; i++) {
+		BLE_STREAM_push(i * INTERVAL_MS, 101325 * 4 + i, 400);
+	}
+	CHECK(stats->droppedSamples > 0);
+	CHECK(stats->droppedSamples < stats->samples);
+	CHECK(stats->packets == 0);
+}
+
+// Sealed packets: a tampered byte fails the tag, a new session starts after a restart
+static void testSeal(void)
+{
+	const BLE_SIM_Stats_TypeDef* sim = NULL;
+	uint8_t packet[BLE_STREAM_MAX_PACKET];
+	uint8_t nonce[SEAL_NONCE_SIZE];
+	uint16_t length = 0;
+	uint32_t firstSession = 0;
+
+	start(247, 1000, true);
+	sim = BLE_SIM_getStats();
+	BLE_STREAM_push(0, 101325 * 4, 400);
+	BLE_STREAM_process(1000);
+	CHECK(sim->notifications == 1);
+	length = (uint16_t)(sim->lastLength - SEAL_TAG_SIZE);
+	memcpy(packet, sim->lastValue, sim->lastLength);
+	firstSession = packet[2];
+	packet[length - 1] ^= 1;
+	SEAL_makeNonce(nonce, ((uint64_t)DEVICE_ID << 32) | firstSession, 0);
+	CHECK(!SEAL_decrypt(nonce, packet, 6, &packet[6], (uint16_t)(length - 6), &packet[length]));
+	memcpy(packet, sim->lastValue, sim->lastLength);
+	CHECK(SEAL_decrypt(nonce, packet, 6, &packet[6], (uint16_t)(length - 6), &packet[length]));
+
+	/* A restart draws a new session */
+	start(247, 1000, true);
+	BLE_STREAM_push(0, 101325 * 4, 400);
+	BLE_STREAM_process(1000);
+	CHECK(sim->notifications == 1);
+	CHECK(sim->lastValue[0] == 0);
+	CHECK(sim->lastValue[2] != firstSession);
+
+	/* The default MTU has no room for a sealed block */
+	start(BLE_STREAM_DEFAULT_MTU, 1000, true);
+	BLE_STREAM_push(0, 101325 * 4, 400);
+	CHECK(BLE_STREAM_getStats()->droppedSamples == 1);
+}
+
+int main(void)
+{
+	SEAL_init(key);
+	run(23, false);
+	run(247, false);
+	run(247, true);
+	testDeadline();
+	testRefused();
+	testSeal();
+	return UNIT_RESULT("ble_stream");
+}
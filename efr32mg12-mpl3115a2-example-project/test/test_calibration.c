@@ -0,0 +1,132 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_calibration.c
+ ******************************************************************************/
+
+#include "unit.h"
+#include "MPL3115A2.h"
+#include "altitude.h"
+#include "timestamp.h"
+#include "calibration.h"
+
+// BAR_IN of the sensor: 16 bits in 2 Pascal units, as the driver keeps it
+static uint16_t barIn = 0;
+static uint32_t barInWrites = 0;
+
+void MPL3115A2_setSeaLevelPressure(uint32_t pressure)
+{
+	barIn = (pressure > 0x1FFFE) ? 0xFFFF : (uint16_t)((pressure + 1) >> 1);
+	barInWrites++;
+}
+
+uint32_t MPL3115A2_getSeaLevelPressure(void)
+{
+	return (uint32_t)barIn << 1;
+}
+
+// Clock of the log timestamps
+static uint32_t now = 0;
+
+uint32_t TIMESTAMP_get(void)
+{
+	return now;
+}
+
+void TIMESTAMP_set(uint32_t seconds)
+{
+	now = seconds;
+}
+
+static void send(const char* text)
+{
+	while(*text != '\0') {
+		CALIBRATION_processChar(*text++);
+	}
+}
+
+// Both references follow an accepted command, a rejected one changes neither
+static void checkReference(uint32_t pressure)
+{
+	CHECK(CALIBRATION_getSeaLevelPressure() == ((pressure + 1) & ~1UL)); // BAR_IN rounds to 2 Pa
+	CHECK(ALTITUDE_getSeaLevelPressure() == pressure);
+}
+
+int main(void)
+{
+	uint32_t writes = 0;
+
+	CALIBRATION_init(101325);
+	checkReference(101325);
+
+	/* Pressure commands, CR, LF or both end the line */
+	send("P100000\r\n");
+	checkReference(100000);
+	send("p102000\n");
+	checkReference(102000);
+
+	/* The range of the altitude engine and of BAR_IN */
+	send("P65537\r");
+	checkReference(65537);
+	send("P131070\r");
+	checkReference(131070);
+	writes = barInWrites;
+	send("P65536\r");
+	send("P131071\r");
+	send("P-101325\r");
+	send("P0\r");
+	checkReference(131070);
+	CHECK(barInWrites == writes);
+
+	/* Malformed lines */
+	send("P\r");
+	send("P1013x5\r");
+	send("X101325\r");
+	send("\r\n\r\n");
+	checkReference(131070);
+	CHECK(barInWrites == writes);
+
+	/* A line longer than the buffer is dropped as a whole, the next line works */
+	send("P10132500000000\r");
+	checkReference(131070);
+	send("P101325\r");
+	checkReference(101325);
+
+	/* A known altitude needs a sample first, and stays within the limit */
+	CALIBRATION_init(101325);
+	send("A100\r");
+	checkReference(101325);
+	CALIBRATION_onSample(ALTITUDE_SEA_LEVEL_PRESSURE_DEFAULT * 4 - 1200 * 4); // About 100 m
+	send("A30001\r");
+	send("A-30001\r");
+	checkReference(101325);
+	send("A0\r");
+	CHECK(ALTITUDE_getSeaLevelPressure() == 101325 - 1200);
+	send("a100\r");
+	CHECK(labs((int32_t)(ALTITUDE_fromPressure(101325 * 4 - 1200 * 4) >> 16) - 100) <= 1);
+	send("A5000\r"); // Would need about 190000 Pa
+	CHECK(labs((int32_t)(ALTITUDE_fromPressure(101325 * 4 - 1200 * 4) >> 16) - 100) <= 1);
+	CHECK(CALIBRATION_setKnownAltitude(5000 * 65536) == 2);
+
+	/* The clock only goes forward, BAR_IN is not touched */
+	writes = barInWrites;
+	now = 5000;
+	send("T1700000000\r");
+	CHECK(now == 1700000000);
+	send("t1700000000\r");
+	CHECK(now == 1700000000);
+	send("T1699999999\r");
+	send("T-1\r");
+	send("T17000000000\r"); // Too long
+	CHECK(now == 1700000000);
+	send("T1700003600\r");
+	CHECK(now == 1700003600);
+	CHECK(barInWrites == writes);
+
+	/* A warm boot takes the reference kept in BAR_IN, without writing it */
+	writes = barInWrites;
+	barIn = 99000 / 2;
+	CALIBRATION_initWarm();
+	checkReference(99000);
+	CHECK(barInWrites == writes);
+	return UNIT_RESULT("calibration");
+}
@@ -0,0 +1,116 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_codec.c
+ ******************************************************************************/
+
+#include <stdlib.h>
+
+#include "unit.h"
+#include "codec.h"
+
+#define TRACE_LENGTH (100000)
+
+static uint32_t timestamps[TRACE_LENGTH];
+static uint32_t pressures[TRACE_LENGTH];
+static int16_t temperatures[TRACE_LENGTH];
+
+// Trace like the 3 s loop records: slow weather drift with a few LSB of noise in
+// Q18.2 Pa and Q8.4 C, and a jump (door, elevator) every 5000 samples
+static void makeTrace(void)
+{
+	uint32_t pressure = 101325 * 4;
+	int16_t temperature = 23 * 16;
+	uint32_t i = 0;
+
+	srand(1);
+	for(i = 0; i < TRACE_LENGTH; i++) {
+		pressure += (uint32_t)(rand() % 9 - 4);
+		if((i % 5000) == 4999) {
+			pressure -= 2000;
+		}
+		if((rand() % 8) == 0) {
+			temperature += (int16_t)(rand() % 3 - 1);
+		}
+		timestamps[i] = 1000 + i * 3;
+		pressures[i] = pressure;
+		temperatures[i] = temperature;
+	}
+}
+
+// Every sample comes back from the blocks, including extreme deltas
+static void testRoundTrip(void)
+{
+	uint8_t block[244];
+	CODEC_Encoder_TypeDef encoder;
+	CODEC_Decoder_TypeDef decoder;
+	uint32_t timestamp = 0;
+	uint32_t pressure = 0;
+	int16_t temperature = 0;
+	uint32_t next = 0;
+	uint32_t read = 0;
+
+	pressures[10] = 0xFFFFFFFFUL;
+	temperatures[11] = -32768;
+	timestamps[12] = 0;
+	while(next < 2000) {
+		CODEC_encoderInit(&encoder, block, sizeof(block));
+		while((next < 2000) && CODEC_encode(&encoder, timestamps[next], pressures[next], temperatures[next])) {
+			next++;
+		}
+		CHECK(CODEC_decoderInit(&decoder, block, CODEC_encoderLength(&encoder)));
+		while(CODEC_decode(&decoder, &timestamp, &pressure, &temperature)) {
+			CHECK(timestamp == timestamps[read]);
+			CHECK(pressure == pressures[read]);
+			CHECK(temperature == temperatures[read]);
+			read++;
+		}
+	}
+	CHECK(read == 2000);
+	CHECK(!CODEC_decoderInit(&decoder, block, CODEC_HEADER_SIZE - 1));
+}
+
+// Compression ratio against the 10 byte raw sample and time per sample
+static void benchmark(void)
+{
+	uint8_t block[244];
+	CODEC_Encoder_TypeDef encoder;
+	CODEC_Decoder_TypeDef decoder;
+	uint32_t timestamp = 0;
+	uint32_t pressure = 0;
+	int16_t temperature = 0;
+	uint64_t encodeNs = 0;
+	uint64_t decodeNs = 0;
+	uint64_t start = 0;
+	uint64_t encoded = 0;
+	uint32_t next = 0;
+	uint32_t check = 0;
+
+	while(next < TRACE_LENGTH) {
+		start = UNIT_NOW_NS();
+		CODEC_encoderInit(&encoder, block, sizeof(block));
+		while((next < TRACE_LENGTH) && CODEC_encode(&encoder, timestamps[next], pressures[next], temperatures[next])) {
+			next++;
+		}
+		encodeNs += UNIT_NOW_NS() - start;
+		encoded += CODEC_encoderLength(&encoder);
+
+		start = UNIT_NOW_NS();
+		CODEC_decoderInit(&decoder, block, CODEC_encoderLength(&encoder));
+		while(CODEC_decode(&decoder, &timestamp, &pressure, &temperature)) {
+			check += pressure;
+		}
+		decodeNs += UNIT_NOW_NS() - start;
+	}
+	CHECK(encoded * 3 < (uint64_t)TRACE_LENGTH * 10);
+	printf("%u samples, %.2f bytes/sample, ratio %.2f, encode %.1f ns/sample, decode %.1f ns/sample (%08x)\n",
+	       TRACE_LENGTH, (double)encoded / TRACE_LENGTH, (double)TRACE_LENGTH * 10 / encoded,
+	       (double)encodeNs / TRACE_LENGTH, (double)decodeNs / TRACE_LENGTH, (unsigned)check);
+}
+
+int main(void)
+{
+	makeTrace();
+	benchmark();
+	testRoundTrip();
+	return UNIT_RESULT("codec");
+}
@@ -0,0 +1,71 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_crc.c
+ ******************************************************************************/
+
+#include <stdlib.h>
+
+#include "unit.h"
+#include "crc.h"
+
+// Bit by bit reference implementations
+static uint32_t crc32Reference(const uint8_t* bytes, uint32_t length)
+{
+	uint32_t crc = 0xFFFFFFFF;
+	uint32_t i;
+	uint8_t bit;
+
+	for(i = 0; i < length; i++) {
+		crc ^= bytes[i];
+		for(bit = 0; bit < 8; bit++) {
+			crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320UL : 0);
+		}
+	}
+	return ~crc;
+}
+
+static uint16_t crc16Reference(const uint8_t* bytes, uint32_t length)
+{
+	uint16_t crc = 0xFFFF;
+	uint32_t i;
+	uint8_t bit;
+
+	for(i = 0; i < length; i++) {
+		crc ^= (uint16_t)(bytes[i] << 8);
+		for(bit = 0; bit < 8; bit++) {
+			crc = (uint16_t)((crc << 1) ^ ((crc & 0x8000) ? 0x1021 : 0));
+		}
+	}
+	return crc;
+}
+
+int main(void)
+{
+	static uint8_t frame[300];
+	uint64_t start = 0;
+	uint32_t sum = 0;
+	uint32_t length = 0;
+	uint32_t i = 0;
+
+	CRC_init();
+	CHECK(!CRC_isHardware());
+	CHECK(CRC_crc32("123456789", 9) == CRC_CHECK_32);
+	CHECK(CRC_crc16("123456789", 9) == CRC_CHECK_16);
+
+	srand(1);
+	for(i = 0; i < sizeof(frame); i++) {
+		frame[i] = (uint8_t)rand();
+	}
+	for(length = 0; length <= sizeof(frame); length++) {
+		CHECK(CRC_crc32(frame, length) == crc32Reference(frame, length));
+		CHECK(CRC_crc16(frame, length) == crc16Reference(frame, length));
+	}
+
+	start = UNIT_NOW_NS();
+	for(i = 0; i < 10000; i++) {
+		sum += CRC_crc32Software(frame, 256);
+	}
+	start = UNIT_NOW_NS() - start;
+	printf("software CRC-32: %.2f ns/byte (%08x)\n", (double)start / 10000 / 256, (unsigned)sum);
+	return UNIT_RESULT("crc");
+}
@@ -0,0 +1,63 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_delta_detector.c
+ ******************************************************************************/
+
+#include "unit.h"
+#include "delta_detector.h"
+
+// A step needs confirmCount samples over the threshold, then the holdoff mutes the detector
+static void testStep(void)
+{
+	DELTA_Detector_TypeDef detector;
+	uint8_t i = 0;
+
+	DELTA_init(&detector, 40, 0, 2, 3);
+	CHECK(DELTA_update(&detector, 10) == DELTA_EVENT_NONE);
+	CHECK(DELTA_update(&detector, 40) == DELTA_EVENT_NONE);  // over the threshold, 1st
+	CHECK(DELTA_update(&detector, 0) == DELTA_EVENT_RISING); // 2nd in a row
+	for(i = 0; i < 3; i++) {
+		CHECK(DELTA_update(&detector, 100) == DELTA_EVENT_NONE);
+	}
+	CHECK(DELTA_update(&detector, -50) == DELTA_EVENT_NONE);
+	CHECK(DELTA_update(&detector, 0) == DELTA_EVENT_FALLING);
+}
+
+// A single spike that comes back is not confirmed
+static void testSpike(void)
+{
+	DELTA_Detector_TypeDef detector;
+
+	DELTA_init(&detector, 40, 0, 2, 0);
+	CHECK(DELTA_update(&detector, 60) == DELTA_EVENT_NONE);
+	CHECK(DELTA_update(&detector, -60) == DELTA_EVENT_NONE);
+	CHECK(DELTA_update(&detector, 0) == DELTA_EVENT_NONE);
+}
+
+// A slow drift leaks out, the same total change as a ramp is reported
+static void testDriftAndRamp(void)
+{
+	DELTA_Detector_TypeDef detector;
+	uint16_t i = 0;
+	int events = 0;
+
+	DELTA_init(&detector, 40, 3, 1, 0);
+	for(i = 0; i < 1000; i++) {
+		events += (DELTA_update(&detector, 2) != DELTA_EVENT_NONE);
+	}
+	CHECK(events == 0);
+
+	DELTA_reset(&detector);
+	for(i = 0; i < 4; i++) {
+		events += (DELTA_update(&detector, -15) == DELTA_EVENT_FALLING);
+	}
+	CHECK(events == 1);
+}
+
+int main(void)
+{
+	testStep();
+	testSpike();
+	testDriftAndRamp();
+	return UNIT_RESULT("delta_detector");
+}
@@ -0,0 +1,121 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_filter.c
+ ******************************************************************************/
+
+#include "unit.h"
+#include "filter.h"
+
+#define BASE (101325 * 4) // Q18.2 Pa
+
+// Single and double sample spikes do not pass the median of 5, a step does after 3 samples
+static void testMedian(void)
+{
+	FILTER_Median_TypeDef median;
+	uint32_t i = 0;
+	int32_t output = 0;
+	uint32_t errors = 0;
+
+	FILTER_medianInit(&median);
+	CHECK(FILTER_medianPush(&median, BASE) == BASE);
+	for(i = 1; i < 1000; i++) {
+		output = FILTER_medianPush(&median, ((i % 10) == 0) ? BASE + 40000 : (((i % 10) == 5) ? BASE - 40000 : BASE));
+		if(output != BASE) {
+			errors++;
+		}
+	}
+	for(i = 0; i < 2; i++) {
+		output = FILTER_medianPush(&median, BASE + 400);
+		if(output != BASE) {
+			errors++;
+		}
+	}
+	CHECK(errors == 0);
+	CHECK(FILTER_medianPush(&median, BASE + 400) == BASE + 400);
+
+	/* Repeated values leave the sorted copy consistent */
+	FILTER_medianInit(&median);
+	for(i = 0; i < 20; i++) {
+		output = FILTER_medianPush(&median, (int32_t)(i / 4));
+	}
+	CHECK(output == 4);
+	CHECK(median.count == FILTER_MEDIAN_SIZE);
+	for(i = 1; i < FILTER_MEDIAN_SIZE; i++) {
+		CHECK(median.sorted[i - 1] <= median.sorted[i]);
+	}
+}
+
+// One output per factor samples, the mean of the block
+static void testDecimator(void)
+{
+	FILTER_Decimator_TypeDef decimator;
+	uint32_t i = 0;
+	uint32_t outputs = 0;
+	int32_t output = 0;
+
+	FILTER_decimatorInit(&decimator, 16);
+	for(i = 0; i < 1600; i++) {
+		if(FILTER_decimatorPush(&decimator, BASE + (int32_t)(i % 16), &output)) {
+			outputs++;
+			CHECK(output == BASE + 7); // (0 + ... + 15) / 16, rounded down
+			CHECK((i % 16) == 15);
+		}
+	}
+	CHECK(outputs == 100);
+
+	/* Factor 0 is taken as 1 */
+	FILTER_decimatorInit(&decimator, 0);
+	CHECK(FILTER_decimatorPush(&decimator, -3, &output) && (output == -3));
+}
+
+// The first sample sets the state, a step settles with the time constant 2^shift
+static void testIir(void)
+{
+	FILTER_Iir_TypeDef iir;
+	uint32_t i = 0;
+	int32_t output = 0;
+
+	FILTER_iirInit(&iir, 2);
+	CHECK(FILTER_iirPush(&iir, BASE) == BASE);
+	output = FILTER_iirPush(&iir, BASE + 400);
+	CHECK(output == BASE + 100);
+	for(i = 0; i < 100; i++) {
+		output = FILTER_iirPush(&iir, BASE + 400);
+	}
+	CHECK(output == BASE + 400);
+}
+
+// Pipeline of the filter mode: outputs at the decimated rate, spikes removed
+static void testPipeline(void)
+{
+	FILTER_Pipeline_TypeDef pipeline;
+	uint32_t i = 0;
+	uint32_t outputs = 0;
+	int32_t output = 0;
+	uint32_t errors = 0;
+
+	FILTER_pipelineInit(&pipeline, true, 16, 2);
+	for(i = 0; i < 16 * 50; i++) {
+		if(FILTER_pipelinePush(&pipeline, ((i % 7) == 3) ? BASE + 4000 : BASE, &output)) {
+			outputs++;
+			if(output != BASE) {
+				errors++;
+			}
+		}
+	}
+	CHECK(outputs == 50);
+	CHECK(errors == 0);
+
+	/* All stages off: every sample passes unchanged */
+	FILTER_pipelineInit(&pipeline, false, 1, 0);
+	CHECK(FILTER_pipelinePush(&pipeline, BASE + 4000, &output) && (output == BASE + 4000));
+}
+
+int main(void)
+{
+	testMedian();
+	testDecimator();
+	testIir();
+	testPipeline();
+	return UNIT_RESULT("filter");
+}
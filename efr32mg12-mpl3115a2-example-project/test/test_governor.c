@@ -0,0 +1,102 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_governor.c
+ ******************************************************************************/
+
+#include "unit.h"
+#include "governor.h"
+
+#define BASE  (101325 * 4) // Q18.2 Pa
+#define DWELL (5)
+
+// The profiles of main.c, rates in Q18.2 Pa/s
+static const GOVERNOR_Profile_TypeDef profiles[] = {
+	{ 7, 3, 0,      0      }, // 8 s
+	{ 6, 1, 1 * 4,  1 * 2  }, // 2 s: from 1 Pa/s, back below 0.5 Pa/s
+	{ 4, 0, 5 * 4,  5 * 2  }, // 1 s: from 5 Pa/s, back below 2.5 Pa/s
+};
+
+static GOVERNOR_TypeDef governor;
+static uint32_t pressure = BASE;
+static uint32_t samples = 0;
+static uint32_t seconds = 0;
+
+// One sample moving by rate (Q18.2 Pa/s) over the period of the current profile
+static bool step(uint32_t rate)
+{
+	pressure += rate << GOVERNOR_getProfile(&governor)->timeStep;
+	samples++;
+	seconds += 1UL << GOVERNOR_getProfile(&governor)->timeStep;
+	return GOVERNOR_update(&governor, pressure);
+}
+
+// Calm samples until the profile changes, at most limit
+static uint32_t calmUntilChange(uint32_t limit)
+{
+	uint32_t count = 0;
+
+	while(count < limit) {
+		count++;
+		if(step(0)) {
+			break;
+		}
+	}
+	return count;
+}
+
+int main(void)
+{
+	uint32_t i = 0;
+	bool changed = false;
+
+	GOVERNOR_init(&governor, profiles, sizeof(profiles) / sizeof(profiles[0]), DWELL);
+	CHECK(GOVERNOR_getIntervalMs(&governor) == 8000);
+
+	/* Calm weather stays in the slowest profile */
+	for(i = 0; i < 100; i++) {
+		changed |= step(1);
+	}
+	CHECK(!changed);
+	CHECK(governor.current == 0);
+
+	/* A fast change goes straight to the fastest profile */
+	CHECK(step(6 * 4));
+	CHECK(governor.current == 2);
+	CHECK(GOVERNOR_getIntervalMs(&governor) == 1000);
+
+	/* Hysteresis: between the exit and the enter rate of the profile it stays */
+	changed = false;
+	for(i = 0; i < 100; i++) {
+		changed |= step(3 * 4);
+	}
+	CHECK(!changed);
+	CHECK(governor.current == 2);
+
+	/* Dwell: the first calm sample halves the smoothed rate below 2.5 Pa/s, it steps down after DWELL samples */
+	CHECK(calmUntilChange(100) == DWELL);
+	CHECK(governor.current == 1);
+
+	/* A movement during the dwell starts it again */
+	CHECK(calmUntilChange(DWELL - 1) == DWELL - 1);
+	CHECK(governor.current == 1);
+	CHECK(!step(2 * 4)); // 2 Pa/s: below the entry of profile 2, above the exit of profile 1
+	CHECK(calmUntilChange(100) == 1 + DWELL); // One sample to bring the smoothed rate below 0.5 Pa/s
+	CHECK(governor.current == 0);
+
+	/* One profile up at the entry rate of profile 1, it is not skipped on the way down */
+	CHECK(step(1 * 4));
+	CHECK(governor.current == 1);
+	CHECK(step(5 * 4));
+	CHECK(governor.current == 2);
+	CHECK(calmUntilChange(100) > DWELL);
+	CHECK(governor.current == 1);
+	CHECK(calmUntilChange(100) >= DWELL);
+	CHECK(governor.current == 0);
+
+	/* Time and samples per profile add up */
+	CHECK(governor.samplesInProfile[0] + governor.samplesInProfile[1] + governor.samplesInProfile[2] == samples);
+	CHECK(governor.timeInProfile[0] + governor.timeInProfile[1] + governor.timeInProfile[2] == seconds);
+	CHECK(governor.timeInProfile[2] == governor.samplesInProfile[2]);
+	GOVERNOR_printReport(&governor);
+	return UNIT_RESULT("governor");
+}
@@ -0,0 +1,197 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_retained.c
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "unit.h"
+#include "crc.h"
+#include "retained.h"
+
+#define BASE     (101325 * 4) // Q18.2 Pa
+#define START    (1700000000) // Unix time of the first sample
+#define INTERVAL (10)
+
+static volatile uint32_t words[32]; // RTCC->RET of the host
+static uint32_t timestamps[RETAINED_CAPACITY + 1];
+static uint32_t pressures[RETAINED_CAPACITY + 1];
+static int16_t temperatures[RETAINED_CAPACITY + 1];
+static uint8_t received = 0;
+
+static void sink(uint32_t timestamp, uint32_t pressure, int16_t temperature)
+{
+	timestamps[received] = timestamp;
+	pressures[received] = pressure;
+	temperatures[received] = temperature;
+	received++;
+}
+
+static uint8_t drain(void)
+{
+	received = 0;
+	return RETAINED_drain(sink);
+}
+
+// The stored CRC-32 of a header written behind the back of the ring
+static void setHeader(uint32_t header)
+{
+	uint32_t copy[RETAINED_WARM_BOOT_WORD];
+	uint8_t i;
+
+	words[0] = header;
+	for(i = 0; i < RETAINED_WARM_BOOT_WORD; i++) {
+		copy[i] = words[i];
+	}
+	copy[1] = 0;
+	words[1] = CRC_crc32(copy, sizeof(copy));
+}
+
+// Samples within a second of their slot take the slot time, further off they are refused
+static void testJitter(void)
+{
+	memset((void*)words, 0xA5, sizeof(words)); // Power-on content
+	CHECK(RETAINED_init(words) == 0);
+	CHECK(RETAINED_push(START, BASE, 23 * 16));
+	CHECK(RETAINED_push(START + INTERVAL, BASE + 4, -5 * 16)); // Sets the interval
+	CHECK(RETAINED_push(START + 2 * INTERVAL + 1, BASE + 8, 0));
+	CHECK(RETAINED_push(START + 3 * INTERVAL - 1, BASE + 12, 0));
+	CHECK(!RETAINED_push(START + 4 * INTERVAL + 2, BASE, 0));
+	CHECK(!RETAINED_push(START + 4 * INTERVAL - 2, BASE, 0));
+	CHECK(!RETAINED_push(START, BASE, 0));
+	CHECK(RETAINED_getCount() == 4);
+
+	CHECK(drain() == 4);
+	CHECK((timestamps[0] == START) && (timestamps[1] == START + INTERVAL) && (timestamps[2] == START + 2 * INTERVAL)
+		&& (timestamps[3] == START + 3 * INTERVAL));
+	CHECK((pressures[0] == BASE) && (pressures[1] == BASE + 4) && (pressures[3] == BASE + 12));
+	CHECK((temperatures[0] == 23 * 16) && (temperatures[1] == -5 * 16));
+	CHECK(RETAINED_getCount() == 0);
+	CHECK(RETAINED_getSequence() == 1);
+	CHECK(drain() == 0);
+	CHECK(RETAINED_getSequence() == 1);
+
+	/* After a drain the interval is taken again */
+	CHECK(RETAINED_push(START + 1000, BASE, 0));
+	CHECK(RETAINED_push(START + 1060, BASE, 0));
+	CHECK(RETAINED_push(START + 1120, BASE, 0));
+	CHECK(drain() == 3);
+	CHECK(timestamps[2] == START + 1120);
+}
+
+// A full ring refuses the sample until it is drained, the ring survives a reset
+static void testFull(void)
+{
+	uint8_t i = 0;
+
+	memset((void*)words, 0, sizeof(words));
+	CHECK(RETAINED_init(words) == 0);
+	for(i = 0; i < RETAINED_CAPACITY; i++) {
+		CHECK(RETAINED_push(START + i * INTERVAL, BASE + i, i));
+	}
+	CHECK(!RETAINED_push(START + RETAINED_CAPACITY * INTERVAL, BASE, 0));
+	CHECK(RETAINED_getCount() == RETAINED_CAPACITY);
+
+	/* Reset: the samples and the sequence are recovered, the warm boot word is not part of the ring */
+	words[RETAINED_WARM_BOOT_WORD] = 0x12345678;
+	CHECK(RETAINED_init(words) == RETAINED_CAPACITY);
+	CHECK(drain() == RETAINED_CAPACITY);
+	CHECK((timestamps[RETAINED_CAPACITY - 1] == START + (RETAINED_CAPACITY - 1) * INTERVAL)
+		&& (pressures[RETAINED_CAPACITY - 1] == BASE + RETAINED_CAPACITY - 1));
+	CHECK(RETAINED_init(words) == 0);
+	CHECK(RETAINED_getSequence() == 1);
+	CHECK(RETAINED_push(START, BASE, 0));
+}
+
+// A corrupted ring is dropped as a whole and starts again
+static void testCorrupt(void)
+{
+	memset((void*)words, 0, sizeof(words));
+	RETAINED_init(words);
+	RETAINED_push(START, BASE, 0);
+	RETAINED_push(START + INTERVAL, BASE, 0);
+	drain();
+	RETAINED_push(START, BASE, 0);
+	RETAINED_push(START + INTERVAL, BASE, 0);
+	CHECK(RETAINED_init(words) == 2);
+	CHECK(RETAINED_getSequence() == 1);
+
+	/* A flipped bit of a sample */
+	words[RETAINED_FIRST_WORD + 1] ^= 0x100;
+	CHECK(RETAINED_init(words) == 0);
+	CHECK(RETAINED_getSequence() == 0);
+	CHECK(RETAINED_init(words) == 0); // The empty ring is valid
+
+	/* Magic, count beyond the capacity, CRC */
+	RETAINED_push(START, BASE, 0);
+	setHeader(words[0] ^ 0x01000000);
+	CHECK(RETAINED_init(words) == 0);
+	RETAINED_push(START, BASE, 0);
+	setHeader((words[0] & 0xFFFFFF00) | (RETAINED_CAPACITY + 1));
+	CHECK(RETAINED_init(words) == 0);
+	RETAINED_push(START, BASE, 0);
+	setHeader((words[0] & 0xFFFFFF00) | RETAINED_CAPACITY);
+	CHECK(RETAINED_init(words) == RETAINED_CAPACITY); // Consistent header and CRC are trusted
+	words[1]++;
+	CHECK(RETAINED_init(words) == 0);
+}
+
+// A clock saved before the hibernation is taken once by the next boot, a corrupted ring has none
+static void testClock(void)
+{
+	uint32_t seconds = 0;
+	uint32_t counter = 0;
+
+	memset((void*)words, 0, sizeof(words));
+	CHECK(RETAINED_init(words) == 0);
+	CHECK(!RETAINED_takeClock(&seconds, &counter));
+	CHECK(RETAINED_getNewestTimestamp() == 0);
+	RETAINED_push(START, BASE, 0);
+	RETAINED_push(START + INTERVAL, BASE, 0);
+	RETAINED_push(START + 2 * INTERVAL, BASE, 0);
+	CHECK(RETAINED_getNewestTimestamp() == START + 2 * INTERVAL);
+	RETAINED_saveClock(START + 25, 0x87654321);
+
+	/* EM4 wakeup: the ring and the clock */
+	CHECK(RETAINED_init(words) == 3);
+	CHECK(RETAINED_takeClock(&seconds, &counter));
+	CHECK((seconds == START + 25) && (counter == 0x87654321));
+	CHECK(!RETAINED_takeClock(&seconds, &counter));
+	CHECK(RETAINED_init(words) == 3);
+	CHECK(!RETAINED_takeClock(&seconds, &counter));
+
+	/* The clock flag does not count as samples, it survives pushes and drains */
+	RETAINED_saveClock(START + 35, 1);
+	CHECK(RETAINED_push(START + 3 * INTERVAL, BASE, 0));
+	CHECK(drain() == 4);
+	CHECK(RETAINED_init(words) == 0);
+	CHECK(RETAINED_takeClock(&seconds, &counter) && (seconds == START + 35));
+
+	RETAINED_saveClock(START + 45, 1);
+	words[RETAINED_CLOCK_WORD] ^= 1;
+	CHECK(RETAINED_init(words) == 0);
+	CHECK(!RETAINED_takeClock(&seconds, &counter));
+}
+
+// The wakeups stay on the grid of the first one, a missed or unknown wakeup starts from now
+static void testWakeup(void)
+{
+	CHECK(RETAINED_nextWakeup(1000, 1005, 100) == 1100);
+	CHECK(RETAINED_nextWakeup(1000, 1099, 100) == 1100);
+	CHECK(RETAINED_nextWakeup(1000, 1100, 100) == 1200); // Missed
+	CHECK(RETAINED_nextWakeup(1000, 1500, 100) == 1600);
+	CHECK(RETAINED_nextWakeup(0, 5000, 100) == 5100);    // First call
+	CHECK(RETAINED_nextWakeup(5000, 1000, 100) == 1100); // Ahead of the counter
+	CHECK(RETAINED_nextWakeup(0xFFFFFFF0, 0xFFFFFFF5, 0x20) == 0x10);
+	CHECK(RETAINED_nextWakeup(0xFFFFFFF0, 0x08, 0x20) == 0x10);
+}
+
+int main(void)
+{
+	testJitter();
+	testFull();
+	testCorrupt();
+	testClock();
+	testWakeup();
+	return UNIT_RESULT("retained");
+}
@@ -0,0 +1,116 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_rolling_stats.c
+ ******************************************************************************/
+
+#include <stdlib.h>
+
+#include "unit.h"
+#include "rolling_stats.h"
+
+#define SAMPLES (20000)
+
+static int32_t samples[SAMPLES];
+
+// Summary of the last size samples up to index end (exclusive), the slow way
+static void reference(uint32_t end, uint16_t size, ROLLING_STATS_Summary_TypeDef* summary)
+{
+	uint32_t first = (end > size) ? end - size : 0;
+	uint32_t i = 0;
+	double sum = 0;
+	double squares = 0;
+	double mean = 0;
+
+	summary->count = (uint16_t)(end - first);
+	summary->min = samples[first];
+	summary->max = samples[first];
+	for(i = first; i < end; i++) {
+		sum += samples[i];
+		summary->min = (samples[i] < summary->min) ? samples[i] : summary->min;
+		summary->max = (samples[i] > summary->max) ? samples[i] : summary->max;
+	}
+	mean = sum / summary->count;
+	for(i = first; i < end; i++) {
+		squares += (samples[i] - mean) * (samples[i] - mean);
+	}
+	summary->mean = (int32_t)mean;
+	summary->variance = (uint32_t)(squares / summary->count);
+}
+
+// Every sample through a window of the given size, checked against the reference
+static void testWindow(uint16_t size)
+{
+	ROLLING_STATS_Slot_TypeDef* slots = malloc(size * sizeof(ROLLING_STATS_Slot_TypeDef));
+	ROLLING_STATS_TypeDef stats;
+	ROLLING_STATS_Summary_TypeDef summary;
+	ROLLING_STATS_Summary_TypeDef expected;
+	uint32_t errors = 0;
+	uint32_t i = 0;
+
+	ROLLING_STATS_init(&stats, slots, size);
+	CHECK(!ROLLING_STATS_getSummary(&stats, &summary));
+	for(i = 0; i < SAMPLES; i++) {
+		ROLLING_STATS_push(&stats, samples[i]);
+		reference(i + 1, size, &expected);
+		if(!ROLLING_STATS_getSummary(&stats, &summary) || (summary.count != expected.count) || (summary.min != expected.min)
+			|| (summary.max != expected.max) || (labs(summary.mean - expected.mean) > 1)
+			|| (labs((long)summary.variance - (long)expected.variance) > 1 + expected.variance / 1000000)) {
+			errors++;
+		}
+	}
+	CHECK(errors == 0);
+	free(slots);
+}
+
+// The extremes at the start of the run leave the window with their samples
+static void testSlidingExtremes(void)
+{
+	ROLLING_STATS_Slot_TypeDef slots[4];
+	ROLLING_STATS_TypeDef stats;
+	ROLLING_STATS_Summary_TypeDef summary;
+	const int32_t run[] = { 400000, 500000, 300000, 400004, 400000, 400004, 400000 };
+	uint8_t i = 0;
+
+	ROLLING_STATS_init(&stats, slots, 4);
+	for(i = 0; i < sizeof(run) / sizeof(run[0]); i++) {
+		ROLLING_STATS_push(&stats, run[i]);
+	}
+	CHECK(ROLLING_STATS_getSummary(&stats, &summary));
+	CHECK(summary.count == 4);
+	CHECK(summary.min == 400000);
+	CHECK(summary.max == 400004);
+	CHECK(summary.mean == 400002);
+	CHECK(summary.variance == 4);
+	CHECK(summary.stdDev == 2);
+
+	/* A window of one sample */
+	ROLLING_STATS_init(&stats, slots, 1);
+	ROLLING_STATS_push(&stats, 5);
+	ROLLING_STATS_push(&stats, -7);
+	CHECK(ROLLING_STATS_getSummary(&stats, &summary));
+	CHECK((summary.count == 1) && (summary.min == -7) && (summary.max == -7) && (summary.mean == -7) && (summary.variance == 0));
+}
+
+int main(void)
+{
+	uint32_t i = 0;
+	int32_t drift = 101325 * 4;
+
+	/* Q18.2 pressure: a random walk with spikes, and plateaus of equal samples */
+	srand(1);
+	for(i = 0; i < SAMPLES; i++) {
+		drift += rand() % 41 - 20;
+		samples[i] = drift;
+		if(rand() % 97 == 0) {
+			samples[i] += (rand() % 2) ? 4000 : -4000;
+		}
+		if((i / 500) % 7 == 3) {
+			samples[i] = 400000;
+		}
+	}
+	testSlidingExtremes();
+	testWindow(1);
+	testWindow(60);
+	testWindow(3600);
+	return UNIT_RESULT("rolling_stats");
+}
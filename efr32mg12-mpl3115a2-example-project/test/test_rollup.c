@@ -0,0 +1,91 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_rollup.c
+ ******************************************************************************/
+
+#include "unit.h"
+#include "rollup.h"
+
+#define DAY (86400)
+
+// A bucket closes when a sample leaves it: minute, hour and day at midnight
+static void testBoundaries(void)
+{
+	ROLLUP_Bucket_TypeDef buckets[4];
+
+	ROLLUP_init();
+	ROLLUP_push(DAY - 20, 100);
+	ROLLUP_push(DAY - 10, 300);
+	ROLLUP_push(DAY, 50);
+	CHECK(ROLLUP_query(ROLLUP_TIER_MINUTE, 0, DAY, buckets, 4) == 1);
+	CHECK((buckets[0].start == DAY - 60) && (buckets[0].count == 2) && (buckets[0].min == 100) && (buckets[0].max == 300)
+		&& (buckets[0].mean == 200));
+	CHECK(ROLLUP_query(ROLLUP_TIER_HOUR, 0, DAY, buckets, 4) == 1);
+	CHECK((buckets[0].start == DAY - 3600) && (buckets[0].count == 2));
+	CHECK(ROLLUP_query(ROLLUP_TIER_DAY, 0, DAY, buckets, 4) == 1);
+	CHECK((buckets[0].start == 0) && (buckets[0].count == 2));
+	CHECK(ROLLUP_query(ROLLUP_TIER_DAY, DAY, 2 * DAY, buckets, 4) == 1);
+	CHECK((buckets[0].start == DAY) && (buckets[0].count == 1)); // The open bucket of the new day
+
+	/* The last second of a minute stays in it */
+	ROLLUP_push(DAY + 59, -50);
+	CHECK(ROLLUP_query(ROLLUP_TIER_MINUTE, DAY, DAY + 3600, buckets, 4) == 1);
+	CHECK(buckets[0].count == 2);
+	ROLLUP_push(DAY + 60, 0);
+	CHECK(ROLLUP_query(ROLLUP_TIER_MINUTE, DAY, DAY + 3600, buckets, 4) == 2);
+	CHECK((buckets[0].start == DAY) && (buckets[0].count == 2) && (buckets[0].min == -50) && (buckets[0].max == 50) && (buckets[0].mean == 0));
+	CHECK(ROLLUP_query(ROLLUP_TIER_HOUR, DAY, DAY + 3600, buckets, 4) == 1);
+	CHECK(buckets[0].count == 3);
+
+	/* A gap closes the open buckets, the empty ones in between are not created */
+	ROLLUP_push(DAY + 3600 + 30, 7);
+	CHECK(ROLLUP_query(ROLLUP_TIER_MINUTE, DAY - 60, DAY + 7200, buckets, 4) == 4);
+	CHECK((buckets[0].start == DAY - 60) && (buckets[1].start == DAY) && (buckets[2].start == DAY + 60) && (buckets[3].start == DAY + 3600));
+	CHECK((buckets[3].count == 1) && (buckets[3].mean == 7)); // The open bucket
+	CHECK(ROLLUP_query(ROLLUP_TIER_HOUR, DAY, DAY + 7200, buckets, 4) == 2);
+	CHECK((buckets[0].count == 3) && (buckets[1].count == 1));
+}
+
+// Queries and tier selection over a full minute ring
+static void testQuery(void)
+{
+	ROLLUP_Bucket_TypeDef buckets[ROLLUP_MINUTE_COUNT];
+	uint32_t start = 2 * DAY;
+	uint32_t k = 0;
+
+	ROLLUP_init();
+	ROLLUP_push(DAY + 100, 1000); // The day before
+	for(k = 0; k < 240; k++) {
+		ROLLUP_push(start + k * 60, (int32_t)k);
+	}
+
+	/* 239 closed minutes in a ring of 180: the oldest ones are overwritten */
+	CHECK(ROLLUP_query(ROLLUP_TIER_MINUTE, 0, start + 240 * 60, buckets, ROLLUP_MINUTE_COUNT) == ROLLUP_MINUTE_COUNT);
+	CHECK(buckets[0].start == start + 59 * 60);
+	CHECK(buckets[ROLLUP_MINUTE_COUNT - 1].start == start + 238 * 60);
+	CHECK(ROLLUP_query(ROLLUP_TIER_MINUTE, start + 100 * 60 + 30, start + 103 * 60, buckets, 10) == 3);
+	CHECK((buckets[0].start == start + 100 * 60) && (buckets[0].mean == 100) && (buckets[2].mean == 102));
+	CHECK(ROLLUP_query(ROLLUP_TIER_MINUTE, start + 100 * 60, start + 200 * 60, buckets, 5) == 5);
+	CHECK(ROLLUP_query(ROLLUP_TIER_MINUTE, start + 300 * 60, start + 400 * 60, buckets, 5) == 0);
+
+	/* Hours: three closed and the open one */
+	CHECK(ROLLUP_query(ROLLUP_TIER_HOUR, start, start + 4 * 3600, buckets, 10) == 4);
+	CHECK((buckets[0].start == start) && (buckets[0].count == 60) && (buckets[0].min == 0) && (buckets[0].max == 59) && (buckets[0].mean == 29));
+	CHECK((buckets[3].start == start + 3 * 3600) && (buckets[3].mean == 209));
+
+	/* The coarsest tier within the resolution that reaches back to from */
+	CHECK(ROLLUP_selectTier(start + 100 * 60, 60) == ROLLUP_TIER_MINUTE);
+	CHECK(ROLLUP_selectTier(start + 100 * 60, 3600) == ROLLUP_TIER_HOUR);
+	CHECK(ROLLUP_selectTier(start + 100 * 60, 7 * DAY) == ROLLUP_TIER_DAY);
+	CHECK(ROLLUP_selectTier(start + 10 * 60, 3600) == ROLLUP_TIER_HOUR);
+	// The minutes do not reach back that far: the coarsest tier that does
+	CHECK(ROLLUP_selectTier(start + 10 * 60, 60) == ROLLUP_TIER_DAY);
+	CHECK(ROLLUP_selectTier(0, 60) == ROLLUP_TIER_DAY);
+}
+
+int main(void)
+{
+	testBoundaries();
+	testQuery();
+	return UNIT_RESULT("rollup");
+}
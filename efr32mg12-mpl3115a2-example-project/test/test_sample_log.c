@@ -0,0 +1,166 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_sample_log.c
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "unit.h"
+#include "flash_sim.h"
+#include "sample_log.h"
+
+#define SIM_SIZE (16 * FLASH_DEVICE_SECTOR_SIZE)
+
+static uint8_t memory[SIM_SIZE];
+static uint32_t received[SIM_SIZE / 8];
+static uint32_t receivedCount = 0;
+
+static bool collect(const SAMPLE_LOG_Record_TypeDef* record, void* context)
+{
+	(void)context;
+	if(receivedCount == sizeof(received) / sizeof(received[0])) {
+		return false;
+	}
+	CHECK(SAMPLE_LOG_PRESSURE(record->data) == record->timestamp + 400000);
+	received[receivedCount++] = record->timestamp;
+	return true;
+}
+
+static uint32_t readAll(void)
+{
+	SAMPLE_LOG_Cursor_TypeDef cursor;
+
+	receivedCount = 0;
+	SAMPLE_LOG_seek(&cursor, 0, 0xFFFFFFFF);
+	return SAMPLE_LOG_readRange(&cursor, collect, NULL);
+}
+
+static void append(uint32_t from, uint32_t to)
+{
+	uint32_t timestamp = 0;
+
+	for(timestamp = from; timestamp < to; timestamp++) {
+		SAMPLE_LOG_append(timestamp, timestamp + 400000, 23 * 16);
+		SAMPLE_LOG_process();
+	}
+}
+
+// Throughput, flash operations and wear spread of a log that wraps many times
+static void benchmark(void)
+{
+	const FLASH_DEVICE_TypeDef* device = FLASH_SIM_init(memory, SIM_SIZE);
+	const FLASH_SIM_Stats_TypeDef* stats = FLASH_SIM_getStats();
+	const uint32_t samples = 1000000;
+	uint32_t minErase = 0xFFFFFFFF;
+	uint32_t maxErase = 0;
+	uint64_t start = 0;
+	uint16_t sector = 0;
+
+	SAMPLE_LOG_init(device, 0, SIM_SIZE);
+	start = UNIT_NOW_NS();
+	append(0, samples);
+	start = UNIT_NOW_NS() - start;
+	for(sector = 0; sector < SIM_SIZE / FLASH_DEVICE_SECTOR_SIZE; sector++) {
+		minErase = (SAMPLE_LOG_getEraseCount(sector) < minErase) ? SAMPLE_LOG_getEraseCount(sector) : minErase;
+		maxErase = (SAMPLE_LOG_getEraseCount(sector) > maxErase) ? SAMPLE_LOG_getEraseCount(sector) : maxErase;
+	}
+	CHECK(stats->programErrors == 0);
+	CHECK(stats->pagePrograms == samples / SAMPLE_LOG_RECORDS_PER_PAGE);
+	CHECK(maxErase - minErase <= 1);
+	printf("%u samples: %.1f ns/sample, %u page programs, %u erases (%u..%u per sector), %u power ups, %.2f flash bytes/sample\n",
+	       samples, (double)start / samples, stats->pagePrograms, stats->sectorErases, minErase, maxErase, stats->powerUps,
+	       (double)stats->programmedBytes / samples);
+}
+
+// Remount continues the log, a range read returns every flushed sample once and in order.
+// The mount is lazy: appends to the RAM page do not touch the flash.
+static void testRemount(void)
+{
+	const FLASH_DEVICE_TypeDef* device = FLASH_SIM_init(memory, SIM_SIZE);
+	const FLASH_SIM_Stats_TypeDef* stats = FLASH_SIM_getStats();
+	uint32_t powerUps = 0;
+	uint32_t i = 0;
+
+	SAMPLE_LOG_init(device, 0, SIM_SIZE);
+	append(0, 100);
+	SAMPLE_LOG_flush();
+	powerUps = stats->powerUps;
+	SAMPLE_LOG_init(device, 0, SIM_SIZE);
+	append(100, 100 + SAMPLE_LOG_RECORDS_PER_PAGE - 1);
+	CHECK(stats->powerUps == powerUps);
+	append(100 + SAMPLE_LOG_RECORDS_PER_PAGE - 1, 200);
+	SAMPLE_LOG_flush();
+	CHECK(readAll() == 200);
+	for(i = 0; i < receivedCount; i++) {
+		CHECK(received[i] == i);
+	}
+}
+
+// A page torn by a power loss only loses its own samples: the pages after it,
+// and the pages written after the next mount, are still read
+static void testTornPage(void)
+{
+	const FLASH_DEVICE_TypeDef* device = FLASH_SIM_init(memory, SIM_SIZE);
+	SAMPLE_LOG_Page_TypeDef page;
+
+	SAMPLE_LOG_init(device, 0, SIM_SIZE);
+	append(0, 3 * SAMPLE_LOG_RECORDS_PER_PAGE);
+	SAMPLE_LOG_process();
+
+	/* Page 1 programmed only partially: some bits of the header and records still erased */
+	memset(&memory[FLASH_DEVICE_PAGE_SIZE + 2], 0xFF, 100);
+	CHECK(!SAMPLE_LOG_readPage(1, &page));
+	CHECK(readAll() == 2 * SAMPLE_LOG_RECORDS_PER_PAGE);
+	CHECK(received[SAMPLE_LOG_RECORDS_PER_PAGE] == 2 * SAMPLE_LOG_RECORDS_PER_PAGE);
+
+	/* The torn page is the last one before the power loss */
+	memset(&memory[2 * FLASH_DEVICE_PAGE_SIZE + 2], 0xFF, 100);
+	SAMPLE_LOG_init(device, 0, SIM_SIZE);
+	append(1000, 1000 + SAMPLE_LOG_RECORDS_PER_PAGE);
+	SAMPLE_LOG_flush();
+	CHECK(readAll() == 2 * SAMPLE_LOG_RECORDS_PER_PAGE);
+	CHECK(received[receivedCount - 1] == 1000 + SAMPLE_LOG_RECORDS_PER_PAGE - 1);
+}
+
+// The clock starts at 0 after a reboot and continues after the newest logged sample: a time
+// range across the reboot is read in one piece, torn pages do not count as the newest
+static void testReboot(void)
+{
+	const FLASH_DEVICE_TypeDef* device = FLASH_SIM_init(memory, SIM_SIZE);
+	SAMPLE_LOG_Cursor_TypeDef cursor;
+	uint32_t newest = 0;
+	uint32_t i = 0;
+
+	SAMPLE_LOG_init(device, 0, SIM_SIZE);
+	CHECK(SAMPLE_LOG_getNewestTimestamp() == 0);
+	append(0, 500);
+	CHECK(SAMPLE_LOG_getNewestTimestamp() == 499); // In the RAM page
+	SAMPLE_LOG_flush();
+
+	SAMPLE_LOG_init(device, 0, SIM_SIZE);
+	newest = SAMPLE_LOG_getNewestTimestamp();
+	CHECK(newest == 499);
+	append(newest + 1, 1000);
+	SAMPLE_LOG_flush();
+
+	receivedCount = 0;
+	CHECK(SAMPLE_LOG_seek(&cursor, 450, 550));
+	CHECK(SAMPLE_LOG_readRange(&cursor, collect, NULL) == 101);
+	for(i = 0; i < receivedCount; i++) {
+		CHECK(received[i] == 450 + i);
+	}
+
+	/* Page 33, the last one with the samples from 980, was torn by the power loss */
+	memset(&memory[33 * FLASH_DEVICE_PAGE_SIZE + 2], 0xFF, 100);
+	SAMPLE_LOG_init(device, 0, SIM_SIZE);
+	CHECK(SAMPLE_LOG_getNewestTimestamp() == 979);
+}
+
+int main(void)
+{
+	benchmark();
+	testRemount();
+	testTornPage();
+	testReboot();
+	return UNIT_RESULT("sample_log");
+}
@@ -0,0 +1,103 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_seal.c
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "unit.h"
+#include "seal.h"
+
+// RFC 3610 packet vectors #1 - #6 (M = 8, L = 2): the header is the
+// associated data, the rest of the packet is encrypted
+typedef struct {
+	uint8_t nonce[SEAL_NONCE_SIZE];
+	uint8_t headerLength;
+	uint8_t packetLength;
+	uint8_t result[41];
+} Vector_TypeDef;
+
+static const Vector_TypeDef vectors[] = {
+	{ { 0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5 }, 8, 31,
+	  { 0x58, 0x8C, 0x97, 0x9A, 0x61, 0xC6, 0x63, 0xD2, 0xF0, 0x66, 0xD0, 0xC2, 0xC0, 0xF9, 0x89, 0x80,
+	    0x6D, 0x5F, 0x6B, 0x61, 0xDA, 0xC3, 0x84, 0x17, 0xE8, 0xD1, 0x2C, 0xFD, 0xF9, 0x26, 0xE0 } },
+	{ { 0x00, 0x00, 0x00, 0x04, 0x03, 0x02, 0x01, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5 }, 8, 32,
+	  { 0x72, 0xC9, 0x1A, 0x36, 0xE1, 0x35, 0xF8, 0xCF, 0x29, 0x1C, 0xA8, 0x94, 0x08, 0x5C, 0x87, 0xE3,
+	    0xCC, 0x15, 0xC4, 0x39, 0xC9, 0xE4, 0x3A, 0x3B, 0xA0, 0x91, 0xD5, 0x6E, 0x10, 0x40, 0x09, 0x16 } },
+	{ { 0x00, 0x00, 0x00, 0x05, 0x04, 0x03, 0x02, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5 }, 8, 33,
+	  { 0x51, 0xB1, 0xE5, 0xF4, 0x4A, 0x19, 0x7D, 0x1D, 0xA4, 0x6B, 0x0F, 0x8E, 0x2D, 0x28, 0x2A, 0xE8,
+	    0x71, 0xE8, 0x38, 0xBB, 0x64, 0xDA, 0x85, 0x96, 0x57, 0x4A, 0xDA, 0xA7, 0x6F, 0xBD, 0x9F, 0xB0,
+	    0xC5 } },
+	{ { 0x00, 0x00, 0x00, 0x06, 0x05, 0x04, 0x03, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5 }, 12, 31,
+	  { 0xA2, 0x8C, 0x68, 0x65, 0x93, 0x9A, 0x9A, 0x79, 0xFA, 0xAA, 0x5C, 0x4C, 0x2A, 0x9D, 0x4A, 0x91,
+	    0xCD, 0xAC, 0x8C, 0x96, 0xC8, 0x61, 0xB9, 0xC9, 0xE6, 0x1E, 0xF1 } },
+	{ { 0x00, 0x00, 0x00, 0x07, 0x06, 0x05, 0x04, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5 }, 12, 32,
+	  { 0xDC, 0xF1, 0xFB, 0x7B, 0x5D, 0x9E, 0x23, 0xFB, 0x9D, 0x4E, 0x13, 0x12, 0x53, 0x65, 0x8A, 0xD8,
+	    0x6E, 0xBD, 0xCA, 0x3E, 0x51, 0xE8, 0x3F, 0x07, 0x7D, 0x9C, 0x2D, 0x93 } },
+	{ { 0x00, 0x00, 0x00, 0x08, 0x07, 0x06, 0x05, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5 }, 12, 33,
+	  { 0x6F, 0xC1, 0xB0, 0x11, 0xF0, 0x06, 0x56, 0x8B, 0x51, 0x71, 0xA4, 0x2D, 0x95, 0x3D, 0x46, 0x9B,
+	    0x25, 0x70, 0xA4, 0xBD, 0x87, 0x40, 0x5A, 0x04, 0x43, 0xAC, 0x91, 0xCB, 0x94 } },
+};
+
+static const uint8_t rfcKey[SEAL_KEY_SIZE] = {
+	0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF
+};
+
+static void testVectors(void)
+{
+	const Vector_TypeDef* vector = NULL;
+	uint8_t packet[48];
+	uint8_t tag[SEAL_TAG_SIZE];
+	uint8_t dataLength = 0;
+	uint8_t i = 0;
+	uint8_t v = 0;
+
+	SEAL_init(rfcKey);
+	CHECK(!SEAL_isHardware());
+	for(v = 0; v < sizeof(vectors) / sizeof(vectors[0]); v++) {
+		vector = &vectors[v];
+		dataLength = vector->packetLength - vector->headerLength;
+		for(i = 0; i < vector->packetLength; i++) {
+			packet[i] = i;
+		}
+		SEAL_encrypt(vector->nonce, packet, vector->headerLength, &packet[vector->headerLength], dataLength, tag);
+		CHECK(memcmp(&packet[vector->headerLength], vector->result, dataLength) == 0);
+		CHECK(memcmp(tag, &vector->result[dataLength], SEAL_TAG_SIZE) == 0);
+
+		CHECK(SEAL_decrypt(vector->nonce, packet, vector->headerLength, &packet[vector->headerLength], dataLength, tag));
+		CHECK(packet[vector->packetLength - 1] == vector->packetLength - 1);
+
+		/* A changed header or tag is rejected and the data is wiped */
+		SEAL_encrypt(vector->nonce, packet, vector->headerLength, &packet[vector->headerLength], dataLength, tag);
+		packet[0] ^= 1;
+		CHECK(!SEAL_decrypt(vector->nonce, packet, vector->headerLength, &packet[vector->headerLength], dataLength, tag));
+		CHECK(packet[vector->headerLength] == 0);
+	}
+}
+
+// Cycles per byte of the software AES-CCM (the CRYPTO peripheral is measured on the target)
+static void benchmark(void)
+{
+	static uint8_t batch[240];
+	uint8_t nonce[SEAL_NONCE_SIZE];
+	uint8_t tag[SEAL_TAG_SIZE];
+	uint64_t start = 0;
+	uint32_t i = 0;
+
+	SEAL_init(rfcKey);
+	start = UNIT_NOW_NS();
+	for(i = 0; i < 10000; i++) {
+		SEAL_makeNonce(nonce, 0x0123456789ABCDEFULL, i);
+		SEAL_encrypt(nonce, batch, 2, &batch[2], sizeof(batch) - 2, tag);
+	}
+	start = UNIT_NOW_NS() - start;
+	printf("software AES-128-CCM: %.1f ns/byte on %u byte batches\n", (double)start / 10000 / (sizeof(batch) - 2),
+	       (unsigned)(sizeof(batch) - 2));
+}
+
+int main(void)
+{
+	testVectors();
+	benchmark();
+	return UNIT_RESULT("seal");
+}
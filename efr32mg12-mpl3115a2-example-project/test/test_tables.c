@@ -0,0 +1,202 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_tables.c
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "unit.h"
+#include "thunderboard/rfs/rfs.h"
+#include "crc.h"
+#include "tables.h"
+
+#define BASE (101325 * 4) // Q18.2 Pa
+
+typedef struct {
+	TABLES_Header_TypeDef header;
+	TABLES_CalibrationPoint_TypeDef points[3];
+} CalibrationFile_TypeDef;
+
+typedef struct {
+	TABLES_Header_TypeDef header;
+	GOVERNOR_Profile_TypeDef profiles[GOVERNOR_MAX_PROFILES + 1];
+} GovernorFile_TypeDef;
+
+/* RFS image in RAM: the files tables.c opens, a NULL data pointer is a missing file */
+static struct {
+	const char* name;
+	const uint8_t* data;
+	int32_t length;
+} files[] = {
+	{ "calibration.tbl", NULL, 0 },
+	{ "governor.tbl",    NULL, 0 },
+};
+
+static CalibrationFile_TypeDef calibrationFile;
+static GovernorFile_TypeDef governorFile;
+static uint32_t misaligned[sizeof(CalibrationFile_TypeDef) / 4 + 1];
+
+int32_t RFS_fileOpen(RFS_FileHandle* fileHandle, uint8_t name[])
+{
+	uint16_t i = 0;
+
+	for(i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+		if((files[i].data != NULL) && (strcmp(files[i].name, (const char*)name) == 0)) {
+			fileHandle->fileIndex = i;
+			fileHandle->currentIndex = 0;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+uint8_t* RFS_fileGetRawData(RFS_FileHandle* fileHandle)
+{
+	return (uint8_t*)files[fileHandle->fileIndex].data;
+}
+
+int32_t RFS_getFileLength(RFS_FileHandle* fileHandle)
+{
+	return files[fileHandle->fileIndex].length;
+}
+
+// Valid calibration curve: +10 Pa at the low end, -10 Pa in the middle, none at the high end
+static void makeCalibration(void)
+{
+	const TABLES_CalibrationPoint_TypeDef points[3] = {
+		{ BASE - 4000, 40 }, { BASE, -40 }, { BASE + 4000, 0 },
+	};
+
+	memcpy(calibrationFile.points, points, sizeof(points));
+	calibrationFile.header.magic = TABLES_MAGIC;
+	calibrationFile.header.type = TABLES_TYPE_CALIBRATION;
+	calibrationFile.header.count = 3;
+	calibrationFile.header.parameter = 0;
+	calibrationFile.header.crc = CRC_crc32(calibrationFile.points, sizeof(calibrationFile.points));
+	files[0].data = (const uint8_t*)&calibrationFile;
+	files[0].length = sizeof(calibrationFile);
+}
+
+// Calibration in use: an offset at the middle point
+static bool calibrated(void)
+{
+	return TABLES_correctPressure(BASE) == BASE - 40;
+}
+
+static void testCorrection(void)
+{
+	uint8_t count = 0;
+
+	/* No files: the built-in defaults */
+	files[0].data = NULL;
+	files[1].data = NULL;
+	TABLES_init(true);
+	CHECK(TABLES_correctPressure(BASE) == BASE);
+	CHECK(TABLES_getGovernorProfiles(&count) == NULL);
+	CHECK(count == 0);
+
+	/* Points, interpolation between them, and the end offsets outside the curve */
+	makeCalibration();
+	TABLES_init(true);
+	CHECK(TABLES_correctPressure(BASE - 4000) == BASE - 4000 + 40);
+	CHECK(TABLES_correctPressure(BASE) == BASE - 40);
+	CHECK(TABLES_correctPressure(BASE + 4000) == BASE + 4000);
+	CHECK(TABLES_correctPressure(BASE - 2000) == BASE - 2000);
+	CHECK(TABLES_correctPressure(BASE - 1000) == BASE - 1000 - 20);
+	CHECK(TABLES_correctPressure(BASE + 2000) == BASE + 2000 - 20);
+	CHECK(TABLES_correctPressure(BASE + 3999) == BASE + 3999 - 1); // -40 + 39.99 truncated
+	CHECK(TABLES_correctPressure(0) == 40);
+	CHECK(TABLES_correctPressure(BASE - 40000) == BASE - 40000 + 40);
+	CHECK(TABLES_correctPressure(BASE + 40000) == BASE + 40000);
+	CHECK(TABLES_correctPressure(0xFFFFFFFF) == 0xFFFFFFFF);
+}
+
+// A file is used only with its magic, type, length and CRC-32
+static void testRejection(void)
+{
+	makeCalibration();
+	calibrationFile.header.magic ^= 1;
+	TABLES_init(true);
+	CHECK(!calibrated());
+
+	makeCalibration();
+	calibrationFile.header.type = TABLES_TYPE_GOVERNOR;
+	TABLES_init(true);
+	CHECK(!calibrated());
+
+	makeCalibration();
+	files[0].length -= sizeof(TABLES_CalibrationPoint_TypeDef);
+	TABLES_init(true);
+	CHECK(!calibrated());
+	files[0].length = sizeof(TABLES_Header_TypeDef) - 1;
+	TABLES_init(true);
+	CHECK(!calibrated());
+
+	makeCalibration();
+	calibrationFile.header.count = 4;
+	TABLES_init(true);
+	CHECK(!calibrated());
+
+	/* The CRC-32 is only checked with verify, after a warm boot it is skipped */
+	makeCalibration();
+	calibrationFile.points[2].offset = 1;
+	TABLES_init(true);
+	CHECK(!calibrated());
+	TABLES_init(false);
+	CHECK(calibrated());
+
+	/* The entries are used in place, they must be aligned */
+	makeCalibration();
+	memcpy((uint8_t*)misaligned + 1, &calibrationFile, sizeof(calibrationFile));
+	files[0].data = (const uint8_t*)misaligned + 1;
+	TABLES_init(true);
+	CHECK(!calibrated());
+
+	/* A rejected file leaves no curve of an earlier one */
+	makeCalibration();
+	TABLES_init(true);
+	CHECK(calibrated());
+	files[0].data = NULL;
+	TABLES_init(true);
+	CHECK(!calibrated());
+}
+
+// Governor profiles in place, at most GOVERNOR_MAX_PROFILES of them
+static void testGovernor(void)
+{
+	const GOVERNOR_Profile_TypeDef* profiles = NULL;
+	uint8_t count = 0;
+	uint8_t i = 0;
+
+	for(i = 0; i < GOVERNOR_MAX_PROFILES + 1; i++) {
+		governorFile.profiles[i].oversampleShift = 7 - i;
+		governorFile.profiles[i].timeStep = 3 - i;
+		governorFile.profiles[i].enterRate = i * 4;
+		governorFile.profiles[i].exitRate = i * 2;
+	}
+	governorFile.header.magic = TABLES_MAGIC;
+	governorFile.header.type = TABLES_TYPE_GOVERNOR;
+	governorFile.header.count = GOVERNOR_MAX_PROFILES + 1;
+	governorFile.header.parameter = 0;
+	governorFile.header.crc = CRC_crc32(governorFile.profiles, sizeof(governorFile.profiles));
+	files[1].data = (const uint8_t*)&governorFile;
+	files[1].length = sizeof(governorFile);
+
+	TABLES_init(true);
+	profiles = TABLES_getGovernorProfiles(&count);
+	CHECK(profiles == governorFile.profiles);
+	CHECK(count == GOVERNOR_MAX_PROFILES);
+
+	governorFile.header.type = TABLES_TYPE_CALIBRATION;
+	TABLES_init(true);
+	CHECK(TABLES_getGovernorProfiles(&count) == NULL);
+	CHECK(count == 0);
+}
+
+int main(void)
+{
+	testCorrection();
+	testRejection();
+	testGovernor();
+	return UNIT_RESULT("tables");
+}
@@ -0,0 +1,152 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_tendency.c
+ ******************************************************************************/
+
+#include "unit.h"
+#include "rollup.h"
+#include "tendency.h"
+
+#define BASE (101325 * 4) // Q18.2 Pa
+#define HOUR (3600)
+
+static uint32_t alerts = 0;
+static TENDENCY_Result_TypeDef lastAlert;
+
+static void onAlert(const TENDENCY_Result_TypeDef* result)
+{
+	alerts++;
+	lastAlert = *result;
+}
+
+// The wiring of main.c: the closed hours of the rollup feed the tendency
+static void onRollupClose(uint8_t tier, const ROLLUP_Bucket_TypeDef* bucket)
+{
+	if(tier == ROLLUP_TIER_HOUR) {
+		TENDENCY_onHour(bucket->start, bucket->mean);
+	}
+}
+
+// Three hours of change from a fresh start: first half to the mean of the middle hours, then the second half
+static TENDENCY_Result_TypeDef run(int32_t first, int32_t second)
+{
+	TENDENCY_Result_TypeDef result;
+
+	TENDENCY_init(NULL);
+	TENDENCY_onHour(0 * HOUR, BASE);
+	TENDENCY_onHour(1 * HOUR, BASE + first);
+	TENDENCY_onHour(2 * HOUR, BASE + first);
+	CHECK(!TENDENCY_get(&result));
+	TENDENCY_onHour(3 * HOUR, BASE + first + second);
+	CHECK(TENDENCY_get(&result));
+	return result;
+}
+
+// WMO 0200, 0.1 hPa is 40 in Q18.2
+static void testCharacteristic(void)
+{
+	CHECK(run(200, -100).characteristic == TENDENCY_INCREASING_THEN_DECREASING);
+	CHECK(run(100, -100).characteristic == TENDENCY_INCREASING_THEN_DECREASING); // Back to the same
+	CHECK(run(200, 0).characteristic == TENDENCY_INCREASING_THEN_STEADY);
+	CHECK(run(200, 40).characteristic == TENDENCY_INCREASING_THEN_STEADY);       // Increasing more slowly
+	CHECK(run(100, 100).characteristic == TENDENCY_INCREASING);
+	CHECK(run(0, 200).characteristic == TENDENCY_DECREASING_THEN_INCREASING_UP); // Steady then increasing
+	CHECK(run(-100, 200).characteristic == TENDENCY_DECREASING_THEN_INCREASING_UP);
+	CHECK(run(40, 200).characteristic == TENDENCY_DECREASING_THEN_INCREASING_UP); // Increasing more rapidly
+	CHECK(run(0, 0).characteristic == TENDENCY_STEADY);
+	CHECK(run(15, -15).characteristic == TENDENCY_STEADY);
+	CHECK(run(-100, 100).characteristic == TENDENCY_DECREASING_THEN_INCREASING); // Back to the same
+	CHECK(run(-200, 100).characteristic == TENDENCY_DECREASING_THEN_INCREASING);
+	CHECK(run(-200, 0).characteristic == TENDENCY_DECREASING_THEN_STEADY);
+	CHECK(run(-200, -40).characteristic == TENDENCY_DECREASING_THEN_STEADY);      // Decreasing more slowly
+	CHECK(run(-100, -100).characteristic == TENDENCY_DECREASING);
+	CHECK(run(0, -200).characteristic == TENDENCY_INCREASING_THEN_DECREASING_DOWN); // Steady then decreasing
+	CHECK(run(100, -200).characteristic == TENDENCY_INCREASING_THEN_DECREASING_DOWN);
+	CHECK(run(-40, -200).characteristic == TENDENCY_INCREASING_THEN_DECREASING_DOWN); // Decreasing more rapidly
+}
+
+// The rate classes at their limits, the storm warning from falling quickly
+static void testRate(void)
+{
+	TENDENCY_Result_TypeDef result;
+
+	CHECK(run(0, 39).rate == TENDENCY_RATE_STEADY);
+	CHECK(run(0, 40).rate == TENDENCY_RATE_SLOWLY);
+	CHECK(run(0, 600).rate == TENDENCY_RATE_SLOWLY);
+	CHECK(run(0, 601).rate == TENDENCY_RATE_NORMAL);
+	CHECK(run(0, 1400).rate == TENDENCY_RATE_NORMAL);
+	CHECK(run(0, 1401).rate == TENDENCY_RATE_QUICKLY);
+	CHECK(run(0, 2400).rate == TENDENCY_RATE_QUICKLY);
+	CHECK(run(0, 2401).rate == TENDENCY_RATE_VERY_RAPIDLY);
+	CHECK(run(0, -39).rate == TENDENCY_RATE_STEADY);
+	CHECK(run(0, -601).rate == -TENDENCY_RATE_NORMAL);
+
+	result = run(700, 700);
+	CHECK((result.change == 1400) && !result.stormWarning);
+	result = run(-700, -700);
+	CHECK((result.change == -1400) && (result.rate == -TENDENCY_RATE_NORMAL) && !result.stormWarning);
+	result = run(-700, -701);
+	CHECK((result.rate == -TENDENCY_RATE_QUICKLY) && result.stormWarning);
+	result = run(-1000, -2000);
+	CHECK((result.rate == -TENDENCY_RATE_VERY_RAPIDLY) && result.stormWarning);
+}
+
+// The alert runs on the first result and when the rate changes, a missing hour restarts the window
+static void testAlert(void)
+{
+	TENDENCY_Result_TypeDef result;
+	uint32_t hour = 10;
+
+	TENDENCY_init(onAlert);
+	alerts = 0;
+	for(hour = 10; hour < 14; hour++) {
+		TENDENCY_onHour(hour * HOUR, BASE);
+	}
+	CHECK((alerts == 1) && (lastAlert.rate == TENDENCY_RATE_STEADY));
+	TENDENCY_onHour(14 * HOUR, BASE + 10);
+	CHECK(alerts == 1);
+	TENDENCY_onHour(15 * HOUR, BASE + 100);
+	CHECK((alerts == 2) && (lastAlert.rate == TENDENCY_RATE_SLOWLY));
+	TENDENCY_onHour(16 * HOUR, BASE + 160); // Other shape, same rate
+	CHECK(alerts == 2);
+
+	/* Hour 17 is missing */
+	TENDENCY_onHour(18 * HOUR, BASE + 200);
+	CHECK(!TENDENCY_get(&result));
+	TENDENCY_onHour(19 * HOUR, BASE + 200);
+	TENDENCY_onHour(20 * HOUR, BASE + 200);
+	CHECK(!TENDENCY_get(&result));
+	TENDENCY_onHour(21 * HOUR, BASE + 200);
+	CHECK(TENDENCY_get(&result) && (result.change == 0));
+	CHECK((alerts == 3) && (lastAlert.rate == TENDENCY_RATE_STEADY));
+}
+
+// Minute samples through the rollup: each closed hour is one update, the open hour is not used
+static void testRollup(void)
+{
+	TENDENCY_Result_TypeDef result;
+	uint32_t second = 0;
+
+	ROLLUP_init();
+	ROLLUP_setCloseCallback(onRollupClose);
+	TENDENCY_init(onAlert);
+	alerts = 0;
+	for(second = 0; second < 4 * HOUR; second += 60) {
+		ROLLUP_push(second, BASE - (int32_t)(second / HOUR) * 500); // 1.25 hPa per hour
+	}
+	CHECK(!TENDENCY_get(&result));
+	ROLLUP_push(4 * HOUR, BASE);
+	CHECK(TENDENCY_get(&result));
+	CHECK((result.change == -1500) && (result.characteristic == TENDENCY_DECREASING) && result.stormWarning);
+	CHECK(alerts == 1);
+	ROLLUP_setCloseCallback(NULL);
+}
+
+int main(void)
+{
+	testCharacteristic();
+	testRate();
+	testAlert();
+	testRollup();
+	return UNIT_RESULT("tendency");
+}
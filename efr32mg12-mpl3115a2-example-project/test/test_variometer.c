@@ -0,0 +1,103 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_variometer.c
+ ******************************************************************************/
+
+#include <stdlib.h>
+
+#include "unit.h"
+#include "variometer.h"
+
+#define ALPHA (VARIO_GAIN(0.5))  // Same gains as main.c
+#define BETA  (VARIO_GAIN(0.1667))
+#define METER (65536)
+
+// Uniform noise of +-amplitude (Q16.16)
+static int32_t noise(int32_t amplitude)
+{
+	return (int32_t)(((int64_t)(rand() % 2001 - 1000) * amplitude) / 1000);
+}
+
+// A constant climb is tracked without bias once settled
+static void testConstantClimb(void)
+{
+	VARIO_Filter_TypeDef filter;
+	int32_t altitude = 0;
+	int32_t velocity = 0;
+	uint16_t i = 0;
+
+	VARIO_init(&filter, ALPHA, BETA, 1000);
+	for(i = 0; i < 60; i++) {
+		VARIO_update(&filter, 100 * METER + i * 2 * METER, &altitude, &velocity);
+	}
+	CHECK(abs(velocity - 2 * METER) < METER / 100);
+	CHECK(abs(altitude - (100 * METER + 59 * 2 * METER)) < METER / 10);
+
+	/* Changing the cadence keeps the state, the speed stays in m/s */
+	VARIO_setInterval(&filter, 250);
+	for(i = 0; i < 60; i++) {
+		VARIO_update(&filter, 218 * METER + i * METER / 2, &altitude, &velocity);
+	}
+	CHECK(abs(velocity - 2 * METER) < METER / 100);
+}
+
+// Cycles per update and lag at each OSR: time from the start of a 1 m/s climb until
+// the estimate reaches 90 % of it, and the speed noise from +-0.5 m altitude noise
+// scaled down by sqrt(OSR)
+static void benchmark(void)
+{
+	static const uint16_t conversionMs[8] = { 6, 10, 18, 34, 66, 130, 258, 512 };
+	static const uint8_t noiseScale[8] = { 8, 6, 4, 3, 2, 1, 1, 1 }; // ~ 8 / sqrt(OSR), in 1/16 m
+	static int32_t samples[1024];
+	VARIO_Filter_TypeDef filter;
+	int32_t altitude = 0;
+	int32_t velocity = 0;
+	int32_t truth = 0;
+	int64_t noiseSum = 0;
+	uint64_t start = 0;
+	uint32_t settle = 0;
+	uint32_t i = 0;
+	uint8_t os = 0;
+
+	srand(1);
+	for(i = 0; i < 1024; i++) {
+		samples[i] = noise(METER / 2);
+	}
+	printf("OSR  interval  ns/update  lag to 90%%  speed noise\n");
+	for(os = 0; os < 8; os++) {
+		VARIO_init(&filter, ALPHA, BETA, conversionMs[os]);
+		start = UNIT_NOW_NS();
+		for(i = 0; i < 100000; i++) {
+			VARIO_update(&filter, samples[i & 1023], &altitude, &velocity);
+		}
+		start = UNIT_NOW_NS() - start;
+
+		VARIO_init(&filter, ALPHA, BETA, conversionMs[os]);
+		truth = 0;
+		settle = 0;
+		for(i = 0; i < 200; i++) {
+			VARIO_update(&filter, truth, &altitude, &velocity);
+			truth += (int32_t)(((int64_t)METER * conversionMs[os]) / 1000);
+			if((settle == 0) && (velocity >= METER * 9 / 10)) {
+				settle = i * conversionMs[os];
+			}
+		}
+		CHECK(settle > 0);
+
+		noiseSum = 0;
+		for(i = 0; i < 1000; i++) {
+			VARIO_update(&filter, truth + noise(METER * noiseScale[os] / 16), &altitude, &velocity);
+			truth += (int32_t)(((int64_t)METER * conversionMs[os]) / 1000);
+			noiseSum += abs(velocity - METER);
+		}
+		printf("%3u  %5u ms  %9.1f  %7u ms  %8.3f m/s\n", 1u << os, conversionMs[os],
+		       (double)start / 100000, settle, (double)noiseSum / 1000 / METER);
+	}
+}
+
+int main(void)
+{
+	testConstantClimb();
+	benchmark();
+	return UNIT_RESULT("variometer");
+}
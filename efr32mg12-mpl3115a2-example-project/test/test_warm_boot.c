@@ -0,0 +1,65 @@
+/***************************************************************************//**
+ * @file
+ * @brief test_warm_boot.c
+ ******************************************************************************/
+
+#include "unit.h"
+#include "retained.h"
+#include "warm_boot.h"
+
+#define CONFIG_ID (0x21)
+#define CTRL_REG1 (0xB9) // Altimeter, OSR 128, active
+
+static volatile uint32_t words[32]; // RTCC->RET of the host
+
+// Bit flips anywhere in the word and other firmware configurations are rejected
+static void testWord(void)
+{
+	uint32_t state = WARM_BOOT_pack(CTRL_REG1, CONFIG_ID);
+	uint8_t ctrlReg1 = 0;
+	uint32_t errors = 0;
+	uint8_t bit = 0;
+	uint16_t id = 0;
+
+	CHECK((state >> 24) == WARM_BOOT_MAGIC);
+	CHECK(WARM_BOOT_unpack(state, CONFIG_ID, &ctrlReg1));
+	CHECK(ctrlReg1 == CTRL_REG1);
+	CHECK(WARM_BOOT_unpack(WARM_BOOT_pack(0, 0), 0, &ctrlReg1) && (ctrlReg1 == 0));
+
+	for(bit = 0; bit < 32; bit++) {
+		if(WARM_BOOT_unpack(state ^ (1UL << bit), CONFIG_ID, &ctrlReg1)) {
+			errors++;
+		}
+	}
+	CHECK(errors == 0);
+	for(id = 0; id < 256; id++) {
+		if((id != CONFIG_ID) && WARM_BOOT_unpack(state, (uint8_t)id, &ctrlReg1)) {
+			errors++;
+		}
+	}
+	CHECK(errors == 0);
+	CHECK(!WARM_BOOT_unpack(0, CONFIG_ID, &ctrlReg1)); // Invalidated
+	CHECK(!WARM_BOOT_unpack(0xFFFFFFFF, CONFIG_ID, &ctrlReg1));
+}
+
+// RET[31] and the sample ring do not disturb each other
+static void testRetained(void)
+{
+	uint8_t ctrlReg1 = 0;
+
+	CHECK(RETAINED_init(words) == 0);
+	words[RETAINED_WARM_BOOT_WORD] = WARM_BOOT_pack(CTRL_REG1, CONFIG_ID);
+	CHECK(RETAINED_push(1000, 101325 * 4, 0));
+	CHECK(RETAINED_push(1010, 101325 * 4, 0));
+	CHECK(RETAINED_init(words) == 2);
+	CHECK(WARM_BOOT_unpack(words[RETAINED_WARM_BOOT_WORD], CONFIG_ID, &ctrlReg1) && (ctrlReg1 == CTRL_REG1));
+	words[RETAINED_WARM_BOOT_WORD] = 0;
+	CHECK(RETAINED_init(words) == 2);
+}
+
+int main(void)
+{
+	testWord();
+	testRetained();
+	return UNIT_RESULT("warm_boot");
+}
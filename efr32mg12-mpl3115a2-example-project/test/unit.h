@@ -0,0 +1,40 @@
+/***************************************************************************//**
+ * @file
+ * @brief unit.h
+ ******************************************************************************/
+
+#ifndef UNIT_H
+#define UNIT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Minimal host test helpers. A failed CHECK prints its location and is
+ * counted, UNIT_RESULT gives the exit code of the test program.
+ * UNIT_NOW_NS is a monotonic clock for the benchmarks.
+ */
+
+static int unitFailures = 0;
+
+#define CHECK(condition) \
+	do { \
+		if(!(condition)) { \
+			printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			unitFailures++; \
+		} \
+	} while(0)
+
+#define UNIT_RESULT(name) \
+	(printf("%s: %s\n", (name), (unitFailures == 0) ? "OK" : "FAILED"), (unitFailures == 0) ? 0 : 1)
+
+static inline uint64_t UNIT_NOW_NS(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+#endif // UNIT_H
@@ -0,0 +1,54 @@
+/***************************************************************************//**
+ * @file
+ * @brief timestamp.c
+ ******************************************************************************/
+
+#include "em_rtcc.h"
+
+#include "timestamp.h"
+
+static uint32_t seconds = 0;     // Seconds at lastCounter
+static uint32_t lastCounter = 0; // RTCC counter at the last call, minus the fraction of a second
+static uint64_t ticks = 0;       // RTCC ticks since start-up at msCounter
+static uint32_t msCounter = 0;   // RTCC counter at the last TIMESTAMP_getMilliseconds call
+
+// Current time in seconds
+uint32_t TIMESTAMP_get(void)
+{
+	uint32_t counter = RTCC_CounterGet();
+	uint32_t elapsed = counter - lastCounter; // Wraps correctly
+
+	seconds += elapsed / TIMESTAMP_TICKS_PER_SECOND;
+	lastCounter += elapsed - (elapsed % TIMESTAMP_TICKS_PER_SECOND);
+	return seconds;
+}
+
+// Milliseconds since start-up, wraps in 49 days
+uint32_t TIMESTAMP_getMilliseconds(void)
+{
+	uint32_t counter = RTCC_CounterGet();
+
+	ticks += counter - msCounter; // Wraps correctly
+	msCounter = counter;
+	return (uint32_t)((ticks * 1000) / TIMESTAMP_TICKS_PER_SECOND);
+}
+
+void TIMESTAMP_set(uint32_t newSeconds)
+{
+	lastCounter = RTCC_CounterGet();
+	seconds = newSeconds;
+}
+
+// Seconds and the RTCC counter value they belong to
+void TIMESTAMP_getState(uint32_t* currentSeconds, uint32_t* counter)
+{
+	*currentSeconds = TIMESTAMP_get();
+	*counter = lastCounter;
+}
+
+// Continue a clock of TIMESTAMP_getState, the RTCC has to have kept counting since then
+void TIMESTAMP_setState(uint32_t newSeconds, uint32_t counter)
+{
+	seconds = newSeconds;
+	lastCounter = counter;
+}
@@ -0,0 +1,31 @@
+/***************************************************************************//**
+ * @file
+ * @brief timestamp.h
+ ******************************************************************************/
+
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <stdint.h>
+
+/*
+ * Seconds counter on top of the RTCC (32768 Hz, set up in initMcu), it keeps
+ * counting in EM2. The 32 bit RTCC counter wraps in 36 hours, so
+ * TIMESTAMP_get has to be called at least once in that time.
+ * The time is 0 at start-up, TIMESTAMP_set sets e.g. the UNIX time.
+ * TIMESTAMP_getState/TIMESTAMP_setState keep it across EM4 Hibernate, where
+ * the RTCC keeps counting but the RAM is lost (retained.h).
+ * TIMESTAMP_getMilliseconds is a separate time base for sub-second sample
+ * streams: milliseconds since start-up, not changed by TIMESTAMP_set, with
+ * the same 36 hour rule.
+ */
+
+#define TIMESTAMP_TICKS_PER_SECOND (32768) // RTCC frequency
+
+uint32_t TIMESTAMP_get(void);
+uint32_t TIMESTAMP_getMilliseconds(void);
+void TIMESTAMP_set(uint32_t seconds);
+void TIMESTAMP_getState(uint32_t* seconds, uint32_t* counter);
+void TIMESTAMP_setState(uint32_t seconds, uint32_t counter);
+
+#endif // TIMESTAMP_H
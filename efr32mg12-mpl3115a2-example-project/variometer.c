@@ -0,0 +1,51 @@
+/***************************************************************************//**
+ * @file
+ * @brief variometer.c
+ ******************************************************************************/
+
+#include "variometer.h"
+
+void VARIO_init(VARIO_Filter_TypeDef* filter, int32_t alpha, int32_t beta, uint32_t intervalMs)
+{
+	filter->alpha = alpha;
+	filter->beta = beta;
+	filter->altitude = 0;
+	filter->velocity = 0;
+	filter->initialized = false;
+	VARIO_setInterval(filter, intervalMs);
+}
+
+// Change the sampling interval (e.g. after an OSR or cadence change), the state is kept
+void VARIO_setInterval(VARIO_Filter_TypeDef* filter, uint32_t intervalMs)
+{
+	if(intervalMs == 0) {
+		intervalMs = 1;
+	}
+	filter->interval = (int32_t)(((uint64_t)intervalMs << 16) / 1000);
+	filter->inverseInterval = (int32_t)((1000UL << 16) / intervalMs);
+}
+
+// Feed an altitude sample in Q16.16 meter, gives the filtered altitude (Q16.16 meter)
+// and vertical speed (Q16.16 m/s). Constant time and memory.
+void VARIO_update(VARIO_Filter_TypeDef* filter, int32_t altitude, int32_t* resultAltitude, int32_t* resultVelocity)
+{
+	int32_t residual = 0;
+
+	if(!filter->initialized) {
+		filter->altitude = altitude;
+		filter->velocity = 0;
+		filter->initialized = true;
+	}
+	else {
+		/* Predict: x += v * dt */
+		filter->altitude += (int32_t)(((int64_t)filter->velocity * filter->interval) >> 16);
+
+		/* Correct with the measurement residual: x += alpha * r, v += beta * r / dt */
+		residual = altitude - filter->altitude;
+		filter->altitude += (int32_t)(((int64_t)filter->alpha * residual) >> 16);
+		filter->velocity += (int32_t)(((((int64_t)filter->beta * residual) >> 16) * filter->inverseInterval) >> 16);
+	}
+
+	*resultAltitude = filter->altitude;
+	*resultVelocity = filter->velocity;
+}
@@ -0,0 +1,37 @@
+/***************************************************************************//**
+ * @file
+ * @brief variometer.h
+ ******************************************************************************/
+
+#ifndef VARIOMETER_H
+#define VARIOMETER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Vertical speed estimation with a two state (altitude, vertical speed)
+ * fixed-point alpha-beta filter. One update is a few multiplications,
+ * there is no division and no history.
+ *
+ * Gains are in Q16 (65536 = 1.0). alpha^2 / (2 - alpha) for beta gives
+ * a critically damped response: lower alpha is smoother and lags more.
+ */
+
+#define VARIO_GAIN(x) ((int32_t)((x) * 65536.0 + 0.5)) // Gain constant in Q16
+
+typedef struct {
+	int32_t alpha;           // Altitude correction gain in Q16
+	int32_t beta;            // Vertical speed correction gain in Q16
+	int32_t interval;        // Time between two samples in Q16 s
+	int32_t inverseInterval; // 1 / interval in Q16 1/s
+	int32_t altitude;        // Estimated altitude in Q16.16 meter
+	int32_t velocity;        // Estimated vertical speed in Q16.16 m/s
+	bool initialized;        // The first sample was received
+} VARIO_Filter_TypeDef;
+
+void VARIO_init(VARIO_Filter_TypeDef* filter, int32_t alpha, int32_t beta, uint32_t intervalMs);
+void VARIO_setInterval(VARIO_Filter_TypeDef* filter, uint32_t intervalMs);
+void VARIO_update(VARIO_Filter_TypeDef* filter, int32_t altitude, int32_t* resultAltitude, int32_t* resultVelocity);
+
+#endif // VARIOMETER_H
@@ -0,0 +1,83 @@
+/***************************************************************************//**
+ * @file
+ * @brief warm_boot.c
+ ******************************************************************************/
+
+#if !defined(WARM_BOOT_SOFTWARE_ONLY)
+#include "em_device.h"
+#include "em_rmu.h"
+
+#include "MPL3115A2.h"
+#endif
+
+#include "crc.h"
+#include "retained.h"
+#include "warm_boot.h"
+
+static uint16_t WARM_BOOT_hash(uint8_t ctrlReg1, uint8_t configId)
+{
+	uint8_t profile[2];
+
+	profile[0] = ctrlReg1;
+	profile[1] = configId;
+	return CRC_crc16(profile, sizeof(profile));
+}
+
+// RET[31] word of a verified configuration
+uint32_t WARM_BOOT_pack(uint8_t ctrlReg1, uint8_t configId)
+{
+	return ((uint32_t)WARM_BOOT_MAGIC << 24) | ((uint32_t)ctrlReg1 << 16) | WARM_BOOT_hash(ctrlReg1, configId);
+}
+
+// Check a RET[31] word against the firmware configuration, ctrlReg1: the saved CTRL_REG1
+bool WARM_BOOT_unpack(uint32_t state, uint8_t configId, uint8_t* ctrlReg1)
+{
+	*ctrlReg1 = (uint8_t)(state >> 16);
+	return ((state >> 24) == WARM_BOOT_MAGIC) && ((uint16_t)state == WARM_BOOT_hash(*ctrlReg1, configId));
+}
+
+#if !defined(WARM_BOOT_SOFTWARE_ONLY)
+static uint8_t expectedCtrlReg1 = 0; // CTRL_REG1 of the saved configuration
+
+// Check the reset cause and the retained state without touching the sensor (before initI2C),
+// configId changes with the sensor settings of the firmware. Call it once after CRC_init().
+bool WARM_BOOT_begin(uint8_t configId)
+{
+	uint32_t resetCause = RMU_ResetCauseGet();
+	uint32_t state = RTCC->RET[RETAINED_WARM_BOOT_WORD].REG;
+
+	RMU_ResetCauseClear();
+	if(!(resetCause & RMU_RSTCAUSE_EM4RST) || !WARM_BOOT_unpack(state, configId, &expectedCtrlReg1)) {
+		WARM_BOOT_invalidate();
+		return false;
+	}
+	return true;
+}
+
+// One register read: the sensor still has the saved configuration (it was not power cycled)
+bool WARM_BOOT_confirm(void)
+{
+	uint8_t ctrlReg1 = 0;
+
+	MPL3115A2_readRegister(MPL3115A2_CTRL_REG1, &ctrlReg1, 1);
+	if(ctrlReg1 != expectedCtrlReg1) {
+		WARM_BOOT_invalidate();
+		return false;
+	}
+	return true;
+}
+
+// Save the configuration of the verified sensor, call it right before entering EM4
+void WARM_BOOT_save(uint8_t configId)
+{
+	uint8_t ctrlReg1 = 0;
+
+	MPL3115A2_readRegister(MPL3115A2_CTRL_REG1, &ctrlReg1, 1);
+	RTCC->RET[RETAINED_WARM_BOOT_WORD].REG = WARM_BOOT_pack(ctrlReg1, configId);
+}
+
+void WARM_BOOT_invalidate(void)
+{
+	RTCC->RET[RETAINED_WARM_BOOT_WORD].REG = 0;
+}
+#endif
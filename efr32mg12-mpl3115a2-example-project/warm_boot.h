@@ -0,0 +1,34 @@
+/***************************************************************************//**
+ * @file
+ * @brief warm_boot.h
+ ******************************************************************************/
+
+#ifndef WARM_BOOT_H
+#define WARM_BOOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Warm boot after an EM4 wakeup: the MPL3115A2 keeps its registers while the
+ * MCU is in EM4, so its identification and configuration can be skipped.
+ * After a verified configuration the retention register RET[31] holds the
+ * CTRL_REG1 value and a CRC-16 of CTRL_REG1 and the firmware configuration
+ * id. On an EM4 reset with a valid word a single
+ * CTRL_REG1 read confirms the sensor is still configured.
+ *
+ * RET[31]: magic (8 bits), CTRL_REG1 (8 bits), CRC-16 (16 bits)
+ * WARM_BOOT_pack and WARM_BOOT_unpack build and check this word without
+ * touching the registers, the host build (WARM_BOOT_SOFTWARE_ONLY) has only them.
+ */
+
+#define WARM_BOOT_MAGIC (0x5A)
+
+uint32_t WARM_BOOT_pack(uint8_t ctrlReg1, uint8_t configId);
+bool WARM_BOOT_unpack(uint32_t state, uint8_t configId, uint8_t* ctrlReg1);
+bool WARM_BOOT_begin(uint8_t configId);
+bool WARM_BOOT_confirm(void);
+void WARM_BOOT_save(uint8_t configId);
+void WARM_BOOT_invalidate(void);
+
+#endif // WARM_BOOT_H